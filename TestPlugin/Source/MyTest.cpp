@@ -12,6 +12,7 @@
 static void leaf_pool_report(void);
 static void leaf_pool_dump(void);
 static void run_pool_test(void);
+static void run_thread_cache_test(void);
 
 tMBSaw bsaw;
 tMBTriangle btri;
@@ -234,3 +235,34 @@ static void run_pool_test(void)
 
     leaf_pool_dump();
 }
+
+static void run_thread_cache_test(void)
+{
+    DBG("THREAD CACHE");
+    tMempool cache;
+    tMempool_initThreadCache(&cache, &leaf.mempool);
+    
+    // Make sure a large block fits in the shared pool to begin with
+    size_t size = (leaf_pool_get_size(&leaf) - leaf_pool_get_used(&leaf)) / 2;
+    char* large = mpool_alloc(size, leaf.mempool);
+    jassert(large != NULL);
+    mpool_free(large, leaf.mempool);
+    
+    // Blocks too large for the cache's magazines, like delay lines, have to go back
+    // to the shared pool once the cache collects them instead of being held on to
+    char* buffers[4];
+    for (int i = 0; i < 4; i++) buffers[i] = mpool_alloc(size / 4, cache);
+    for (int i = 0; i < 4; i++) mpool_free(buffers[i], cache);
+    char* small = mpool_alloc(16, cache);
+    
+    leaf_pool_report();
+    
+    large = mpool_alloc(size, leaf.mempool);
+    jassert(large != NULL);
+    mpool_free(large, leaf.mempool);
+    
+    mpool_free(small, cache);
+    tMempool_free(&cache);
+    
+    leaf_pool_report();
+}
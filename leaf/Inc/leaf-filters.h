@@ -630,6 +630,22 @@ extern "C" {
      @fn void    tSVF_setFreqAndQ    (tSVF* const svff, float freq, float Q)
      @brief
      @param filter A pointer to the relevant tSVF.
+     
+     @fn void    tSVF_processBlock   (tSVF* const, const float* const in, float* const out, int size)
+     @brief Filter a block of samples. Unlike tSVF_tick(), which checks for NaN on every sample, the check is done once per block: if the filter has blown up, the block is silenced and the filter is reset.
+     @param filter A pointer to the relevant tSVF.
+     @param in The buffer of input samples.
+     @param out The buffer to write the output samples to. May be the same as the input.
+     @param size The number of samples to process.
+     
+     @fn void    tSVF_processBlockModulated (tSVF* const, const float* const in, const float* const freq, const float* const Q, float* const out, int size)
+     @brief Filter a block of samples with a cutoff frequency and Q for every sample. The coefficients use a fast approximation of tan and are computed for many samples at once, which is much cheaper than calling tSVF_setFreq() every sample. The filter is left set to the last frequency and Q. NaN is checked for once per block, as in tSVF_processBlock().
+     @param filter A pointer to the relevant tSVF.
+     @param in The buffer of input samples.
+     @param freq The buffer of cutoff frequencies in Hz.
+     @param Q The buffer of Q values, or NULL to keep the current Q.
+     @param out The buffer to write the output samples to. May be the same as the input.
+     @param size The number of samples to process.
      ￼￼￼
      @} */
     
@@ -666,6 +682,9 @@ extern "C" {
     void    tSVF_setQ           (tSVF* const, float Q);
     void    tSVF_setFreqAndQ    (tSVF* const svff, float freq, float Q);
     void    tSVF_setSampleRate  (tSVF* const svff, float sr);
+    void    tSVF_processBlock   (tSVF* const, const float* const in, float* const out, int size);
+    void    tSVF_processBlockModulated(tSVF* const, const float* const in, const float* const freq, const float* const Q,
+                                       float* const out, int size);
     
     //==============================================================================
     
@@ -700,6 +719,22 @@ extern "C" {
      @fn void    tEfficientSVF_setQ          (tEfficientSVF* const, float Q)
      @brief
      @param filter A pointer to the relevant tEfficientSVF.
+     
+     @fn void    tEfficientSVF_processBlock  (tEfficientSVF* const, const float* const in, float* const out, int size)
+     @brief Filter a block of samples. If the filter has blown up to NaN, which is checked once per block, the block is silenced and the filter is reset.
+     @param filter A pointer to the relevant tEfficientSVF.
+     @param in The buffer of input samples.
+     @param out The buffer to write the output samples to. May be the same as the input.
+     @param size The number of samples to process.
+     
+     @fn void    tEfficientSVF_processBlockModulated (tEfficientSVF* const, const float* const in, const uint16_t* const controlFreq, const float* const Q, float* const out, int size)
+     @brief Filter a block of samples with a control frequency and Q for every sample. The filter is left set to the last frequency and Q. NaN is checked for once per block, as in tEfficientSVF_processBlock().
+     @param filter A pointer to the relevant tEfficientSVF.
+     @param in The buffer of input samples.
+     @param controlFreq The buffer of control frequencies, [0, 4096).
+     @param Q The buffer of Q values, or NULL to keep the current Q.
+     @param out The buffer to write the output samples to. May be the same as the input.
+     @param size The number of samples to process.
      ￼￼￼
      @} */
     
@@ -723,6 +758,9 @@ extern "C" {
     void    tEfficientSVF_setFreq       (tEfficientSVF* const, uint16_t controlFreq);
     void    tEfficientSVF_setQ          (tEfficientSVF* const, float Q);
     void    tEfficientSVF_setFreqAndQ   (tEfficientSVF* const, uint16_t controlFreq, float Q);
+    void    tEfficientSVF_processBlock  (tEfficientSVF* const, const float* const in, float* const out, int size);
+    void    tEfficientSVF_processBlockModulated(tEfficientSVF* const, const float* const in, const uint16_t* const controlFreq,
+                                                const float* const Q, float* const out, int size);
     
     //==============================================================================
     
@@ -853,6 +891,198 @@ extern "C" {
     
     //==============================================================================
     
+    /*!
+     @defgroup tbiquadcascade tBiquadCascade
+     @ingroup filters
+     @brief Cascade of biquad sections in transposed direct form II, such as a high order filter or an EQ, stored so that the sections can run side by side.
+     @details tBiquadCascade_processBlock() runs the sections as a pipeline, with each section one sample behind the one before it, so that all of them can be computed at once instead of one after another. The pipeline is filled and drained within each block, so there is no added latency. Cascades of fewer than BIQUAD_LANES sections gain too little from this and are run one sample at a time. Coefficients can be set directly, taken from a tBiQuad, or converted from a tSVF or a tButterworth.
+     @{
+     
+     @fn void    tBiquadCascade_init         (tBiquadCascade* const cascade, int numSections, LEAF* const leaf)
+     @brief Initialize a tBiquadCascade to the default mempool of a LEAF instance. Sections pass their input through until they are set.
+     @param cascade A pointer to the tBiquadCascade to initialize.
+     @param numSections The number of second order sections.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tBiquadCascade_initToPool   (tBiquadCascade* const cascade, int numSections, tMempool* const mempool)
+     @brief Initialize a tBiquadCascade to a specified mempool. Sections pass their input through until they are set.
+     @param cascade A pointer to the tBiquadCascade to initialize.
+     @param numSections The number of second order sections.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tBiquadCascade_free         (tBiquadCascade* const cascade)
+     @brief Free a tBiquadCascade from its mempool.
+     @param cascade A pointer to the tBiquadCascade to free.
+     
+     @fn float   tBiquadCascade_tick         (tBiquadCascade* const cascade, float input)
+     @brief Filter one sample through every section.
+     @param cascade A pointer to the relevant tBiquadCascade.
+     @param input The input sample.
+     @return The filtered sample.
+     
+     @fn void    tBiquadCascade_processBlock (tBiquadCascade* const cascade, const float* const in, float* const out, int size)
+     @brief Filter a block of samples. The output is identical to calling tBiquadCascade_tick() once per sample. The input and output buffers may be the same.
+     @param cascade A pointer to the relevant tBiquadCascade.
+     @param in The buffer of input samples.
+     @param out The buffer to write the output samples to.
+     @param size The number of samples to process.
+     
+     @fn void    tBiquadCascade_setCoefficients (tBiquadCascade* const cascade, int section, float b0, float b1, float b2, float a1, float a2)
+     @brief Set the coefficients of one section, normalized so that a0 is 1, as in tBiQuad_setCoefficients().
+     @param cascade A pointer to the relevant tBiquadCascade.
+     @param section The index of the section.
+     
+     @fn void    tBiquadCascade_setFromBiQuad (tBiquadCascade* const cascade, int section, tBiQuad* const filter)
+     @brief Copy the coefficients and gain of a tBiQuad into one section.
+     @param cascade A pointer to the relevant tBiquadCascade.
+     @param section The index of the section.
+     @param filter A pointer to the tBiQuad to copy.
+     
+     @fn void    tBiquadCascade_setFromSVF   (tBiquadCascade* const cascade, int section, tSVF* const filter)
+     @brief Set one section to the response of a tSVF at its current frequency and Q.
+     @param cascade A pointer to the relevant tBiquadCascade.
+     @param section The index of the section.
+     @param filter A pointer to the tSVF to copy.
+     
+     @fn void    tBiquadCascade_setFromButterworth (tBiquadCascade* const cascade, tButterworth* const filter)
+     @brief Set the sections to the response of a tButterworth, one section for each of its second order stages. Sections beyond those pass their input through.
+     @param cascade A pointer to the relevant tBiquadCascade.
+     @param filter A pointer to the tButterworth to copy.
+     
+     @} */
+    
+#define BIQUAD_LANES 8
+    // Coefficients and state of BIQUAD_LANES sections, which are computed side by side
+    typedef struct _tBiquadLanes
+    {
+        float b0[BIQUAD_LANES];
+        float b1[BIQUAD_LANES];
+        float b2[BIQUAD_LANES];
+        float a1[BIQUAD_LANES];
+        float a2[BIQUAD_LANES];
+        float s1[BIQUAD_LANES];
+        float s2[BIQUAD_LANES];
+    } _tBiquadLanes;
+    
+    typedef struct _tBiquadCascade
+    {
+        tMempool mempool;
+        int numSections;
+        // Sections in order, BIQUAD_LANES to a group
+        _tBiquadLanes* sections;
+        int numGroups;
+        // Inputs to the sections while a block runs through them
+        float* pipe[2];
+    } _tBiquadCascade;
+    
+    typedef _tBiquadCascade* tBiquadCascade;
+    
+    void    tBiquadCascade_init         (tBiquadCascade* const cascade, int numSections, LEAF* const leaf);
+    void    tBiquadCascade_initToPool   (tBiquadCascade* const cascade, int numSections, tMempool* const mempool);
+    void    tBiquadCascade_free         (tBiquadCascade* const cascade);
+    
+    float   tBiquadCascade_tick         (tBiquadCascade* const cascade, float input);
+    void    tBiquadCascade_processBlock (tBiquadCascade* const cascade, const float* const in, float* const out, int size);
+    void    tBiquadCascade_setCoefficients(tBiquadCascade* const cascade, int section, float b0, float b1, float b2, float a1, float a2);
+    void    tBiquadCascade_setFromBiQuad(tBiquadCascade* const cascade, int section, tBiQuad* const filter);
+    void    tBiquadCascade_setFromSVF   (tBiquadCascade* const cascade, int section, tSVF* const filter);
+    void    tBiquadCascade_setFromButterworth(tBiquadCascade* const cascade, tButterworth* const filter);
+    
+    //==============================================================================
+    
+    /*!
+     @defgroup tbiquadbank tBiquadBank
+     @ingroup filters
+     @brief Bank of biquad cascades, one per voice or channel, stored so that all of the voices can be filtered together.
+     @details Each voice has the same number of sections in transposed direct form II, and each section is computed for every voice at once.
+     @{
+     
+     @fn void    tBiquadBank_init         (tBiquadBank* const bank, int numVoices, int numSections, LEAF* const leaf)
+     @brief Initialize a tBiquadBank to the default mempool of a LEAF instance. Sections pass their input through until they are set.
+     @param bank A pointer to the tBiquadBank to initialize.
+     @param numVoices The number of voices in the bank.
+     @param numSections The number of second order sections of each voice.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tBiquadBank_initToPool   (tBiquadBank* const bank, int numVoices, int numSections, tMempool* const mempool)
+     @brief Initialize a tBiquadBank to a specified mempool. Sections pass their input through until they are set.
+     @param bank A pointer to the tBiquadBank to initialize.
+     @param numVoices The number of voices in the bank.
+     @param numSections The number of second order sections of each voice.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tBiquadBank_free         (tBiquadBank* const bank)
+     @brief Free a tBiquadBank from its mempool.
+     @param bank A pointer to the tBiquadBank to free.
+     
+     @fn void    tBiquadBank_tick         (tBiquadBank* const bank, const float* const in, float* const out)
+     @brief Filter one sample of every voice.
+     @param bank A pointer to the relevant tBiquadBank.
+     @param in An array of numVoices input samples.
+     @param out An array to write the numVoices output samples to. May be the same as the input.
+     
+     @fn void    tBiquadBank_processBlock (tBiquadBank* const bank, float** const in, float** const out, int size)
+     @brief Filter a block of samples of every voice. The output is identical to calling tBiquadBank_tick() once per sample.
+     @param bank A pointer to the relevant tBiquadBank.
+     @param in An array of numVoices buffers of input samples.
+     @param out An array of numVoices buffers to write the output samples to. These may be the same as the input buffers.
+     @param size The number of samples to process.
+     
+     @fn void    tBiquadBank_setCoefficients (tBiquadBank* const bank, int voice, int section, float b0, float b1, float b2, float a1, float a2)
+     @brief Set the coefficients of one section of one voice, normalized so that a0 is 1, as in tBiQuad_setCoefficients().
+     @param bank A pointer to the relevant tBiquadBank.
+     @param voice The index of the voice.
+     @param section The index of the section.
+     
+     @fn void    tBiquadBank_setFromBiQuad (tBiquadBank* const bank, int voice, int section, tBiQuad* const filter)
+     @brief Copy the coefficients and gain of a tBiQuad into one section of one voice.
+     @param bank A pointer to the relevant tBiquadBank.
+     @param voice The index of the voice.
+     @param section The index of the section.
+     @param filter A pointer to the tBiQuad to copy.
+     
+     @fn void    tBiquadBank_setFromSVF   (tBiquadBank* const bank, int voice, int section, tSVF* const filter)
+     @brief Set one section of one voice to the response of a tSVF at its current frequency and Q.
+     @param bank A pointer to the relevant tBiquadBank.
+     @param voice The index of the voice.
+     @param section The index of the section.
+     @param filter A pointer to the tSVF to copy.
+     
+     @fn void    tBiquadBank_setFromButterworth (tBiquadBank* const bank, int voice, tButterworth* const filter)
+     @brief Set the sections of one voice to the response of a tButterworth, one section for each of its second order stages. Sections beyond those pass their input through.
+     @param bank A pointer to the relevant tBiquadBank.
+     @param voice The index of the voice.
+     @param filter A pointer to the tButterworth to copy.
+     
+     @} */
+    
+    typedef struct _tBiquadBank
+    {
+        tMempool mempool;
+        int numVoices;
+        int numSections;
+        // Voices, BIQUAD_LANES to a group, with numGroups groups for each section in turn
+        _tBiquadLanes* sections;
+        int numGroups;
+        // One sample of every voice
+        float* x;
+    } _tBiquadBank;
+    
+    typedef _tBiquadBank* tBiquadBank;
+    
+    void    tBiquadBank_init         (tBiquadBank* const bank, int numVoices, int numSections, LEAF* const leaf);
+    void    tBiquadBank_initToPool   (tBiquadBank* const bank, int numVoices, int numSections, tMempool* const mempool);
+    void    tBiquadBank_free         (tBiquadBank* const bank);
+    
+    void    tBiquadBank_tick         (tBiquadBank* const bank, const float* const in, float* const out);
+    void    tBiquadBank_processBlock (tBiquadBank* const bank, float** const in, float** const out, int size);
+    void    tBiquadBank_setCoefficients(tBiquadBank* const bank, int voice, int section, float b0, float b1, float b2, float a1, float a2);
+    void    tBiquadBank_setFromBiQuad(tBiquadBank* const bank, int voice, int section, tBiQuad* const filter);
+    void    tBiquadBank_setFromSVF   (tBiquadBank* const bank, int voice, int section, tSVF* const filter);
+    void    tBiquadBank_setFromButterworth(tBiquadBank* const bank, int voice, tButterworth* const filter);
+    
+    //==============================================================================
+    
     /*!
      @defgroup tfir tFIR
      @ingroup filters
@@ -876,6 +1106,18 @@ extern "C" {
      @fn float   tFIR_tick           (tFIR* const, float input)
      @brief
      @param filter A pointer to the relevant tFIR.
+     
+     @fn void    tFIR_processBlock   (tFIR* const, const float* const in, float* const out, int size)
+     @brief Filter a block of samples. The output is identical to calling tFIR_tick() once per sample. The input and output buffers may be the same.
+     @param filter A pointer to the relevant tFIR.
+     @param in The buffer of input samples.
+     @param out The buffer to write the output samples to.
+     @param size The number of samples to process.
+     
+     @fn void    tFIR_setSymmetric   (tFIR* const, int symmetric)
+     @brief Set whether the coefficients are symmetric about their middle, as in a linear phase filter. The filter then adds together the samples that share a coefficient before multiplying, which halves the multiplies, and only reads the first (numTaps + 1) / 2 coefficients. The first time this is turned on it allocates a second copy of the history from the filter's mempool.
+     @param filter A pointer to the relevant tFIR.
+     @param symmetric 1 if the coefficients are symmetric, 0 otherwise.
      ￼￼￼
      @} */
     
@@ -883,9 +1125,14 @@ extern "C" {
     {
         
         tMempool mempool;
+        // Two copies of the input history, numTaps samples apart
         float* past;
+        // The same, back to front, kept only for symmetric coefficients
+        float* pastReversed;
         float* coeff;
         int numTaps;
+        int pos;
+        int symmetric;
     } _tFIR;
     
     typedef _tFIR* tFIR;
@@ -895,6 +1142,95 @@ extern "C" {
     void    tFIR_free           (tFIR* const);
     
     float   tFIR_tick           (tFIR* const, float input);
+    void    tFIR_processBlock   (tFIR* const, const float* const in, float* const out, int size);
+    void    tFIR_setSymmetric   (tFIR* const, int symmetric);
+    
+    //==============================================================================
+    
+    /*!
+     @defgroup tconvolver tConvolver
+     @ingroup filters
+     @brief Convolution with long impulse responses, such as cabinet and reverb impulse responses, by partitioned overlap-save FFT convolution.
+     @details The first headSize samples of the impulse response are run in the time domain with a tFIR, so there is no latency. The rest is split into partitions that are convolved in the frequency domain, headSize samples long at first and doubling every two partitions up to maxBlockSize, after which all partitions are maxBlockSize long. Setting maxBlockSize to headSize gives uniform partitions. Larger partitions cost less on average but do all of their work on the sample that completes a block, so the cost of processing is uneven when they are used.
+     @{
+     
+     @fn void    tConvolver_init         (tConvolver* const, const float* ir, int length, int headSize, int maxBlockSize, LEAF* const leaf)
+     @brief Initialize a tConvolver to the default mempool of a LEAF instance.
+     @param conv A pointer to the tConvolver to initialize.
+     @param ir The impulse response, which is copied.
+     @param length The length of the impulse response in samples.
+     @param headSize The length of the part of the impulse response run in the time domain, and of the smallest partition. Rounded up to a power of two, and at least 8.
+     @param maxBlockSize The length of the largest partition. Rounded up to a power of two, and at least headSize.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tConvolver_initToPool   (tConvolver* const, const float* ir, int length, int headSize, int maxBlockSize, tMempool* const)
+     @brief Initialize a tConvolver to a specified mempool.
+     @param conv A pointer to the tConvolver to initialize.
+     @param ir The impulse response, which is copied.
+     @param length The length of the impulse response in samples.
+     @param headSize The length of the part of the impulse response run in the time domain, and of the smallest partition. Rounded up to a power of two, and at least 8.
+     @param maxBlockSize The length of the largest partition. Rounded up to a power of two, and at least headSize.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tConvolver_free         (tConvolver* const)
+     @brief Free a tConvolver from its mempool.
+     @param conv A pointer to the tConvolver to free.
+     
+     @fn float   tConvolver_tick         (tConvolver* const, float input)
+     @brief Convolve one sample.
+     @param conv A pointer to the relevant tConvolver.
+     @param input The input sample.
+     @return The output sample.
+     
+     @fn void    tConvolver_processBlock (tConvolver* const, const float* const in, float* const out, int size)
+     @brief Convolve a block of samples. The output is identical to calling tConvolver_tick() once per sample. The input and output buffers may be the same.
+     @param conv A pointer to the relevant tConvolver.
+     @param in The buffer of input samples.
+     @param out The buffer to write the output samples to.
+     @param size The number of samples to process.
+     
+     @} */
+    
+    // One set of equal partitions of the impulse response
+    typedef struct _tConvolverStage
+    {
+        int blockSize;
+        int numPartitions;
+        // Position in the impulse response of the first partition
+        int offset;
+        // The last 2 * blockSize input samples
+        float* input;
+        // Spectra of the last numPartitions input blocks, newest at current
+        float* spectra;
+        int current;
+        // Spectra of the partitions
+        float* filters;
+    } _tConvolverStage;
+    
+    typedef struct _tConvolver
+    {
+        tMempool mempool;
+        int length;
+        int headSize;
+        tFIR head;
+        float* headCoeffs;
+        _tConvolverStage* stages;
+        int numStages;
+        // Output of the stages, added up ahead of the samples it belongs to
+        float* output;
+        uint32_t outputMask;
+        uint32_t time;
+        float* sum;
+    } _tConvolver;
+    
+    typedef _tConvolver* tConvolver;
+    
+    void    tConvolver_init         (tConvolver* const, const float* ir, int length, int headSize, int maxBlockSize, LEAF* const leaf);
+    void    tConvolver_initToPool   (tConvolver* const, const float* ir, int length, int headSize, int maxBlockSize, tMempool* const);
+    void    tConvolver_free         (tConvolver* const);
+    
+    float   tConvolver_tick         (tConvolver* const, float input);
+    void    tConvolver_processBlock (tConvolver* const, const float* const in, float* const out, int size);
     
     
     //==============================================================================
@@ -975,6 +1311,22 @@ extern "C" {
      @brief
      @param filter A pointer to the relevant tVZFilter.
      
+     @fn void    tVZFilter_processBlock      (tVZFilter* const, const float* const in, float* const out, int size)
+     @brief Filter a block of samples with tVZFilter_tick(). If the filter has blown up to NaN, which is checked once per block, the block is silenced and the filter is reset.
+     @param filter A pointer to the relevant tVZFilter.
+     @param in The buffer of input samples.
+     @param out The buffer to write the output samples to. May be the same as the input.
+     @param size The number of samples to process.
+     
+     @fn void    tVZFilter_processBlockModulated (tVZFilter* const, const float* const in, const float* const freq, const float* const resonance, float* const out, int size)
+     @brief Filter a block of samples with tVZFilter_tick() and a frequency and resonance for every sample. The coefficients use a fast approximation of tan, and the filter is left set to the last frequency and resonance. NaN is checked for once per block, as in tVZFilter_processBlock().
+     @param filter A pointer to the relevant tVZFilter.
+     @param in The buffer of input samples.
+     @param freq The buffer of frequencies in Hz.
+     @param resonance The buffer of resonances, as in tVZFilter_setResonance(), or NULL to keep the current resonance.
+     @param out The buffer to write the output samples to. May be the same as the input.
+     @param size The number of samples to process.
+     
      @fn void    tVZFilter_calcCoeffs           (tVZFilter* const)
      @brief
      @param filter A pointer to the relevant tVZFilter.
@@ -1060,6 +1412,9 @@ extern "C" {
     void    tVZFilter_setSampleRate  (tVZFilter* const, float sampleRate);
     float   tVZFilter_tick               (tVZFilter* const, float input);
     float   tVZFilter_tickEfficient               (tVZFilter* const vf, float in);
+    void    tVZFilter_processBlock      (tVZFilter* const, const float* const in, float* const out, int size);
+    void    tVZFilter_processBlockModulated(tVZFilter* const, const float* const in, const float* const freq,
+                                            const float* const resonance, float* const out, int size);
     void    tVZFilter_calcCoeffs           (tVZFilter* const);
     void    tVZFilter_calcCoeffsEfficientBP           (tVZFilter* const);
     void    tVZFilter_setBandwidth            (tVZFilter* const, float bandWidth);
@@ -1170,6 +1525,349 @@ extern "C" {
     void    tLadderFilter_setQ     (tLadderFilter* const vf, float resonance);
     void    tLadderFilter_setSampleRate(tLadderFilter* const vf, float sr);
     
+    //==============================================================================
+    
+#define FILTERBANK_LANES 8
+    
+    /*!
+     @defgroup tsvfbank tSVFBank
+     @ingroup filters
+     @brief Bank of state variable filters of one type, one per voice, stored so that all of the voices can be filtered together.
+     @details Each voice has its own cutoff and Q. They can be set per block with tSVFBank_setFreq() and tSVFBank_setQ(), or the cutoffs can change every sample with tSVFBank_processBlockModulated(). The output of each voice is the same as that of a tSVF with the same settings.
+     @{
+     
+     @fn void    tSVFBank_init           (tSVFBank* const bank, SVFType type, int numVoices, float freq, float Q, LEAF* const leaf)
+     @brief Initialize a tSVFBank to the default mempool of a LEAF instance.
+     @param bank A pointer to the tSVFBank to initialize.
+     @param type The type of the filters, shared by all voices.
+     @param numVoices The number of voices in the bank.
+     @param freq The initial cutoff of every voice.
+     @param Q The initial Q of every voice.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tSVFBank_initToPool     (tSVFBank* const bank, SVFType type, int numVoices, float freq, float Q, tMempool* const mempool)
+     @brief Initialize a tSVFBank to a specified mempool.
+     @param bank A pointer to the tSVFBank to initialize.
+     @param type The type of the filters, shared by all voices.
+     @param numVoices The number of voices in the bank.
+     @param freq The initial cutoff of every voice.
+     @param Q The initial Q of every voice.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tSVFBank_free           (tSVFBank* const bank)
+     @brief Free a tSVFBank from its mempool.
+     @param bank A pointer to the tSVFBank to free.
+     
+     @fn void    tSVFBank_tick           (tSVFBank* const bank, const float* const in, float* const out)
+     @brief Filter one sample of every voice.
+     @param bank A pointer to the relevant tSVFBank.
+     @param in An array of numVoices input samples.
+     @param out An array to write the numVoices output samples to. May be the same as the input.
+     
+     @fn void    tSVFBank_processBlock   (tSVFBank* const bank, float** const in, float** const out, int size)
+     @brief Filter a block of samples of every voice at their current cutoffs and Qs. A voice that has blown up is reset and its block silenced.
+     @param bank A pointer to the relevant tSVFBank.
+     @param in An array of numVoices buffers of input samples.
+     @param out An array of numVoices buffers to write the output samples to. These may be the same as the input buffers.
+     @param size The number of samples to process.
+     
+     @fn void    tSVFBank_processBlockModulated (tSVFBank* const bank, float** const in, float** const freq, float** const out, int size)
+     @brief Filter a block of samples of every voice with a new cutoff for each sample, as in tSVF_processBlockModulated(). Each voice is left set to its last cutoff.
+     @param bank A pointer to the relevant tSVFBank.
+     @param in An array of numVoices buffers of input samples.
+     @param freq An array of numVoices buffers of cutoffs in Hz, one for each sample.
+     @param out An array of numVoices buffers to write the output samples to. These may be the same as the input buffers.
+     @param size The number of samples to process.
+     
+     @fn void    tSVFBank_setFreq        (tSVFBank* const bank, int voice, float freq)
+     @brief Set the cutoff of one voice.
+     @param bank A pointer to the relevant tSVFBank.
+     @param voice The index of the voice.
+     @param freq The cutoff in Hz.
+     
+     @fn void    tSVFBank_setQ           (tSVFBank* const bank, int voice, float Q)
+     @brief Set the Q of one voice.
+     @param bank A pointer to the relevant tSVFBank.
+     @param voice The index of the voice.
+     @param Q The Q.
+     
+     @fn void    tSVFBank_setSampleRate  (tSVFBank* const bank, float sr)
+     @brief Set the sample rate, keeping the cutoff of every voice.
+     @param bank A pointer to the relevant tSVFBank.
+     @param sr The new sample rate.
+     
+     @} */
+    
+    // Coefficients and state of FILTERBANK_LANES voices of a tSVFBank
+    typedef struct _tSVFLanes
+    {
+        float cutoff[FILTERBANK_LANES];
+        float Q[FILTERBANK_LANES];
+        float g[FILTERBANK_LANES];
+        float k[FILTERBANK_LANES];
+        float a1[FILTERBANK_LANES];
+        float a2[FILTERBANK_LANES];
+        float a3[FILTERBANK_LANES];
+        float ic1eq[FILTERBANK_LANES];
+        float ic2eq[FILTERBANK_LANES];
+    } _tSVFLanes;
+    
+    typedef struct _tSVFBank
+    {
+        tMempool mempool;
+        SVFType type;
+        int numVoices;
+        // Voices, FILTERBANK_LANES to a group
+        _tSVFLanes* voices;
+        int numGroups;
+        float cH, cB, cBK, cL;
+        float sampleRate;
+        float invSampleRate;
+        // One sample of every voice in and out, and its cutoff
+        float* x;
+        float* y;
+        float* fc;
+    } _tSVFBank;
+    
+    typedef _tSVFBank* tSVFBank;
+    
+    void    tSVFBank_init           (tSVFBank* const bank, SVFType type, int numVoices, float freq, float Q, LEAF* const leaf);
+    void    tSVFBank_initToPool     (tSVFBank* const bank, SVFType type, int numVoices, float freq, float Q, tMempool* const mempool);
+    void    tSVFBank_free           (tSVFBank* const bank);
+    
+    void    tSVFBank_tick           (tSVFBank* const bank, const float* const in, float* const out);
+    void    tSVFBank_processBlock   (tSVFBank* const bank, float** const in, float** const out, int size);
+    void    tSVFBank_processBlockModulated(tSVFBank* const bank, float** const in, float** const freq, float** const out, int size);
+    void    tSVFBank_setFreq        (tSVFBank* const bank, int voice, float freq);
+    void    tSVFBank_setQ           (tSVFBank* const bank, int voice, float Q);
+    void    tSVFBank_setSampleRate  (tSVFBank* const bank, float sr);
+    
+    //==============================================================================
+    
+    /*!
+     @defgroup tdiodefilterbank tDiodeFilterBank
+     @ingroup filters
+     @brief Bank of diode ladder filters, one per voice, stored so that the nonlinear stages of all of the voices are solved together.
+     @details Each voice has its own cutoff and resonance. They can be set per block with tDiodeFilterBank_setFreq() and tDiodeFilterBank_setQ(), or the cutoffs can change every sample with tDiodeFilterBank_processBlockModulated(). The output of each voice is the same as that of a tDiodeFilter with the same settings, except that the output saturation is a rational approximation of tanh, within 1e-4 of it, so that it can also be computed for all voices at once.
+     @{
+     
+     @fn void    tDiodeFilterBank_init           (tDiodeFilterBank* const bank, int numVoices, float freq, float Q, LEAF* const leaf)
+     @brief Initialize a tDiodeFilterBank to the default mempool of a LEAF instance.
+     @param bank A pointer to the tDiodeFilterBank to initialize.
+     @param numVoices The number of voices in the bank.
+     @param freq The initial cutoff of every voice, limited as in tDiodeFilter_setFreq().
+     @param Q The initial resonance of every voice, as in tDiodeFilter_setQ().
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tDiodeFilterBank_initToPool     (tDiodeFilterBank* const bank, int numVoices, float freq, float Q, tMempool* const mempool)
+     @brief Initialize a tDiodeFilterBank to a specified mempool.
+     @param bank A pointer to the tDiodeFilterBank to initialize.
+     @param numVoices The number of voices in the bank.
+     @param freq The initial cutoff of every voice, limited as in tDiodeFilter_setFreq().
+     @param Q The initial resonance of every voice, as in tDiodeFilter_setQ().
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tDiodeFilterBank_free           (tDiodeFilterBank* const bank)
+     @brief Free a tDiodeFilterBank from its mempool.
+     @param bank A pointer to the tDiodeFilterBank to free.
+     
+     @fn void    tDiodeFilterBank_tick           (tDiodeFilterBank* const bank, const float* const in, float* const out)
+     @brief Filter one sample of every voice.
+     @param bank A pointer to the relevant tDiodeFilterBank.
+     @param in An array of numVoices input samples.
+     @param out An array to write the numVoices output samples to. May be the same as the input.
+     
+     @fn void    tDiodeFilterBank_processBlock   (tDiodeFilterBank* const bank, float** const in, float** const out, int size)
+     @brief Filter a block of samples of every voice at their current cutoffs and resonances.
+     @param bank A pointer to the relevant tDiodeFilterBank.
+     @param in An array of numVoices buffers of input samples.
+     @param out An array of numVoices buffers to write the output samples to. These may be the same as the input buffers.
+     @param size The number of samples to process.
+     
+     @fn void    tDiodeFilterBank_processBlockModulated (tDiodeFilterBank* const bank, float** const in, float** const freq, float** const out, int size)
+     @brief Filter a block of samples of every voice with a new cutoff for each sample. Each voice is left set to its last cutoff.
+     @param bank A pointer to the relevant tDiodeFilterBank.
+     @param in An array of numVoices buffers of input samples.
+     @param freq An array of numVoices buffers of cutoffs in Hz, one for each sample.
+     @param out An array of numVoices buffers to write the output samples to. These may be the same as the input buffers.
+     @param size The number of samples to process.
+     
+     @fn void    tDiodeFilterBank_setFreq        (tDiodeFilterBank* const bank, int voice, float cutoff)
+     @brief Set the cutoff of one voice.
+     @param bank A pointer to the relevant tDiodeFilterBank.
+     @param voice The index of the voice.
+     @param cutoff The cutoff in Hz.
+     
+     @fn void    tDiodeFilterBank_setQ           (tDiodeFilterBank* const bank, int voice, float resonance)
+     @brief Set the resonance of one voice.
+     @param bank A pointer to the relevant tDiodeFilterBank.
+     @param voice The index of the voice.
+     @param resonance The resonance.
+     
+     @fn void    tDiodeFilterBank_setSampleRate  (tDiodeFilterBank* const bank, float sr)
+     @brief Set the sample rate, keeping the cutoff of every voice.
+     @param bank A pointer to the relevant tDiodeFilterBank.
+     @param sr The new sample rate.
+     
+     @} */
+    
+    // Coefficients and state of FILTERBANK_LANES voices of a tDiodeFilterBank
+    typedef struct _tDiodeLanes
+    {
+        float cutoff[FILTERBANK_LANES];
+        float f[FILTERBANK_LANES];
+        float r[FILTERBANK_LANES];
+        float zi[FILTERBANK_LANES];
+        float s0[FILTERBANK_LANES];
+        float s1[FILTERBANK_LANES];
+        float s2[FILTERBANK_LANES];
+        float s3[FILTERBANK_LANES];
+    } _tDiodeLanes;
+    
+    typedef struct _tDiodeFilterBank
+    {
+        tMempool mempool;
+        int numVoices;
+        // Voices, FILTERBANK_LANES to a group
+        _tDiodeLanes* voices;
+        int numGroups;
+        float g0inv;
+        float g1inv;
+        float g2inv;
+        float invSampleRate;
+        // One sample of every voice in and out, and its cutoff
+        float* x;
+        float* y;
+        float* fc;
+    } _tDiodeFilterBank;
+    
+    typedef _tDiodeFilterBank* tDiodeFilterBank;
+    
+    void    tDiodeFilterBank_init           (tDiodeFilterBank* const bank, int numVoices, float freq, float Q, LEAF* const leaf);
+    void    tDiodeFilterBank_initToPool     (tDiodeFilterBank* const bank, int numVoices, float freq, float Q, tMempool* const mempool);
+    void    tDiodeFilterBank_free           (tDiodeFilterBank* const bank);
+    
+    void    tDiodeFilterBank_tick           (tDiodeFilterBank* const bank, const float* const in, float* const out);
+    void    tDiodeFilterBank_processBlock   (tDiodeFilterBank* const bank, float** const in, float** const out, int size);
+    void    tDiodeFilterBank_processBlockModulated(tDiodeFilterBank* const bank, float** const in, float** const freq, float** const out, int size);
+    void    tDiodeFilterBank_setFreq        (tDiodeFilterBank* const bank, int voice, float cutoff);
+    void    tDiodeFilterBank_setQ           (tDiodeFilterBank* const bank, int voice, float resonance);
+    void    tDiodeFilterBank_setSampleRate  (tDiodeFilterBank* const bank, float sr);
+    
+    //==============================================================================
+    
+    /*!
+     @defgroup tladderfilterbank tLadderFilterBank
+     @ingroup filters
+     @brief Bank of transistor ladder filters, one per voice, stored so that the nonlinear stages of all of the voices are solved together.
+     @details Each voice has its own cutoff and resonance. They can be set per block with tLadderFilterBank_setFreq() and tLadderFilterBank_setQ(), or the cutoffs can change every sample with tLadderFilterBank_processBlockModulated(). The output of each voice is the same as that of a tLadderFilter with the same settings.
+     @{
+     
+     @fn void    tLadderFilterBank_init           (tLadderFilterBank* const bank, int numVoices, float freq, float Q, LEAF* const leaf)
+     @brief Initialize a tLadderFilterBank to the default mempool of a LEAF instance.
+     @param bank A pointer to the tLadderFilterBank to initialize.
+     @param numVoices The number of voices in the bank.
+     @param freq The initial cutoff of every voice, limited as in tLadderFilter_setFreq().
+     @param Q The initial resonance of every voice, as in tLadderFilter_setQ().
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tLadderFilterBank_initToPool     (tLadderFilterBank* const bank, int numVoices, float freq, float Q, tMempool* const mempool)
+     @brief Initialize a tLadderFilterBank to a specified mempool.
+     @param bank A pointer to the tLadderFilterBank to initialize.
+     @param numVoices The number of voices in the bank.
+     @param freq The initial cutoff of every voice, limited as in tLadderFilter_setFreq().
+     @param Q The initial resonance of every voice, as in tLadderFilter_setQ().
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tLadderFilterBank_free           (tLadderFilterBank* const bank)
+     @brief Free a tLadderFilterBank from its mempool.
+     @param bank A pointer to the tLadderFilterBank to free.
+     
+     @fn void    tLadderFilterBank_tick           (tLadderFilterBank* const bank, const float* const in, float* const out)
+     @brief Filter one sample of every voice.
+     @param bank A pointer to the relevant tLadderFilterBank.
+     @param in An array of numVoices input samples.
+     @param out An array to write the numVoices output samples to. May be the same as the input.
+     
+     @fn void    tLadderFilterBank_processBlock   (tLadderFilterBank* const bank, float** const in, float** const out, int size)
+     @brief Filter a block of samples of every voice at their current cutoffs and resonances.
+     @param bank A pointer to the relevant tLadderFilterBank.
+     @param in An array of numVoices buffers of input samples.
+     @param out An array of numVoices buffers to write the output samples to. These may be the same as the input buffers.
+     @param size The number of samples to process.
+     
+     @fn void    tLadderFilterBank_processBlockModulated (tLadderFilterBank* const bank, float** const in, float** const freq, float** const out, int size)
+     @brief Filter a block of samples of every voice with a new cutoff for each sample. Each voice is left set to its last cutoff.
+     @param bank A pointer to the relevant tLadderFilterBank.
+     @param in An array of numVoices buffers of input samples.
+     @param freq An array of numVoices buffers of cutoffs in Hz, one for each sample.
+     @param out An array of numVoices buffers to write the output samples to. These may be the same as the input buffers.
+     @param size The number of samples to process.
+     
+     @fn void    tLadderFilterBank_setFreq        (tLadderFilterBank* const bank, int voice, float cutoff)
+     @brief Set the cutoff of one voice.
+     @param bank A pointer to the relevant tLadderFilterBank.
+     @param voice The index of the voice.
+     @param cutoff The cutoff in Hz.
+     
+     @fn void    tLadderFilterBank_setQ           (tLadderFilterBank* const bank, int voice, float resonance)
+     @brief Set the resonance of one voice.
+     @param bank A pointer to the relevant tLadderFilterBank.
+     @param voice The index of the voice.
+     @param resonance The resonance.
+     
+     @fn void    tLadderFilterBank_setSampleRate  (tLadderFilterBank* const bank, float sr)
+     @brief Set the sample rate, keeping the cutoff of every voice.
+     @param bank A pointer to the relevant tLadderFilterBank.
+     @param sr The new sample rate.
+     
+     @} */
+    
+    // Coefficients and state of FILTERBANK_LANES voices of a tLadderFilterBank
+    typedef struct _tLadderLanes
+    {
+        float cutoff[FILTERBANK_LANES];
+        float c[FILTERBANK_LANES];
+        float c2[FILTERBANK_LANES];
+        float fb[FILTERBANK_LANES];
+        float compensation[FILTERBANK_LANES];
+        float b0[FILTERBANK_LANES];
+        float b1[FILTERBANK_LANES];
+        float b2[FILTERBANK_LANES];
+        float b3[FILTERBANK_LANES];
+    } _tLadderLanes;
+    
+    typedef struct _tLadderFilterBank
+    {
+        tMempool mempool;
+        int numVoices;
+        // Voices, FILTERBANK_LANES to a group
+        _tLadderLanes* voices;
+        int numGroups;
+        float a;
+        float s;
+        float d;
+        float invSampleRate;
+        int oversampling;
+        // One sample of every voice in and out, and its cutoff
+        float* x;
+        float* y;
+        float* fc;
+    } _tLadderFilterBank;
+    
+    typedef _tLadderFilterBank* tLadderFilterBank;
+    
+    void    tLadderFilterBank_init           (tLadderFilterBank* const bank, int numVoices, float freq, float Q, LEAF* const leaf);
+    void    tLadderFilterBank_initToPool     (tLadderFilterBank* const bank, int numVoices, float freq, float Q, tMempool* const mempool);
+    void    tLadderFilterBank_free           (tLadderFilterBank* const bank);
+    
+    void    tLadderFilterBank_tick           (tLadderFilterBank* const bank, const float* const in, float* const out);
+    void    tLadderFilterBank_processBlock   (tLadderFilterBank* const bank, float** const in, float** const out, int size);
+    void    tLadderFilterBank_processBlockModulated(tLadderFilterBank* const bank, float** const in, float** const freq, float** const out, int size);
+    void    tLadderFilterBank_setFreq        (tLadderFilterBank* const bank, int voice, float cutoff);
+    void    tLadderFilterBank_setQ           (tLadderFilterBank* const bank, int voice, float resonance);
+    void    tLadderFilterBank_setSampleRate  (tLadderFilterBank* const bank, float sr);
+    
 
 
 
@@ -44,6 +44,10 @@ extern "C" {
         int     errorState[LEAFErrorNil]; //!< An array of flags that indicate which errors have occurred.
         unsigned int allocCount; //!< A count of LEAF memory allocations.
         unsigned int freeCount; //!< A count of LEAF memory frees.
+        int     concurrentMempools; //!< Set once any mempool of this instance is used from more than one thread, after which allocCount and freeCount are counted atomically.
+        mpool_deferred_t* deferredFrees; //!< Frees waiting for LEAF_collect(). NULL unless enabled with LEAF_enableDeferredFree().
+        struct _tWaveTable* waveTables; //!< Wavetables shared through tWaveTable_initShared().
+        struct _tWaveTableS* waveTablesS; //!< Wavetables shared through tWaveTableS_initShared().
         ///@}
     };
     
@@ -1,161 +1,479 @@
-/*==============================================================================
- 
- In short, mpool is distributed under so called "BSD license",
- 
- Copyright (c) 2009-2010 Tatsuhiko Kubo <cubicdaiya@gmail.com>
- All rights reserved.
- 
- Redistribution and use in source and binary forms, with or without modification,
- are permitted provided that the following conditions are met:
- 
- * Redistributions of source code must retain the above copyright notice,
- this list of conditions and the following disclaimer.
- 
- * Redistributions in binary form must reproduce the above copyright notice,
- this list of conditions and the following disclaimer in the documentation
- and/or other materials provided with the distribution.
- 
- * Neither the name of the authors nor the names of its contributors
- may be used to endorse or promote products derived from this software
- without specific prior written permission.
- 
- THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
- "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
- LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
- A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
- OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
- SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
- TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
- PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
- LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
- NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
- SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
- 
- written by C99 style
- ==============================================================================*/
-
-#ifndef LEAF_MPOOL_H_INCLUDED
-#define LEAF_MPOOL_H_INCLUDED
-
-#ifdef __cplusplus
-extern "C" {
-#endif
-    
-    //==============================================================================
-    
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <stdbool.h>
-    
-    //==============================================================================
-    
-#define MPOOL_ALIGN_SIZE (8)
-    
-    typedef struct LEAF LEAF;
-    
-    typedef enum LEAFErrorType
-    {
-        LEAFMempoolOverrun = 0,
-        LEAFMempoolFragmentation,
-        LEAFInvalidFree,
-        LEAFErrorNil
-    } LEAFErrorType;
-    
-    /*!
-     * @defgroup tmempool tMempool
-     * @ingroup mempool
-     * @brief Memory pool for the allocation of LEAF objects.
-     * @{
-     */
-    
-    // node of free list
-    typedef struct mpool_node_t {
-        char                *pool;     // memory pool field
-        struct mpool_node_t *next;     // next node pointer
-        struct mpool_node_t *prev;     // prev node pointer
-        size_t size;
-    } mpool_node_t;
-    
-    typedef struct _tMempool _tMempool;
-    typedef _tMempool* tMempool;
-    struct _tMempool
-    {
-        tMempool      mempool;
-        LEAF*         leaf;
-        char*         mpool;       // start of the mpool
-        size_t        usize;       // used size of the pool
-        size_t        msize;       // max size of the pool
-        mpool_node_t* head;        // first node of memory pool free list
-    };
-    
-    //! Initialize a tMempool for a given memory location and size to the default mempool of a LEAF instance.
-    /*!
-     @param pool A pointer to the tMempool to initialize.
-     @param memory A pointer to the chunk of memory to be used as a mempool.
-     @param size The size of the chunk of memory to be used as a mempool.
-     @param leaf A pointer to the leaf instance.
-     */
-    void    tMempool_init           (tMempool* const pool, char* memory, size_t size, LEAF* const leaf);
-    
-    
-    //! Free a tMempool from its mempool.
-    /*!
-     @param pool A pointer to the tMempool to free.
-     */
-    void    tMempool_free           (tMempool* const pool);
-    
-    
-    //! Initialize a tMempool for a given memory location and size to a specified mempool.
-    /*!
-     @param pool A pointer to the tMempool to initialize.
-     @param memory A pointer to the chunk of memory to be used as a mempool.
-     @param size The size of the chuck of memory to be used as a mempool.
-     @param poolTo A pointer to the tMempool to which this tMempool should be initialized.
-     */
-    void    tMempool_initToPool     (tMempool* const mp, char* memory, size_t size, tMempool* const mem);
-
-    /*!￼￼￼
-     @} */
-    
-    //==============================================================================
-
-    //    typedef struct mpool_t {
-    //        char*         mpool;       // start of the mpool
-    //        size_t        usize;       // used size of the pool
-    //        size_t        msize;       // max size of the pool
-    //        mpool_node_t* head;        // first node of memory pool free list
-    //    } mpool_t;
-    
-    void mpool_create (char* memory, size_t size, _tMempool* pool);
-    
-    char* mpool_alloc(size_t size, _tMempool* pool);
-    char* mpool_calloc(size_t asize, _tMempool* pool);
-    
-    void mpool_free(char* ptr, _tMempool* pool);
-    
-    size_t mpool_get_size(_tMempool* pool);
-    size_t mpool_get_used(_tMempool* pool);
-    
-    void leaf_pool_init(LEAF* const leaf, char* memory, size_t size);
-    
-    char* leaf_alloc(LEAF* const leaf, size_t size);
-    char* leaf_calloc(LEAF* const leaf, size_t size);
-    
-    void leaf_free(LEAF* const leaf, char* ptr);
-    
-    size_t leaf_pool_get_size(LEAF* const leaf);
-    size_t leaf_pool_get_used(LEAF* const leaf);
-    
-    char* leaf_pool_get_pool(LEAF* const leaf);
-    
-#ifdef __cplusplus
-}
-#endif
-
-#endif // LEAF_MPOOL_H
-
-//==============================================================================
-
-
-
+/*==============================================================================
+ 
+ In short, mpool is distributed under so called "BSD license",
+ 
+ Copyright (c) 2009-2010 Tatsuhiko Kubo <cubicdaiya@gmail.com>
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the authors nor the names of its contributors
+ may be used to endorse or promote products derived from this software
+ without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ 
+ written by C99 style
+ ==============================================================================*/
+
+#ifndef LEAF_MPOOL_H_INCLUDED
+#define LEAF_MPOOL_H_INCLUDED
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+    
+    //==============================================================================
+    
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+    
+#if _WIN32 || _WIN64
+#include "..\leaf-config.h"
+#else
+#include "../leaf-config.h"
+#endif
+    
+    //==============================================================================
+    
+#define MPOOL_ALIGN_SIZE (8)
+    
+    // Alignment LEAF objects request for their sample buffers so they can be read with aligned vector loads
+#ifndef MPOOL_CACHE_LINE_SIZE
+#define MPOOL_CACHE_LINE_SIZE (64)
+#endif
+    
+    // TLSF configuration: number of second-level lists per power of two (log2) and the largest first-level index
+#define MPOOL_TLSF_SL_INDEX_COUNT_LOG2 (4)
+#define MPOOL_TLSF_FL_INDEX_MAX (30)
+    
+#define MPOOL_TLSF_SL_INDEX_COUNT (1 << MPOOL_TLSF_SL_INDEX_COUNT_LOG2)
+#define MPOOL_TLSF_FL_INDEX_SHIFT (MPOOL_TLSF_SL_INDEX_COUNT_LOG2 + 3) // + log2(MPOOL_ALIGN_SIZE)
+#define MPOOL_TLSF_FL_INDEX_COUNT (MPOOL_TLSF_FL_INDEX_MAX - MPOOL_TLSF_FL_INDEX_SHIFT + 1)
+#define MPOOL_TLSF_SMALL_BLOCK_SIZE (1 << MPOOL_TLSF_FL_INDEX_SHIFT)
+    
+    // Thread cache configuration: power of two size classes starting at MPOOL_CACHE_MIN_SIZE,
+    // and the number of blocks kept per class before they are given back to the shared pool
+#define MPOOL_CACHE_CLASS_COUNT (8)
+#define MPOOL_CACHE_MIN_SIZE (16)
+#define MPOOL_CACHE_MAGAZINE_SIZE (32)
+    
+    // Slab size classes are multiples of MPOOL_SLAB_CLASS_SIZE up to MPOOL_SLAB_CLASS_SIZE * MPOOL_SLAB_CLASS_COUNT bytes
+#define MPOOL_SLAB_CLASS_SIZE (16)
+#define MPOOL_SLAB_CLASS_COUNT (16)
+#define MPOOL_SLAB_CHUNK_SIZE (2048)
+    
+    // Size mapped regions are rounded up to when backed by huge pages
+#ifndef MPOOL_HUGE_PAGE_SIZE
+#define MPOOL_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+#endif
+    
+    // Free block size histogram of mpool_stats_t, bucket i counts blocks of MPOOL_STATS_MIN_SIZE << i bytes and up
+#define MPOOL_STATS_HISTOGRAM_SIZE (24)
+#define MPOOL_STATS_MIN_SIZE (16)
+    
+    typedef struct LEAF LEAF;
+    
+    typedef enum LEAFErrorType
+    {
+        LEAFMempoolOverrun = 0,
+        LEAFMempoolFragmentation,
+        LEAFInvalidFree,
+        LEAFInvalidData,
+        LEAFErrorNil
+    } LEAFErrorType;
+    
+    /*!
+     @ingroup mempool
+     @brief Allocation strategies available to a tMempool.
+     */
+    typedef enum MempoolType
+    {
+        MempoolFirstFit = 0, //!< First-fit free list. The default for all mempools.
+        MempoolTLSF, //!< Two-level segregated fit. Constant time allocation and free, regardless of fragmentation.
+        MempoolArena, //!< Pointer-bump allocation with no per-allocation header. Freeing is a no-op; all memory is released at once with tMempool_reset().
+        MempoolTypeNil
+    } MempoolType;
+    
+#if LEAF_USE_MMAP
+    /*!
+     @ingroup mempool
+     @brief Options for mempools created with tMempool_initMapped(). Can be combined.
+     */
+    typedef enum MempoolMapFlags
+    {
+        MempoolMapHugePages = 1, //!< Back the mempool with huge pages, or transparent huge pages if none are reserved.
+        MempoolMapLocked = 2, //!< Fault in the whole mempool up front and lock it in memory, so using it never waits on a page fault.
+        MempoolMapGrow = 4 //!< Map another region with the same options when an allocation doesn't fit, instead of failing.
+    } MempoolMapFlags;
+#endif
+    
+    /*!
+     * @defgroup tmempool tMempool
+     * @ingroup mempool
+     * @brief Memory pool for the allocation of LEAF objects.
+     * @{
+     */
+    
+    // node of free list
+    typedef struct mpool_node_t {
+        char                *pool;      // memory pool field
+        struct mpool_node_t *next;      // next node pointer
+        struct mpool_node_t *prev;      // prev node pointer
+        struct mpool_node_t *prev_phys; // node physically before this one in the pool
+        size_t size;
+        int    is_free;                 // whether the node is on a free list
+#if LEAF_MEMPOOL_COMPACTION
+        unsigned int alignment;         // alignment the node was allocated with
+        void** owner;                   // handle to update when compaction moves the node, NULL if it can't be moved
+#endif
+#if LEAF_MEMPOOL_TRACK_CALLERS
+        void*  caller;                  // code address that allocated the node
+#endif
+    } mpool_node_t;
+    
+    // segregated free lists of a MempoolTLSF pool, stored at the start of the pool memory
+    typedef struct mpool_tlsf_t {
+        uint32_t      fl_bitmap;                                   // first-level lists that are non-empty
+        uint32_t      sl_bitmap[MPOOL_TLSF_FL_INDEX_COUNT];        // second-level lists that are non-empty
+        mpool_node_t* blocks[MPOOL_TLSF_FL_INDEX_COUNT][MPOOL_TLSF_SL_INDEX_COUNT];
+    } mpool_tlsf_t;
+    
+    // per-thread front end of a shared pool
+    typedef struct mpool_cache_t {
+        mpool_node_t* magazines[MPOOL_CACHE_CLASS_COUNT];          // blocks ready for reuse by the owning thread
+        int           counts[MPOOL_CACHE_CLASS_COUNT];
+        mpool_node_t* volatile remote;                             // blocks freed through the cache, not yet collected
+    } mpool_cache_t;
+    
+    // headerless objects of small sizes, carved out of a block reserved from a pool
+    typedef struct mpool_slab_t {
+        char*          chunks;                          // first chunk, aligned to MPOOL_CACHE_LINE_SIZE
+        size_t         chunk_count;
+        size_t         chunks_used;                     // chunks handed to a size class so far
+        unsigned char* chunk_class;                     // size class each chunk was handed to
+        char*          free[MPOOL_SLAB_CLASS_COUNT];    // freed objects of each class, linked through their first bytes
+        char*          next[MPOOL_SLAB_CLASS_COUNT];    // next unused object in the current chunk of each class
+        char*          limit[MPOOL_SLAB_CLASS_COUNT];   // end of the current chunk of each class
+    } mpool_slab_t;
+    
+    /*!
+     @brief Allocation statistics of a tMempool, filled in by tMempool_getStats().
+     */
+    typedef struct mpool_stats_t {
+        size_t       size;              //!< Size of the mempool in bytes.
+        size_t       used;              //!< Bytes in use, including block headers.
+        size_t       max_used;          //!< Most bytes ever in use at once.
+        size_t       free;              //!< Bytes in free blocks.
+        size_t       largest_free;      //!< Size of the largest free block, the largest allocation that can currently succeed.
+        unsigned int free_blocks;       //!< Number of free blocks.
+        unsigned int used_blocks;       //!< Number of allocated blocks.
+        unsigned int free_histogram[MPOOL_STATS_HISTOGRAM_SIZE]; //!< Free blocks by size. Bucket i counts blocks of at least MPOOL_STATS_MIN_SIZE << i bytes, and the first bucket also counts smaller ones.
+        unsigned int allocs;            //!< Number of allocations.
+        unsigned int frees;             //!< Number of frees.
+        unsigned int failed_allocs;     //!< Number of allocations that failed.
+        unsigned int alloc_steps;       //!< Free blocks looked at by all allocations.
+        unsigned int max_alloc_steps;   //!< Most free blocks looked at by a single allocation.
+        uint32_t     alloc_ticks;       //!< Time spent in allocations, in ticks of the clock set with tMempool_setClock().
+        uint32_t     max_alloc_ticks;   //!< Longest single allocation in clock ticks.
+        uint32_t     free_ticks;        //!< Time spent in frees, in clock ticks.
+        uint32_t     max_free_ticks;    //!< Longest single free in clock ticks.
+    } mpool_stats_t;
+    
+    typedef struct _tMempool _tMempool;
+    typedef _tMempool* tMempool;
+    struct _tMempool
+    {
+        tMempool      mempool;
+        LEAF*         leaf;
+        char*         mpool;       // start of the mpool
+        size_t        usize;       // used size of the pool
+        size_t        msize;       // max size of the pool
+        mpool_node_t* head;        // first node of memory pool free list
+        MempoolType   type;        // allocation strategy of the pool
+        mpool_tlsf_t* tlsf;        // free lists of a MempoolTLSF pool
+        size_t        alignment;   // alignment of allocations that don't request their own
+        mpool_cache_t* cache;      // set for thread caches, which allocate from the pool in mempool
+        int           concurrent;  // whether allocation and free have to be serialized
+        volatile int  lock;
+        mpool_slab_t* slab;        // slabs serving small allocations, if reserved
+        mpool_stats_t stats;       // running counters, the rest is filled in by mpool_get_stats
+        uint32_t      (*clock)(void); // timer used to measure allocation and free, if set
+#if LEAF_USE_MMAP
+        int           map_flags;   // MempoolMapFlags the pool was mapped with
+        char*         map_base;    // start of the mapping to unmap when the pool is freed, NULL if not mapped
+        size_t        map_size;
+        _tMempool*    next;        // region mapped after this one ran out, its _tMempool sits at the start of the mapping
+#endif
+    };
+    
+    // a free waiting to be carried out by LEAF_collect()
+    typedef struct mpool_deferred_free_t {
+        char*      ptr;
+        _tMempool* pool;
+        volatile unsigned int sequence;   // position the slot is ready to be written at, plus one once written
+    } mpool_deferred_free_t;
+    
+    // multiple producer, single consumer ring of deferred frees
+    typedef struct mpool_deferred_t {
+        mpool_deferred_free_t* entries;
+        mpool_deferred_free_t* scratch;   // entries being collected, sorted by address
+        unsigned int           capacity;  // power of two
+        volatile unsigned int  head;      // claimed by the freeing threads
+        volatile unsigned int  tail;      // advanced by LEAF_collect()
+        volatile int           lock;      // held while collecting
+    } mpool_deferred_t;
+    
+    //! Initialize a tMempool for a given memory location and size to the default mempool of a LEAF instance.
+    /*!
+     @param pool A pointer to the tMempool to initialize.
+     @param memory A pointer to the chunk of memory to be used as a mempool.
+     @param size The size of the chunk of memory to be used as a mempool.
+     @param leaf A pointer to the leaf instance.
+     */
+    void    tMempool_init           (tMempool* const pool, char* memory, size_t size, LEAF* const leaf);
+    
+    
+    //! Free a tMempool from its mempool.
+    /*!
+     @param pool A pointer to the tMempool to free.
+     */
+    void    tMempool_free           (tMempool* const pool);
+    
+    
+    //! Initialize a tMempool for a given memory location and size to a specified mempool.
+    /*!
+     @param pool A pointer to the tMempool to initialize.
+     @param memory A pointer to the chunk of memory to be used as a mempool.
+     @param size The size of the chuck of memory to be used as a mempool.
+     @param poolTo A pointer to the tMempool to which this tMempool should be initialized.
+     */
+    void    tMempool_initToPool     (tMempool* const mp, char* memory, size_t size, tMempool* const mem);
+    
+    
+    //! Initialize a tMempool with a given allocation strategy to the default mempool of a LEAF instance.
+    /*!
+     @param pool A pointer to the tMempool to initialize.
+     @param memory A pointer to the chunk of memory to be used as a mempool.
+     @param size The size of the chunk of memory to be used as a mempool.
+     @param type The allocation strategy of the mempool. MempoolTLSF gives constant time allocation and free at the cost of a small control structure at the start of the memory.
+     @param leaf A pointer to the leaf instance.
+     */
+    void    tMempool_initWithType   (tMempool* const pool, char* memory, size_t size, MempoolType type, LEAF* const leaf);
+    
+    
+    //! Initialize a tMempool with a given allocation strategy to a specified mempool.
+    /*!
+     @param pool A pointer to the tMempool to initialize.
+     @param memory A pointer to the chunk of memory to be used as a mempool.
+     @param size The size of the chuck of memory to be used as a mempool.
+     @param type The allocation strategy of the mempool.
+     @param poolTo A pointer to the tMempool to which this tMempool should be initialized.
+     */
+    void    tMempool_initToPoolWithType (tMempool* const mp, char* memory, size_t size, MempoolType type, tMempool* const mem);
+    
+    
+    //! Release everything allocated from a tMempool at once, leaving it empty.
+    /*!
+     Any LEAF objects still initialized to the mempool become invalid and must not be used or freed afterwards. This is the only way to reclaim memory from a MempoolArena mempool. When LEAF_USE_DYNAMIC_ALLOCATION is enabled, MempoolArena mempools still allocate from their own memory so that they can be reset, and resetting any other mempool has no effect.
+     @param pool A pointer to the tMempool to reset.
+     */
+    void    tMempool_reset          (tMempool* const pool);
+    
+    
+    //! Set the alignment of allocations from a tMempool that don't request an alignment of their own.
+    /*!
+     @param pool A pointer to the tMempool.
+     @param alignment The alignment in bytes. Rounded up to a power of two no smaller than MPOOL_ALIGN_SIZE.
+     */
+    void    tMempool_setAlignment   (tMempool* const pool, size_t alignment);
+    
+    
+    //! Initialize a thread cache in front of a tMempool shared between threads.
+    /*!
+     Each thread that allocates LEAF objects should initialize objects to its own thread cache. Small allocations are served from blocks the cache keeps for the thread, and everything else is passed to the shared mempool, which from now on serializes allocation and free with a lock. Objects allocated through a thread cache may be freed from any thread; those frees are lock-free and the blocks are reclaimed the next time the owning thread allocates. Free the cache with tMempool_free() to give its blocks back to the shared mempool. The first thread cache of a shared mempool must be initialized before the shared mempool is used from more than one thread.
+     @param cache A pointer to the tMempool to initialize as a thread cache.
+     @param shared A pointer to the tMempool to share between threads.
+     */
+    void    tMempool_initThreadCache (tMempool* const cache, tMempool* const shared);
+    
+    
+    //! Set whether allocation and free on a tMempool are serialized with a lock.
+    /*!
+     Needed when one thread allocates from a mempool while another frees to it, as when LEAF_collect() runs off the audio thread. Must be set before the mempool is used from more than one thread.
+     @param pool A pointer to the tMempool.
+     @param concurrent 1 to serialize allocation and free, 0 otherwise.
+     */
+    void    tMempool_setConcurrent  (tMempool* const pool, int concurrent);
+    
+    
+    //! Get allocation statistics of a tMempool.
+    /*!
+     Walks every block of the mempool, so it should be called from the thread that uses the mempool, unless the mempool is concurrent.
+     @param pool A pointer to the tMempool.
+     @param stats A pointer to the mpool_stats_t to fill in.
+     */
+    void    tMempool_getStats       (tMempool* const pool, mpool_stats_t* stats);
+    
+    
+    //! Write a short report of the statistics and blocks of a tMempool into a buffer.
+    /*!
+     The report lists the statistics of tMempool_getStats() followed by the offset, size, and state of each block, and with LEAF_MEMPOOL_TRACK_CALLERS enabled, the address of the code that allocated it. It stops at the end of the buffer. Like tMempool_getStats(), it should be called from the thread that uses the mempool, and the buffer can then be handed to any other thread.
+     @param pool A pointer to the tMempool.
+     @param buffer The buffer to write the report into. Always null terminated.
+     @param size The size of the buffer in bytes.
+     @return The length of the report written to the buffer.
+     */
+    int     tMempool_dump           (tMempool* const pool, char* buffer, size_t size);
+    
+    
+    //! Set a clock used to measure the time spent allocating from and freeing to a tMempool.
+    /*!
+     @param pool A pointer to the tMempool.
+     @param clock A function returning the current time in any unit, such as a cycle counter, or NULL to stop measuring.
+     */
+    void    tMempool_setClock       (tMempool* const pool, uint32_t (*clock)(void));
+    
+    
+    //! Let tMempool_compact() move the object a handle refers to, updating the handle when it does.
+    /*!
+     Only the memory the handle points to directly is moved, so this suits the handle of any LEAF object initialized to the mempool: the objects it holds internally stay where they are. The handle itself must stay at the same address and must not be inside memory that can be moved, and no copies of it may be kept elsewhere. Freeing the object unregisters it. Has no effect unless LEAF_MEMPOOL_COMPACTION is enabled.
+     @param pool A pointer to the tMempool the object was initialized to.
+     @param handle A pointer to the handle of the object, such as a tCycle*.
+     */
+    void    tMempool_registerHandle (tMempool* const pool, void* handle);
+    
+    
+    //! Stop tMempool_compact() from moving the object a handle refers to.
+    /*!
+     @param pool A pointer to the tMempool the object was initialized to.
+     @param handle A pointer to the handle of the object.
+     */
+    void    tMempool_unregisterHandle (tMempool* const pool, void* handle);
+    
+    
+    //! Move objects with registered handles towards the start of a tMempool so free space gathers into larger blocks.
+    /*!
+     Each call picks up where the free space currently is, so calling it regularly with a small budget compacts the mempool over time. Objects are moved while the call runs, so it has to be called from the thread that uses them, at a time none of them are in use, such as between audio blocks. Has no effect on MempoolArena mempools, thread caches, when LEAF_USE_DYNAMIC_ALLOCATION is enabled, or unless LEAF_MEMPOOL_COMPACTION is enabled.
+     @param pool A pointer to the tMempool.
+     @param maxBytes The most bytes of objects to move in this call.
+     @return The number of bytes moved.
+     */
+    size_t  tMempool_compact        (tMempool* const pool, size_t maxBytes);
+    
+    
+    //! Reserve memory in a tMempool for slabs of small, same sized objects.
+    /*!
+     The memory is split into chunks of MPOOL_SLAB_CHUNK_SIZE bytes, each handed to a size class the first time an allocation of that class needs room. Allocations up to MPOOL_SLAB_CLASS_SIZE * MPOOL_SLAB_CLASS_COUNT bytes are then served from the chunks of their size class without a block header, so objects of the same type are packed together, and freeing them only pushes them onto a list. A chunk stays with its size class until the mempool is reset. Allocations go to the rest of the mempool when their class has no room left, or if they ask for more than MPOOL_SLAB_CLASS_SIZE alignment. Objects served from slabs can't be moved by tMempool_compact(). Has no effect on MempoolArena mempools, thread caches, or when LEAF_USE_DYNAMIC_ALLOCATION is enabled.
+     @param pool A pointer to the tMempool.
+     @param size The number of bytes to reserve. Rounded down to a multiple of MPOOL_SLAB_CHUNK_SIZE.
+     */
+    void    tMempool_reserveSlabs   (tMempool* const pool, size_t size);
+    
+#if LEAF_USE_MMAP
+    //! Initialize a tMempool over memory mapped from the operating system, to the default mempool of a LEAF instance.
+    /*!
+     With MempoolMapGrow, an allocation that doesn't fit maps a further region, twice the size of the one before, and all regions are unmapped by tMempool_free(). Mapping happens on the thread that allocates, so a mempool used on the audio thread should be given enough room up front and only rely on growing as a safety net. MempoolArena mempools don't grow. If the memory can't be mapped, a LEAFMempoolOverrun error is raised and the tMempool is left NULL.
+     @param pool A pointer to the tMempool to initialize.
+     @param size The size of the mempool in bytes. Rounded up to a whole number of pages.
+     @param type The allocation strategy of the mempool.
+     @param flags A combination of MempoolMapFlags.
+     @param leaf A pointer to the leaf instance.
+     */
+    void    tMempool_initMapped     (tMempool* const pool, size_t size, MempoolType type, int flags, LEAF* const leaf);
+    
+    
+    //! Initialize a tMempool over memory mapped from the operating system, to a specified mempool.
+    /*!
+     @param pool A pointer to the tMempool to initialize.
+     @param size The size of the mempool in bytes.
+     @param type The allocation strategy of the mempool.
+     @param flags A combination of MempoolMapFlags.
+     @param mem A pointer to the tMempool to which this tMempool should be initialized.
+     */
+    void    tMempool_initMappedToPool (tMempool* const pool, size_t size, MempoolType type, int flags, tMempool* const mem);
+#endif
+
+    /*!￼￼￼
+     @} */
+    
+    //==============================================================================
+
+    //    typedef struct mpool_t {
+    //        char*         mpool;       // start of the mpool
+    //        size_t        usize;       // used size of the pool
+    //        size_t        msize;       // max size of the pool
+    //        mpool_node_t* head;        // first node of memory pool free list
+    //    } mpool_t;
+    
+    void mpool_create (char* memory, size_t size, _tMempool* pool);
+    void mpool_create_with_type (char* memory, size_t size, MempoolType type, _tMempool* pool);
+    
+    char* mpool_alloc(size_t size, _tMempool* pool);
+    char* mpool_calloc(size_t asize, _tMempool* pool);
+    
+    char* mpool_alloc_aligned(size_t asize, size_t alignment, _tMempool* pool);
+    char* mpool_calloc_aligned(size_t asize, size_t alignment, _tMempool* pool);
+    
+    void mpool_free(char* ptr, _tMempool* pool);
+    
+    void mpool_reset(_tMempool* pool);
+    
+    size_t mpool_get_size(_tMempool* pool);
+    size_t mpool_get_used(_tMempool* pool);
+    
+    void mpool_walk(_tMempool* pool, void (*visit)(mpool_node_t* node, void* context), void* context);
+    void mpool_get_stats(_tMempool* pool, mpool_stats_t* stats);
+    int mpool_dump(_tMempool* pool, char* buffer, size_t size);
+    
+    void mpool_set_owner(char* ptr, void** owner, _tMempool* pool);
+    size_t mpool_compact(_tMempool* pool, size_t max_bytes);
+    
+    void mpool_reserve_slabs(size_t size, _tMempool* pool);
+    
+    void leaf_pool_init(LEAF* const leaf, char* memory, size_t size);
+    
+    void leaf_enable_deferred_free(LEAF* const leaf, int capacity);
+    int leaf_collect(LEAF* const leaf);
+    
+    char* leaf_alloc(LEAF* const leaf, size_t size);
+    char* leaf_calloc(LEAF* const leaf, size_t size);
+    
+    void leaf_free(LEAF* const leaf, char* ptr);
+    
+    size_t leaf_pool_get_size(LEAF* const leaf);
+    size_t leaf_pool_get_used(LEAF* const leaf);
+    
+    char* leaf_pool_get_pool(LEAF* const leaf);
+    
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LEAF_MPOOL_H
+
+//==============================================================================
+
+
+
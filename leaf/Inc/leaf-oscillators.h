@@ -58,6 +58,26 @@ extern "C" {
      @param osc A pointer to the relevant tCycle.
      @param freq The frequency to set the oscillator to.
      
+     @fn void    tCycle_tickBlock    (tCycle* const osc, float* const out, int size)
+     @brief Tick a tCycle oscillator for a block of samples. The output is identical to calling tCycle_tick() once per sample.
+     @param osc A pointer to the relevant tCycle.
+     @param out The buffer to write the samples to.
+     @param size The number of samples to tick.
+     
+     @fn void    tCycle_tickBlockFM  (tCycle* const osc, float* const out, const float* const freq, int size)
+     @brief Tick a tCycle oscillator for a block of samples with a frequency given for each sample. Negative frequencies run the oscillator backwards, for through-zero FM. The frequency set with tCycle_setFreq() is left as it is.
+     @param osc A pointer to the relevant tCycle.
+     @param out The buffer to write the samples to.
+     @param freq The frequency of each sample in Hz.
+     @param size The number of samples to tick.
+     
+     @fn void    tCycle_tickBlockPM  (tCycle* const osc, float* const out, const float* const phase, int size)
+     @brief Tick a tCycle oscillator for a block of samples, offsetting the phase of each sample. The offsets don't accumulate, so a block of zeros gives the same output as tCycle_tickBlock().
+     @param osc A pointer to the relevant tCycle.
+     @param out The buffer to write the samples to.
+     @param phase The phase offset of each sample in cycles.
+     @param size The number of samples to tick.
+     
     ￼￼￼
      @} */
     
@@ -79,12 +99,97 @@ extern "C" {
     void    tCycle_free         (tCycle* const osc);
     
     float   tCycle_tick         (tCycle* const osc);
+    void    tCycle_tickBlock    (tCycle* const osc, float* const out, int size);
+    void    tCycle_tickBlockFM  (tCycle* const osc, float* const out, const float* const freq, int size);
+    void    tCycle_tickBlockPM  (tCycle* const osc, float* const out, const float* const phase, int size);
     void    tCycle_setFreq      (tCycle* const osc, float freq);
     void    tCycle_setPhase     (tCycle* const osc, float phase);
     void    tCycle_setSampleRate(tCycle* const osc, float sr);
     
     //==============================================================================
     
+    /*!
+     @defgroup tcyclebank tCycleBank
+     @ingroup oscillators
+     @brief Bank of wavetable sine oscillators, stored so that all of them can be ticked together.
+     @{
+     
+     @fn void    tCycleBank_init         (tCycleBank* const bank, int numVoices, LEAF* const leaf)
+     @brief Initialize a tCycleBank to the default mempool of a LEAF instance.
+     @param bank A pointer to the tCycleBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tCycleBank_initToPool   (tCycleBank* const bank, int numVoices, tMempool* const mempool)
+     @brief Initialize a tCycleBank to a specified mempool.
+     @param bank A pointer to the tCycleBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tCycleBank_free         (tCycleBank* const bank)
+     @brief Free a tCycleBank from its mempool.
+     @param bank A pointer to the tCycleBank to free.
+     
+     @fn void    tCycleBank_tickBlock    (tCycleBank* const bank, float* const out, int size)
+     @brief Tick every oscillator in a tCycleBank for a block of samples and write the sum of their outputs, scaled by their gains.
+     @param bank A pointer to the relevant tCycleBank.
+     @param out The buffer to write the samples to.
+     @param size The number of samples to tick.
+     
+     @fn void    tCycleBank_tickBlockVoices (tCycleBank* const bank, float** const outs, int size)
+     @brief Tick every oscillator in a tCycleBank for a block of samples and write the output of each, scaled by its gain, to a buffer of its own.
+     @param bank A pointer to the relevant tCycleBank.
+     @param outs An array of numVoices buffers to write the samples to.
+     @param size The number of samples to tick.
+     
+     @fn void    tCycleBank_setFreq      (tCycleBank* const bank, int voice, float freq)
+     @brief Set the frequency of one oscillator in a tCycleBank.
+     @param bank A pointer to the relevant tCycleBank.
+     @param voice The index of the oscillator.
+     @param freq The frequency to set the oscillator to.
+     
+     @fn void    tCycleBank_setPhase     (tCycleBank* const bank, int voice, float phase)
+     @brief Set the phase of one oscillator in a tCycleBank.
+     @param bank A pointer to the relevant tCycleBank.
+     @param voice The index of the oscillator.
+     @param phase The phase to set the oscillator to, from 0 to 1.
+     
+     @fn void    tCycleBank_setGain      (tCycleBank* const bank, int voice, float gain)
+     @brief Set the gain of one oscillator in a tCycleBank. Defaults to 1.
+     @param bank A pointer to the relevant tCycleBank.
+     @param voice The index of the oscillator.
+     @param gain The gain of the oscillator.
+     
+     @} */
+    
+    typedef struct _tCycleBank
+    {
+        tMempool mempool;
+        int numVoices;
+        // Underlying phasors, one entry per voice
+        uint32_t* phase;
+        uint32_t* inc;
+        float* freq;
+        float* gain;
+        float invSampleRateTimesTwoTo32;
+        uint32_t mask;
+    } _tCycleBank;
+    
+    typedef _tCycleBank* tCycleBank;
+    
+    void    tCycleBank_init         (tCycleBank* const bank, int numVoices, LEAF* const leaf);
+    void    tCycleBank_initToPool   (tCycleBank* const bank, int numVoices, tMempool* const mempool);
+    void    tCycleBank_free         (tCycleBank* const bank);
+    
+    void    tCycleBank_tickBlock    (tCycleBank* const bank, float* const out, int size);
+    void    tCycleBank_tickBlockVoices (tCycleBank* const bank, float** const outs, int size);
+    void    tCycleBank_setFreq      (tCycleBank* const bank, int voice, float freq);
+    void    tCycleBank_setPhase     (tCycleBank* const bank, int voice, float phase);
+    void    tCycleBank_setGain      (tCycleBank* const bank, int voice, float gain);
+    void    tCycleBank_setSampleRate(tCycleBank* const bank, float sr);
+    
+    //==============================================================================
+    
     /*!
      @defgroup ttriangle tTriangle
      @ingroup oscillators
@@ -265,6 +370,91 @@ extern "C" {
     
     //==============================================================================
     
+    /*!
+     @defgroup tsawbank tSawBank
+     @ingroup oscillators
+     @brief Bank of anti-aliased wavetable sawtooth oscillators, stored so that all of them can be ticked together.
+     @{
+     
+     @fn void    tSawBank_init         (tSawBank* const bank, int numVoices, LEAF* const leaf)
+     @brief Initialize a tSawBank to the default mempool of a LEAF instance.
+     @param bank A pointer to the tSawBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tSawBank_initToPool   (tSawBank* const bank, int numVoices, tMempool* const mempool)
+     @brief Initialize a tSawBank to a specified mempool.
+     @param bank A pointer to the tSawBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tSawBank_free         (tSawBank* const bank)
+     @brief Free a tSawBank from its mempool.
+     @param bank A pointer to the tSawBank to free.
+     
+     @fn void    tSawBank_tickBlock    (tSawBank* const bank, float* const out, int size)
+     @brief Tick every oscillator in a tSawBank for a block of samples and write the sum of their outputs, scaled by their gains.
+     @param bank A pointer to the relevant tSawBank.
+     @param out The buffer to write the samples to.
+     @param size The number of samples to tick.
+     
+     @fn void    tSawBank_tickBlockVoices (tSawBank* const bank, float** const outs, int size)
+     @brief Tick every oscillator in a tSawBank for a block of samples and write the output of each, scaled by its gain, to a buffer of its own.
+     @param bank A pointer to the relevant tSawBank.
+     @param outs An array of numVoices buffers to write the samples to.
+     @param size The number of samples to tick.
+     
+     @fn void    tSawBank_setFreq      (tSawBank* const bank, int voice, float freq)
+     @brief Set the frequency of one oscillator in a tSawBank.
+     @param bank A pointer to the relevant tSawBank.
+     @param voice The index of the oscillator.
+     @param freq The frequency to set the oscillator to.
+     
+     @fn void    tSawBank_setPhase     (tSawBank* const bank, int voice, float phase)
+     @brief Set the phase of one oscillator in a tSawBank.
+     @param bank A pointer to the relevant tSawBank.
+     @param voice The index of the oscillator.
+     @param phase The phase to set the oscillator to, from 0 to 1.
+     
+     @fn void    tSawBank_setGain      (tSawBank* const bank, int voice, float gain)
+     @brief Set the gain of one oscillator in a tSawBank. Defaults to 1.
+     @param bank A pointer to the relevant tSawBank.
+     @param voice The index of the oscillator.
+     @param gain The gain of the oscillator.
+     
+     @} */
+    
+    typedef struct _tSawBank
+    {
+        tMempool mempool;
+        int numVoices;
+        // Underlying phasors and table selection, one entry per voice
+        uint32_t* phase;
+        uint32_t* inc;
+        float* freq;
+        float* gain;
+        int* oct;
+        float* w;
+        float invSampleRate;
+        float invSampleRateTimesTwoTo32;
+        uint32_t mask;
+    } _tSawBank;
+    
+    typedef _tSawBank* tSawBank;
+    
+    void    tSawBank_init           (tSawBank* const bank, int numVoices, LEAF* const leaf);
+    void    tSawBank_initToPool     (tSawBank* const bank, int numVoices, tMempool* const mempool);
+    void    tSawBank_free           (tSawBank* const bank);
+    
+    void    tSawBank_tickBlock      (tSawBank* const bank, float* const out, int size);
+    void    tSawBank_tickBlockVoices(tSawBank* const bank, float** const outs, int size);
+    void    tSawBank_setFreq        (tSawBank* const bank, int voice, float freq);
+    void    tSawBank_setPhase       (tSawBank* const bank, int voice, float phase);
+    void    tSawBank_setGain        (tSawBank* const bank, int voice, float gain);
+    void    tSawBank_setSampleRate  (tSawBank* const bank, float sr);
+    
+    //==============================================================================
+    
     /*!
      @defgroup tpbtriangle tPBTriangle
      @ingroup oscillators
@@ -289,6 +479,12 @@ extern "C" {
      @brief
      @param osc A pointer to the relevant tPBTriangle.
      
+     @fn void    tPBTriangle_tickBlock     (tPBTriangle* const osc, float* const out, int size)
+     @brief Tick a tPBTriangle for a block of samples. The output is identical to calling tPBTriangle_tick() once per sample.
+     @param osc A pointer to the relevant tPBTriangle.
+     @param out The buffer to write the samples to.
+     @param size The number of samples to tick.
+     
      @fn void    tPBTriangle_setFreq       (tPBTriangle* const osc, float freq)
      @brief
      @param osc A pointer to the relevant tPBTriangle.
@@ -302,7 +498,8 @@ extern "C" {
     typedef struct _tPBTriangle
     {
         tMempool mempool;
-        float phase;
+        uint32_t phase;
+        uint32_t phaseInc;
         float inc,freq;
         float skew;
         float lastOut;
@@ -316,6 +513,7 @@ extern "C" {
     void    tPBTriangle_free          (tPBTriangle* const osc);
     
     float   tPBTriangle_tick          (tPBTriangle* const osc);
+    void    tPBTriangle_tickBlock     (tPBTriangle* const osc, float* const out, int size);
     void    tPBTriangle_setFreq       (tPBTriangle* const osc, float freq);
     void    tPBTriangle_setSkew       (tPBTriangle* const osc, float skew);
     void    tPBTriangle_setSampleRate (tPBTriangle* const osc, float sr);
@@ -346,6 +544,12 @@ extern "C" {
      @brief
      @param osc A pointer to the relevant tPBPulse.
      
+     @fn void    tPBPulse_tickBlock   (tPBPulse* const osc, float* const out, int size)
+     @brief Tick a tPBPulse for a block of samples. The output is identical to calling tPBPulse_tick() once per sample.
+     @param osc A pointer to the relevant tPBPulse.
+     @param out The buffer to write the samples to.
+     @param size The number of samples to tick.
+     
      @fn void    tPBPulse_setFreq     (tPBPulse* const osc, float freq)
      @brief
      @param osc A pointer to the relevant tPBPulse.
@@ -359,7 +563,8 @@ extern "C" {
     typedef struct _tPBPulse
     {
         tMempool mempool;
-        float phase;
+        uint32_t phase;
+        uint32_t phaseInc;
         float inc,freq;
         float width;
         float invSampleRate;
@@ -372,6 +577,7 @@ extern "C" {
     void    tPBPulse_free        (tPBPulse* const osc);
     
     float   tPBPulse_tick        (tPBPulse* const osc);
+    void    tPBPulse_tickBlock   (tPBPulse* const osc, float* const out, int size);
     void    tPBPulse_setFreq     (tPBPulse* const osc, float freq);
     void    tPBPulse_setWidth    (tPBPulse* const osc, float width);
     void    tPBPulse_setSampleRate (tPBPulse* const osc, float sr);
@@ -402,6 +608,12 @@ extern "C" {
      @brief
      @param osc A pointer to the relevant tPBSaw.
      
+     @fn void    tPBSaw_tickBlock     (tPBSaw* const osc, float* const out, int size)
+     @brief Tick a tPBSaw for a block of samples. The output is identical to calling tPBSaw_tick() once per sample.
+     @param osc A pointer to the relevant tPBSaw.
+     @param out The buffer to write the samples to.
+     @param size The number of samples to tick.
+     
      @fn void    tPBSaw_setFreq       (tPBSaw* const osc, float freq)
      @brief
      @param osc A pointer to the relevant tPBSaw.
@@ -411,7 +623,8 @@ extern "C" {
     typedef struct _tPBSaw
     {
         tMempool mempool;
-        float phase;
+        uint32_t phase;
+        uint32_t phaseInc;
         float inc,freq;
         float invSampleRate;
     } _tPBSaw;
@@ -423,11 +636,275 @@ extern "C" {
     void    tPBSaw_free          (tPBSaw* const osc);
     
     float   tPBSaw_tick          (tPBSaw* const osc);
+    void    tPBSaw_tickBlock     (tPBSaw* const osc, float* const out, int size);
     void    tPBSaw_setFreq       (tPBSaw* const osc, float freq);
     void    tPBSaw_setSampleRate (tPBSaw* const osc, float sr);
     
     //==============================================================================
     
+    /*!
+     @defgroup tpbsawbank tPBSawBank
+     @ingroup oscillators
+     @brief Bank of sawtooth oscillators with polyBLEP anti-aliasing, stored so that all of them can be ticked together.
+     @{
+     
+     @fn void    tPBSawBank_init         (tPBSawBank* const bank, int numVoices, LEAF* const leaf)
+     @brief Initialize a tPBSawBank to the default mempool of a LEAF instance.
+     @param bank A pointer to the tPBSawBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tPBSawBank_initToPool   (tPBSawBank* const bank, int numVoices, tMempool* const mempool)
+     @brief Initialize a tPBSawBank to a specified mempool.
+     @param bank A pointer to the tPBSawBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tPBSawBank_free         (tPBSawBank* const bank)
+     @brief Free a tPBSawBank from its mempool.
+     @param bank A pointer to the tPBSawBank to free.
+     
+     @fn void    tPBSawBank_tickBlock    (tPBSawBank* const bank, float* const out, int size)
+     @brief Tick every oscillator in a tPBSawBank for a block of samples and write the sum of their outputs, scaled by their gains. Each voice gives the same output as a tPBSaw ticked with tPBSaw_tickBlock().
+     @param bank A pointer to the relevant tPBSawBank.
+     @param out The buffer to write the samples to.
+     @param size The number of samples to tick.
+     
+     @fn void    tPBSawBank_tickBlockVoices (tPBSawBank* const bank, float** const outs, int size)
+     @brief Tick every oscillator in a tPBSawBank for a block of samples and write the output of each, scaled by its gain, to a buffer of its own.
+     @param bank A pointer to the relevant tPBSawBank.
+     @param outs An array of numVoices buffers to write the samples to.
+     @param size The number of samples to tick.
+     
+     @fn void    tPBSawBank_setFreq      (tPBSawBank* const bank, int voice, float freq)
+     @brief Set the frequency of one oscillator in a tPBSawBank.
+     @param bank A pointer to the relevant tPBSawBank.
+     @param voice The index of the oscillator.
+     @param freq The frequency to set the oscillator to.
+     
+     @fn void    tPBSawBank_setPhase     (tPBSawBank* const bank, int voice, float phase)
+     @brief Set the phase of one oscillator in a tPBSawBank.
+     @param bank A pointer to the relevant tPBSawBank.
+     @param voice The index of the oscillator.
+     @param phase The phase to set the oscillator to, from 0 to 1.
+     
+     @fn void    tPBSawBank_setGain      (tPBSawBank* const bank, int voice, float gain)
+     @brief Set the gain of one oscillator in a tPBSawBank. Defaults to 1.
+     @param bank A pointer to the relevant tPBSawBank.
+     @param voice The index of the oscillator.
+     @param gain The gain of the oscillator.
+     
+     @} */
+    
+    typedef struct _tPBSawBank
+    {
+        tMempool mempool;
+        int numVoices;
+        // Oscillator state, one entry per voice
+        uint32_t* phase;
+        uint32_t* phaseInc;
+        float* inc;
+        float* freq;
+        float* gain;
+        float invSampleRate;
+    } _tPBSawBank;
+    
+    typedef _tPBSawBank* tPBSawBank;
+    
+    void    tPBSawBank_init         (tPBSawBank* const bank, int numVoices, LEAF* const leaf);
+    void    tPBSawBank_initToPool   (tPBSawBank* const bank, int numVoices, tMempool* const mempool);
+    void    tPBSawBank_free         (tPBSawBank* const bank);
+    
+    void    tPBSawBank_tickBlock    (tPBSawBank* const bank, float* const out, int size);
+    void    tPBSawBank_tickBlockVoices(tPBSawBank* const bank, float** const outs, int size);
+    void    tPBSawBank_setFreq      (tPBSawBank* const bank, int voice, float freq);
+    void    tPBSawBank_setPhase     (tPBSawBank* const bank, int voice, float phase);
+    void    tPBSawBank_setGain      (tPBSawBank* const bank, int voice, float gain);
+    void    tPBSawBank_setSampleRate(tPBSawBank* const bank, float sr);
+    
+    //==============================================================================
+    
+    /*!
+     @defgroup tpbpulsebank tPBPulseBank
+     @ingroup oscillators
+     @brief Bank of pulse oscillators with polyBLEP anti-aliasing, stored so that all of them can be ticked together.
+     @{
+     
+     @fn void    tPBPulseBank_init         (tPBPulseBank* const bank, int numVoices, LEAF* const leaf)
+     @brief Initialize a tPBPulseBank to the default mempool of a LEAF instance.
+     @param bank A pointer to the tPBPulseBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tPBPulseBank_initToPool   (tPBPulseBank* const bank, int numVoices, tMempool* const mempool)
+     @brief Initialize a tPBPulseBank to a specified mempool.
+     @param bank A pointer to the tPBPulseBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tPBPulseBank_free         (tPBPulseBank* const bank)
+     @brief Free a tPBPulseBank from its mempool.
+     @param bank A pointer to the tPBPulseBank to free.
+     
+     @fn void    tPBPulseBank_tickBlock    (tPBPulseBank* const bank, float* const out, int size)
+     @brief Tick every oscillator in a tPBPulseBank for a block of samples and write the sum of their outputs, scaled by their gains. Each voice gives the same output as a tPBPulse ticked with tPBPulse_tickBlock().
+     @param bank A pointer to the relevant tPBPulseBank.
+     @param out The buffer to write the samples to.
+     @param size The number of samples to tick.
+     
+     @fn void    tPBPulseBank_tickBlockVoices (tPBPulseBank* const bank, float** const outs, int size)
+     @brief Tick every oscillator in a tPBPulseBank for a block of samples and write the output of each, scaled by its gain, to a buffer of its own.
+     @param bank A pointer to the relevant tPBPulseBank.
+     @param outs An array of numVoices buffers to write the samples to.
+     @param size The number of samples to tick.
+     
+     @fn void    tPBPulseBank_setFreq      (tPBPulseBank* const bank, int voice, float freq)
+     @brief Set the frequency of one oscillator in a tPBPulseBank.
+     @param bank A pointer to the relevant tPBPulseBank.
+     @param voice The index of the oscillator.
+     @param freq The frequency to set the oscillator to.
+     
+     @fn void    tPBPulseBank_setWidth    (tPBPulseBank* const bank, int voice, float width)
+     @brief Set the pulse width of one oscillator in a tPBPulseBank, as with tPBPulse_setWidth(). Defaults to 0.5.
+     @param bank A pointer to the relevant tPBPulseBank.
+     @param voice The index of the oscillator.
+     @param width The pulse width, from 0 to 1.
+     
+     @fn void    tPBPulseBank_setPhase     (tPBPulseBank* const bank, int voice, float phase)
+     @brief Set the phase of one oscillator in a tPBPulseBank.
+     @param bank A pointer to the relevant tPBPulseBank.
+     @param voice The index of the oscillator.
+     @param phase The phase to set the oscillator to, from 0 to 1.
+     
+     @fn void    tPBPulseBank_setGain      (tPBPulseBank* const bank, int voice, float gain)
+     @brief Set the gain of one oscillator in a tPBPulseBank. Defaults to 1.
+     @param bank A pointer to the relevant tPBPulseBank.
+     @param voice The index of the oscillator.
+     @param gain The gain of the oscillator.
+     
+     @} */
+    
+    typedef struct _tPBPulseBank
+    {
+        tMempool mempool;
+        int numVoices;
+        // Oscillator state, one entry per voice
+        uint32_t* phase;
+        uint32_t* phaseInc;
+        float* inc;
+        float* freq;
+        float* width;
+        float* gain;
+        float invSampleRate;
+    } _tPBPulseBank;
+    
+    typedef _tPBPulseBank* tPBPulseBank;
+    
+    void    tPBPulseBank_init         (tPBPulseBank* const bank, int numVoices, LEAF* const leaf);
+    void    tPBPulseBank_initToPool   (tPBPulseBank* const bank, int numVoices, tMempool* const mempool);
+    void    tPBPulseBank_free         (tPBPulseBank* const bank);
+    
+    void    tPBPulseBank_tickBlock    (tPBPulseBank* const bank, float* const out, int size);
+    void    tPBPulseBank_tickBlockVoices(tPBPulseBank* const bank, float** const outs, int size);
+    void    tPBPulseBank_setFreq      (tPBPulseBank* const bank, int voice, float freq);
+    void    tPBPulseBank_setWidth   (tPBPulseBank* const bank, int voice, float width);
+    void    tPBPulseBank_setPhase     (tPBPulseBank* const bank, int voice, float phase);
+    void    tPBPulseBank_setGain      (tPBPulseBank* const bank, int voice, float gain);
+    void    tPBPulseBank_setSampleRate(tPBPulseBank* const bank, float sr);
+    
+    //==============================================================================
+    
+    /*!
+     @defgroup tpbtrianglebank tPBTriangleBank
+     @ingroup oscillators
+     @brief Bank of triangle oscillators with polyBLEP anti-aliasing, stored so that all of them can be ticked together.
+     @{
+     
+     @fn void    tPBTriangleBank_init         (tPBTriangleBank* const bank, int numVoices, LEAF* const leaf)
+     @brief Initialize a tPBTriangleBank to the default mempool of a LEAF instance.
+     @param bank A pointer to the tPBTriangleBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tPBTriangleBank_initToPool   (tPBTriangleBank* const bank, int numVoices, tMempool* const mempool)
+     @brief Initialize a tPBTriangleBank to a specified mempool.
+     @param bank A pointer to the tPBTriangleBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tPBTriangleBank_free         (tPBTriangleBank* const bank)
+     @brief Free a tPBTriangleBank from its mempool.
+     @param bank A pointer to the tPBTriangleBank to free.
+     
+     @fn void    tPBTriangleBank_tickBlock    (tPBTriangleBank* const bank, float* const out, int size)
+     @brief Tick every oscillator in a tPBTriangleBank for a block of samples and write the sum of their outputs, scaled by their gains. Each voice gives the same output as a tPBTriangle ticked with tPBTriangle_tickBlock().
+     @param bank A pointer to the relevant tPBTriangleBank.
+     @param out The buffer to write the samples to.
+     @param size The number of samples to tick.
+     
+     @fn void    tPBTriangleBank_tickBlockVoices (tPBTriangleBank* const bank, float** const outs, int size)
+     @brief Tick every oscillator in a tPBTriangleBank for a block of samples and write the output of each, scaled by its gain, to a buffer of its own.
+     @param bank A pointer to the relevant tPBTriangleBank.
+     @param outs An array of numVoices buffers to write the samples to.
+     @param size The number of samples to tick.
+     
+     @fn void    tPBTriangleBank_setFreq      (tPBTriangleBank* const bank, int voice, float freq)
+     @brief Set the frequency of one oscillator in a tPBTriangleBank.
+     @param bank A pointer to the relevant tPBTriangleBank.
+     @param voice The index of the oscillator.
+     @param freq The frequency to set the oscillator to.
+     
+     @fn void    tPBTriangleBank_setSkew  (tPBTriangleBank* const bank, int voice, float skew)
+     @brief Set the skew of one oscillator in a tPBTriangleBank, as with tPBTriangle_setSkew().
+     @param bank A pointer to the relevant tPBTriangleBank.
+     @param voice The index of the oscillator.
+     @param skew The skew, from -1 to 1.
+     
+     @fn void    tPBTriangleBank_setPhase     (tPBTriangleBank* const bank, int voice, float phase)
+     @brief Set the phase of one oscillator in a tPBTriangleBank.
+     @param bank A pointer to the relevant tPBTriangleBank.
+     @param voice The index of the oscillator.
+     @param phase The phase to set the oscillator to, from 0 to 1.
+     
+     @fn void    tPBTriangleBank_setGain      (tPBTriangleBank* const bank, int voice, float gain)
+     @brief Set the gain of one oscillator in a tPBTriangleBank. Defaults to 1.
+     @param bank A pointer to the relevant tPBTriangleBank.
+     @param voice The index of the oscillator.
+     @param gain The gain of the oscillator.
+     
+     @} */
+    
+    typedef struct _tPBTriangleBank
+    {
+        tMempool mempool;
+        int numVoices;
+        // Oscillator state, one entry per voice
+        uint32_t* phase;
+        uint32_t* phaseInc;
+        float* inc;
+        float* freq;
+        float* skew;
+        float* lastOut;
+        float* gain;
+        float invSampleRate;
+    } _tPBTriangleBank;
+    
+    typedef _tPBTriangleBank* tPBTriangleBank;
+    
+    void    tPBTriangleBank_init         (tPBTriangleBank* const bank, int numVoices, LEAF* const leaf);
+    void    tPBTriangleBank_initToPool   (tPBTriangleBank* const bank, int numVoices, tMempool* const mempool);
+    void    tPBTriangleBank_free         (tPBTriangleBank* const bank);
+    
+    void    tPBTriangleBank_tickBlock    (tPBTriangleBank* const bank, float* const out, int size);
+    void    tPBTriangleBank_tickBlockVoices(tPBTriangleBank* const bank, float** const outs, int size);
+    void    tPBTriangleBank_setFreq      (tPBTriangleBank* const bank, int voice, float freq);
+    void    tPBTriangleBank_setSkew (tPBTriangleBank* const bank, int voice, float skew);
+    void    tPBTriangleBank_setPhase     (tPBTriangleBank* const bank, int voice, float phase);
+    void    tPBTriangleBank_setGain      (tPBTriangleBank* const bank, int voice, float gain);
+    void    tPBTriangleBank_setSampleRate(tPBTriangleBank* const bank, float sr);
+    
+    //==============================================================================
+    
     /*!
      @defgroup tphasor tPhasor
      @ingroup oscillators
@@ -503,6 +980,22 @@ extern "C" {
      @fn float   tNoise_tick         (tNoise* const noise)
      @brief
      @param noise A pointer to the relevant tNoise.
+     
+     @fn void    tNoise_tickBlock    (tNoise* const noise, float* const out, int size)
+     @brief Tick a tNoise for a block of samples. The output is identical to calling tNoise_tick() for each sample. With the built-in generator the white noise for the whole block is made in one pass that the compiler can vectorize.
+     @param noise A pointer to the relevant tNoise.
+     @param out The buffer to write the samples to.
+     @param size The number of samples to tick.
+     
+     @fn void    tNoise_setSeed      (tNoise* const noise, uint32_t seed)
+     @brief Switch a tNoise to its built-in random number generator, starting from the given seed. The built-in generator is much cheaper than calling the random() function of the LEAF instance for every sample, and gives the same sequence for the same seed.
+     @param noise A pointer to the relevant tNoise.
+     @param seed The seed. Noise made with different seeds is uncorrelated.
+     
+     @fn void    tNoise_setRandom    (tNoise* const noise, float (*random)(void))
+     @brief Switch a tNoise to getting its random numbers from a function, as it does by default with the random() function of the LEAF instance. Useful with a hardware random number generator.
+     @param noise A pointer to the relevant tNoise.
+     @param random A function returning random numbers from 0 to 1.
      */
     
     /* tNoise. WhiteNoise, PinkNoise. */
@@ -527,6 +1020,8 @@ extern "C" {
         NoiseType type;
         float pinkb0, pinkb1, pinkb2;
         float(*rand)(void);
+        // State of the built-in generator, used when rand is NULL
+        uint32_t state;
     } _tNoise;
     
     typedef _tNoise* tNoise;
@@ -536,6 +1031,9 @@ extern "C" {
     void    tNoise_free         (tNoise* const noise);
     
     float   tNoise_tick         (tNoise* const noise);
+    void    tNoise_tickBlock    (tNoise* const noise, float* const out, int size);
+    void    tNoise_setSeed      (tNoise* const noise, uint32_t seed);
+    void    tNoise_setRandom    (tNoise* const noise, float (*random)(void));
     
     //==============================================================================
     
@@ -698,6 +1196,14 @@ extern "C" {
      @brief
      @param osc A pointer to the relevant tMBPulse.
      
+     @fn void tMBPulse_tickBlock(tMBPulse* const osc, float* const out, const float* const freq, const float* const sync, int size)
+     @brief Tick the oscillator for a block of samples. The output is identical to calling tMBPulse_sync() (when a sync buffer is given) and tMBPulse_tick() once per sample, including in soft sync mode.
+     @param osc A pointer to the relevant tMBPulse.
+     @param out The buffer to write the samples to.
+     @param freq The frequency of each sample in Hz, or NULL to use the frequency set with tMBPulse_setFreq(), which is left as it is either way.
+     @param sync The sync input of each sample, or NULL to keep the current sync state.
+     @param size The number of samples to tick.
+     
      @fn void tMBPulse_setFreq(tMBPulse* const osc, float f)
      @brief
      @param osc A pointer to the relevant tMBPulse.
@@ -743,6 +1249,7 @@ extern "C" {
     void tMBPulse_free(tMBPulse* const osc);
     
     float tMBPulse_tick(tMBPulse* const osc);
+    void tMBPulse_tickBlock(tMBPulse* const osc, float* const out, const float* const freq, const float* const sync, int size);
     void tMBPulse_setFreq(tMBPulse* const osc, float f);
     void tMBPulse_setWidth(tMBPulse* const osc, float w);
     float tMBPulse_sync(tMBPulse* const osc, float sync);
@@ -772,6 +1279,14 @@ extern "C" {
      @brief
      @param osc A pointer to the relevant tMBTriangle.
      
+     @fn void tMBTriangle_tickBlock(tMBTriangle* const osc, float* const out, const float* const freq, const float* const sync, int size)
+     @brief Tick the oscillator for a block of samples. The output is identical to calling tMBTriangle_sync() (when a sync buffer is given) and tMBTriangle_tick() once per sample, including in soft sync mode.
+     @param osc A pointer to the relevant tMBTriangle.
+     @param out The buffer to write the samples to.
+     @param freq The frequency of each sample in Hz, or NULL to use the frequency set with tMBTriangle_setFreq(), which is left as it is either way.
+     @param sync The sync input of each sample, or NULL to keep the current sync state.
+     @param size The number of samples to tick.
+     
      @fn void tMBTriangle_setFreq(tMBTriangle* const osc, float f)
      @brief
      @param osc A pointer to the relevant tMBTriangle.
@@ -817,6 +1332,7 @@ extern "C" {
     void tMBTriangle_free(tMBTriangle* const osc);
     
     float tMBTriangle_tick(tMBTriangle* const osc);
+    void tMBTriangle_tickBlock(tMBTriangle* const osc, float* const out, const float* const freq, const float* const sync, int size);
     void tMBTriangle_setFreq(tMBTriangle* const osc, float f);
     void tMBTriangle_setWidth(tMBTriangle* const osc, float w);
     float tMBTriangle_sync(tMBTriangle* const osc, float sync);
@@ -848,6 +1364,14 @@ extern "C" {
      @param osc A pointer to the relevant tMBSaw.
      @return The ticked sample.
      
+     @fn void tMBSaw_tickBlock(tMBSaw* const osc, float* const out, const float* const freq, const float* const sync, int size)
+     @brief Tick the oscillator for a block of samples. The output is identical to calling tMBSaw_sync() (when a sync buffer is given) and tMBSaw_tick() once per sample, including in soft sync mode.
+     @param osc A pointer to the relevant tMBSaw.
+     @param out The buffer to write the samples to.
+     @param freq The frequency of each sample in Hz, or NULL to use the frequency set with tMBSaw_setFreq(), which is left as it is either way.
+     @param sync The sync input of each sample, or NULL to keep the current sync state.
+     @param size The number of samples to tick.
+     
      @fn void tMBSaw_setFreq(tMBSaw* const osc, float f)
      @brief Set the frequency of the oscillator.
      @param osc A pointer to the relevant tMBSaw.
@@ -890,12 +1414,209 @@ extern "C" {
     void tMBSaw_free(tMBSaw* const osc);
     
     float tMBSaw_tick(tMBSaw* const osc);
+    void tMBSaw_tickBlock(tMBSaw* const osc, float* const out, const float* const freq, const float* const sync, int size);
     void tMBSaw_setFreq(tMBSaw* const osc, float f);
     float tMBSaw_sync(tMBSaw* const osc, float sync);
     void tMBSaw_setPhase(tMBSaw* const osc, float phase);
     void tMBSaw_setSyncMode(tMBSaw* const osc, int hardOrSoft);
     void tMBSaw_setSampleRate (tMBSaw* const osc, float sr);
     
+    /*!
+     @defgroup tmbsawbank tMBSawBank
+     @ingroup oscillators
+     @brief Bank of minBLEP sawtooth oscillators that are rendered together, with their residual buffers laid out one after another and advanced in step.
+     @{
+     
+     @fn void tMBSawBank_init(tMBSawBank* const bank, int numVoices, LEAF* const leaf)
+     @brief Initialize a tMBSawBank to the default mempool of a LEAF instance.
+     @param bank A pointer to the tMBSawBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void tMBSawBank_initToPool(tMBSawBank* const bank, int numVoices, tMempool* const mempool)
+     @brief Initialize a tMBSawBank to a specified mempool.
+     @param bank A pointer to the tMBSawBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void tMBSawBank_free(tMBSawBank* const bank)
+     @brief Free a tMBSawBank from its mempool.
+     @param bank A pointer to the tMBSawBank to free.
+     
+     @fn void tMBSawBank_tickBlock(tMBSawBank* const bank, float* const out, const float* const sync, int size)
+     @brief Tick every oscillator in a tMBSawBank for a block of samples and write the sum of their outputs, scaled by their gains. Each voice gives the same output as a tMBSaw ticked with tMBSaw_tickBlock().
+     @param bank A pointer to the relevant tMBSawBank.
+     @param out The buffer to write the samples to.
+     @param sync The sync input of each sample, shared by all voices, or NULL for no sync.
+     @param size The number of samples to tick.
+     
+     @fn void tMBSawBank_tickBlockVoices(tMBSawBank* const bank, float** const outs, const float* const sync, int size)
+     @brief Tick every oscillator in a tMBSawBank for a block of samples and write the output of each, scaled by its gain, to a buffer of its own.
+     @param bank A pointer to the relevant tMBSawBank.
+     @param outs An array of numVoices buffers to write the samples to.
+     @param sync The sync input of each sample, shared by all voices, or NULL for no sync.
+     @param size The number of samples to tick.
+     
+     @fn void tMBSawBank_setFreq(tMBSawBank* const bank, int voice, float freq)
+     @brief Set the frequency of one oscillator in a tMBSawBank.
+     @param bank A pointer to the relevant tMBSawBank.
+     @param voice The index of the oscillator.
+     @param freq The frequency to set the oscillator to.
+     
+     @fn void tMBSawBank_setPhase(tMBSawBank* const bank, int voice, float phase)
+     @brief Set the phase of one oscillator in a tMBSawBank.
+     @param bank A pointer to the relevant tMBSawBank.
+     @param voice The index of the oscillator.
+     @param phase The phase to set the oscillator to, from 0 to 1.
+     
+     @fn void tMBSawBank_setGain(tMBSawBank* const bank, int voice, float gain)
+     @brief Set the gain of one oscillator in a tMBSawBank. Defaults to 1.
+     @param bank A pointer to the relevant tMBSawBank.
+     @param voice The index of the oscillator.
+     @param gain The gain of the oscillator.
+     
+     @fn void tMBSawBank_setSyncMode(tMBSawBank* const bank, int hardOrSoft)
+     @brief Set the sync behavior of every oscillator in the bank.
+     @param hardOrSoft 0 for hard sync, 1 for soft sync
+     
+     @} */
+    
+    typedef struct _tMBSawBank
+    {
+        tMempool mempool;
+        int numVoices;
+        // Oscillator state, one entry per voice
+        float* freq;
+        float* gain;
+        float* phase;
+        float* z;
+        // Residual buffers, stride floats apart, sharing one write position j
+        float* buffer;
+        int stride;
+        int j;
+        float lastsyncin;
+        float syncdir;
+        int softsync;
+        float invSampleRate;
+    } _tMBSawBank;
+    
+    typedef _tMBSawBank* tMBSawBank;
+    
+    void tMBSawBank_init(tMBSawBank* const bank, int numVoices, LEAF* const leaf);
+    void tMBSawBank_initToPool(tMBSawBank* const bank, int numVoices, tMempool* const mempool);
+    void tMBSawBank_free(tMBSawBank* const bank);
+    
+    void tMBSawBank_tickBlock(tMBSawBank* const bank, float* const out, const float* const sync, int size);
+    void tMBSawBank_tickBlockVoices(tMBSawBank* const bank, float** const outs, const float* const sync, int size);
+    void tMBSawBank_setFreq(tMBSawBank* const bank, int voice, float freq);
+    void tMBSawBank_setPhase(tMBSawBank* const bank, int voice, float phase);
+    void tMBSawBank_setGain(tMBSawBank* const bank, int voice, float gain);
+    void tMBSawBank_setSyncMode(tMBSawBank* const bank, int hardOrSoft);
+    void tMBSawBank_setSampleRate(tMBSawBank* const bank, float sr);
+    
+    /*!
+     @defgroup tmbpulsebank tMBPulseBank
+     @ingroup oscillators
+     @brief Bank of minBLEP pulse oscillators that are rendered together, laid out the same way as tMBSawBank.
+     @{
+     
+     @fn void tMBPulseBank_init(tMBPulseBank* const bank, int numVoices, LEAF* const leaf)
+     @brief Initialize a tMBPulseBank to the default mempool of a LEAF instance.
+     @param bank A pointer to the tMBPulseBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void tMBPulseBank_initToPool(tMBPulseBank* const bank, int numVoices, tMempool* const mempool)
+     @brief Initialize a tMBPulseBank to a specified mempool.
+     @param bank A pointer to the tMBPulseBank to initialize.
+     @param numVoices The number of oscillators in the bank.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void tMBPulseBank_free(tMBPulseBank* const bank)
+     @brief Free a tMBPulseBank from its mempool.
+     @param bank A pointer to the tMBPulseBank to free.
+     
+     @fn void tMBPulseBank_tickBlock(tMBPulseBank* const bank, float* const out, const float* const sync, int size)
+     @brief Tick every oscillator in a tMBPulseBank for a block of samples and write the sum of their outputs, scaled by their gains. Each voice gives the same output as a tMBPulse ticked with tMBPulse_tickBlock().
+     @param bank A pointer to the relevant tMBPulseBank.
+     @param out The buffer to write the samples to.
+     @param sync The sync input of each sample, shared by all voices, or NULL for no sync.
+     @param size The number of samples to tick.
+     
+     @fn void tMBPulseBank_tickBlockVoices(tMBPulseBank* const bank, float** const outs, const float* const sync, int size)
+     @brief Tick every oscillator in a tMBPulseBank for a block of samples and write the output of each, scaled by its gain, to a buffer of its own.
+     @param bank A pointer to the relevant tMBPulseBank.
+     @param outs An array of numVoices buffers to write the samples to.
+     @param sync The sync input of each sample, shared by all voices, or NULL for no sync.
+     @param size The number of samples to tick.
+     
+     @fn void tMBPulseBank_setFreq(tMBPulseBank* const bank, int voice, float freq)
+     @brief Set the frequency of one oscillator in a tMBPulseBank.
+     @param bank A pointer to the relevant tMBPulseBank.
+     @param voice The index of the oscillator.
+     @param freq The frequency to set the oscillator to.
+     
+     @fn void tMBPulseBank_setWidth(tMBPulseBank* const bank, int voice, float width)
+     @brief Set the pulse width of one oscillator in a tMBPulseBank, as in tMBPulse_setWidth().
+     @param bank A pointer to the relevant tMBPulseBank.
+     @param voice The index of the oscillator.
+     @param width The width, from -1 to 1.
+     
+     @fn void tMBPulseBank_setPhase(tMBPulseBank* const bank, int voice, float phase)
+     @brief Set the phase of one oscillator in a tMBPulseBank.
+     @param bank A pointer to the relevant tMBPulseBank.
+     @param voice The index of the oscillator.
+     @param phase The phase to set the oscillator to, from 0 to 1.
+     
+     @fn void tMBPulseBank_setGain(tMBPulseBank* const bank, int voice, float gain)
+     @brief Set the gain of one oscillator in a tMBPulseBank. Defaults to 1.
+     @param bank A pointer to the relevant tMBPulseBank.
+     @param voice The index of the oscillator.
+     @param gain The gain of the oscillator.
+     
+     @fn void tMBPulseBank_setSyncMode(tMBPulseBank* const bank, int hardOrSoft)
+     @brief Set the sync behavior of every oscillator in the bank.
+     @param hardOrSoft 0 for hard sync, 1 for soft sync
+     
+     @} */
+    
+    typedef struct _tMBPulseBank
+    {
+        tMempool mempool;
+        int numVoices;
+        // Oscillator state, one entry per voice
+        float* freq;
+        float* gain;
+        float* width;
+        float* phase;
+        float* x;
+        float* z;
+        int* k;
+        // Residual buffers, stride floats apart, sharing one write position j
+        float* buffer;
+        int stride;
+        int j;
+        float lastsyncin;
+        float syncdir;
+        int softsync;
+        float invSampleRate;
+    } _tMBPulseBank;
+    
+    typedef _tMBPulseBank* tMBPulseBank;
+    
+    void tMBPulseBank_init(tMBPulseBank* const bank, int numVoices, LEAF* const leaf);
+    void tMBPulseBank_initToPool(tMBPulseBank* const bank, int numVoices, tMempool* const mempool);
+    void tMBPulseBank_free(tMBPulseBank* const bank);
+    
+    void tMBPulseBank_tickBlock(tMBPulseBank* const bank, float* const out, const float* const sync, int size);
+    void tMBPulseBank_tickBlockVoices(tMBPulseBank* const bank, float** const outs, const float* const sync, int size);
+    void tMBPulseBank_setFreq(tMBPulseBank* const bank, int voice, float freq);
+    void tMBPulseBank_setWidth(tMBPulseBank* const bank, int voice, float width);
+    void tMBPulseBank_setPhase(tMBPulseBank* const bank, int voice, float phase);
+    void tMBPulseBank_setGain(tMBPulseBank* const bank, int voice, float gain);
+    void tMBPulseBank_setSyncMode(tMBPulseBank* const bank, int hardOrSoft);
+    void tMBPulseBank_setSampleRate(tMBPulseBank* const bank, float sr);
+    
     //==============================================================================
     
     /*!
@@ -957,6 +1678,42 @@ extern "C" {
     
     //==============================================================================
     
+    /*!
+     @ingroup oscillators
+     @brief Storage formats for the band-limited levels of a tWaveTable or tWaveTableS.
+     */
+    enum WaveTableFormat
+    {
+        WaveTableFloat, //!< 32-bit float. The default.
+        WaveTableInt16, //!< 16-bit fixed point with 14 fractional bits, covering -2 to 2 so the overshoot at band-limited edges fits. Half the memory of WaveTableFloat.
+        WaveTableHalf, //!< IEEE 754 half-precision float. Half the memory of WaveTableFloat, with 11 bits of precision at any level.
+        WaveTableFormatNil
+    };
+    
+    typedef enum WaveTableFormat WaveTableFormat;
+    
+#define LEAF_WAVETABLE_DATA_MAGIC 0x5446574c // "LWFT"
+#define LEAF_WAVETABLE_DATA_VERSION 1
+    
+    /*!
+     @ingroup oscillators
+     @brief Header of the serialized form of a tWaveTable or tWaveTableS, as written by tWaveTable_writeToMemory() and tWaveTableS_writeToMemory(). The levels follow one after another, from the full bandwidth one down, starting dataOffset bytes from the start of the header. Values are in the byte order of the machine that wrote them.
+     */
+    typedef struct WaveTableDataHeader
+    {
+        uint32_t magic; //!< LEAF_WAVETABLE_DATA_MAGIC.
+        uint16_t version; //!< LEAF_WAVETABLE_DATA_VERSION.
+        uint8_t format; //!< The WaveTableFormat of the levels.
+        uint8_t halving; //!< 1 if each level is half the size of the one before it, down to 128 samples, as in tWaveTableS. 0 if they are all the same size, as in tWaveTable.
+        uint32_t size; //!< The number of samples in the first level.
+        uint32_t numTables; //!< The number of levels.
+        float sampleRate; //!< The sample rate the levels were made for.
+        float baseFreq; //!< The frequency the first level plays at when stepping through it one sample at a time, at that sample rate.
+        float maxFreq; //!< The maximum frequency of the table.
+        uint32_t dataOffset; //!< Offset in bytes from the start of the header to the first level.
+        uint32_t reserved[8];
+    } WaveTableDataHeader;
+    
     /*!
      @defgroup twavetable tWaveTable
      @ingroup oscillators
@@ -979,8 +1736,90 @@ extern "C" {
      @param maxFreq The maximum expected frequency of the oscillator. The higher this is, the more memory will be needed.
      @param mempool A pointer to the tMempool to use.
      
+     @fn void    tWaveTable_initShared   (tWaveTable* const osc, float* table, int size, float maxFreq, LEAF* const leaf)
+     @brief Initialize a tWaveTable that is shared with any other tWaveTable made from the same data with this function. If one already exists for the same table contents, size, maximum frequency and sample rate, it is handed out again instead of being built. Shared tables are allocated from the default mempool of the LEAF instance, must be treated as read-only, and are only freed once every holder has called tWaveTable_free(). Calling tWaveTable_setSampleRate() on a shared table that others still hold gives this holder a table of its own at the new rate and leaves the others unchanged.
+     @param osc A pointer to the tWaveTable to initialize.
+     @param table A pointer to the wavetable data.
+     @param size The number of samples in the wavetable.
+     @param maxFreq The maximum expected frequency of the oscillator. The higher this is, the more memory will be needed.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tWaveTable_initCompact   (tWaveTable* const osc, float* table, int size, float maxFreq, WaveTableFormat format, LEAF* const leaf)
+     @brief Initialize a tWaveTable to the default mempool of a LEAF instance, keeping its levels in a compact format. The levels are built at full precision and then converted, and are converted back to float as they are read by a tWaveOsc.
+     @param osc A pointer to the tWaveTable to initialize.
+     @param table A pointer to the wavetable data.
+     @param size The number of samples in the wavetable.
+     @param maxFreq The maximum expected frequency of the oscillator. The higher this is, the more memory will be needed.
+     @param format The format to store the levels in. WaveTableFloat is the same as tWaveTable_init().
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tWaveTable_initCompactToPool   (tWaveTable* const osc, float* table, int size, float maxFreq, WaveTableFormat format, tMempool* const mempool)
+     @brief Initialize a tWaveTable to a specified mempool, keeping its levels in a compact format.
+     @param osc A pointer to the tWaveTable to initialize.
+     @param table A pointer to the wavetable data.
+     @param size The number of samples in the wavetable.
+     @param maxFreq The maximum expected frequency of the oscillator. The higher this is, the more memory will be needed.
+     @param format The format to store the levels in.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tWaveTable_initFromData   (tWaveTable* const osc, const void* data, int size, int numTables, WaveTableFormat format, LEAF* const leaf)
+     @brief Initialize a tWaveTable to the default mempool of a LEAF instance from levels that were built ahead of time, such as the tables of another tWaveTable made at the same sample rate. The levels are copied, so the data need not outlive the tWaveTable.
+     @param osc A pointer to the tWaveTable to initialize.
+     @param data The levels, one after another from the full bandwidth one down, each of size samples in the given format.
+     @param size The number of samples in each level. Must be a power of two.
+     @param numTables The number of levels in the data, at least 2. The maximum frequency of the tWaveTable follows from this.
+     @param format The format of the data, which is also the format the levels are kept in.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tWaveTable_initFromDataToPool   (tWaveTable* const osc, const void* data, int size, int numTables, WaveTableFormat format, tMempool* const mempool)
+     @brief Initialize a tWaveTable to a specified mempool from levels that were built ahead of time.
+     @param osc A pointer to the tWaveTable to initialize.
+     @param data The levels, one after another from the full bandwidth one down, each of size samples in the given format.
+     @param size The number of samples in each level. Must be a power of two.
+     @param numTables The number of levels in the data, at least 2.
+     @param format The format of the data.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tWaveTable_initFromLevels   (tWaveTable* const osc, const void* levels, int size, int numTables, WaveTableFormat format, LEAF* const leaf)
+     @brief Initialize a tWaveTable to the default mempool of a LEAF instance that reads its levels in place, without copying them. The levels are never written to, so they can be const or in read-only memory, but must outlive the tWaveTable. This also covers the built-in band-limited sets, as in tWaveTable_initFromLevels(&saw, __leaf_table_sawtooth, SAW_TABLE_SIZE, 11, WaveTableFloat, leaf).
+     @param osc A pointer to the tWaveTable to initialize.
+     @param levels The levels, one after another from the full bandwidth one down, each of size samples in the given format.
+     @param size The number of samples in each level. Must be a power of two.
+     @param numTables The number of levels, at least 2.
+     @param format The format of the levels.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tWaveTable_initFromLevelsToPool   (tWaveTable* const osc, const void* levels, int size, int numTables, WaveTableFormat format, tMempool* const mempool)
+     @brief Initialize a tWaveTable to a specified mempool that reads its levels in place, without copying them.
+     @param osc A pointer to the tWaveTable to initialize.
+     @param levels The levels, one after another from the full bandwidth one down, each of size samples in the given format.
+     @param size The number of samples in each level. Must be a power of two.
+     @param numTables The number of levels, at least 2.
+     @param format The format of the levels.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tWaveTable_initFromMemory   (tWaveTable* const osc, const void* data, size_t length, LEAF* const leaf)
+     @brief Initialize a tWaveTable to the default mempool of a LEAF instance from data written by tWaveTable_writeToMemory(), such as a const array built into the program or a memory mapped file. The levels are read in place as with tWaveTable_initFromLevels(), unless the data was made at another sample rate, in which case they are rebuilt as with tWaveTable_setSampleRate(). If the data is not valid, or is shorter than its header says, a LEAFInvalidData error is raised and the tWaveTable is left silent.
+     @param osc A pointer to the tWaveTable to initialize.
+     @param data The data, starting with a WaveTableDataHeader. Must be aligned to at least 4 bytes.
+     @param length The size of the data in bytes, as returned by the writeToMemory function that wrote it. Data too short for the levels its header describes is not valid.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tWaveTable_initFromMemoryToPool   (tWaveTable* const osc, const void* data, size_t length, tMempool* const mempool)
+     @brief Initialize a tWaveTable to a specified mempool from data written by tWaveTable_writeToMemory().
+     @param osc A pointer to the tWaveTable to initialize.
+     @param data The data, starting with a WaveTableDataHeader. Must be aligned to at least 4 bytes.
+     @param length The size of the data in bytes, as returned by the writeToMemory function that wrote it. Data too short for the levels its header describes is not valid.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn size_t  tWaveTable_writeToMemory   (tWaveTable* const osc, void* data)
+     @brief Write a tWaveTable in the format read by tWaveTable_initFromMemory(), a WaveTableDataHeader followed by the levels in the format they are kept in. Levels start on a 64 byte boundary from the start of the data, provided they are at least 64 bytes long.
+     @param osc A pointer to the relevant tWaveTable.
+     @param data The memory to write to, or NULL to only get the size needed.
+     @return The size of the data in bytes.
+     
      @fn void    tWaveTable_free         (tWaveTable* const osc)
-     @brief Free a tWaveTable from its mempool.
+     @brief Free a tWaveTable from its mempool, or release this holder's reference to it if it is shared.
      @param osc A pointer to the tWaveTable to free.
      
      @} */
@@ -993,6 +1832,11 @@ extern "C" {
         
         float* baseTable;
         float** tables;
+        // Levels kept in a compact format instead of tables, see tWaveTable_initCompact()
+        WaveTableFormat format;
+        int16_t** compactTables;
+        // Set when the levels are read in place, see tWaveTable_initFromLevels()
+        int externalLevels;
         int size;
         int sizeMask;
         int numTables;
@@ -1000,6 +1844,11 @@ extern "C" {
         float baseFreq, invBaseFreq;
         tButterworth bl;
         float sampleRate;
+        // Sharing, see tWaveTable_initShared()
+        int refCount;
+        int shared;
+        uint32_t hash;
+        struct _tWaveTable* nextShared;
     } _tWaveTable;
     
     typedef _tWaveTable* tWaveTable;
@@ -1008,6 +1857,23 @@ extern "C" {
                             float maxFreq, LEAF* const leaf);
     void    tWaveTable_initToPool(tWaveTable* const osc, float* table, int size,
                                   float maxFreq, tMempool* const mempool);
+    void    tWaveTable_initShared(tWaveTable* const osc, float* table, int size,
+                                  float maxFreq, LEAF* const leaf);
+    void    tWaveTable_initCompact(tWaveTable* const osc, float* table, int size,
+                                   float maxFreq, WaveTableFormat format, LEAF* const leaf);
+    void    tWaveTable_initCompactToPool(tWaveTable* const osc, float* table, int size,
+                                         float maxFreq, WaveTableFormat format, tMempool* const mempool);
+    void    tWaveTable_initFromData(tWaveTable* const osc, const void* data, int size,
+                                    int numTables, WaveTableFormat format, LEAF* const leaf);
+    void    tWaveTable_initFromDataToPool(tWaveTable* const osc, const void* data, int size,
+                                          int numTables, WaveTableFormat format, tMempool* const mempool);
+    void    tWaveTable_initFromLevels(tWaveTable* const osc, const void* levels, int size,
+                                      int numTables, WaveTableFormat format, LEAF* const leaf);
+    void    tWaveTable_initFromLevelsToPool(tWaveTable* const osc, const void* levels, int size,
+                                            int numTables, WaveTableFormat format, tMempool* const mempool);
+    void    tWaveTable_initFromMemory(tWaveTable* const osc, const void* data, size_t length, LEAF* const leaf);
+    void    tWaveTable_initFromMemoryToPool(tWaveTable* const osc, const void* data, size_t length, tMempool* const mempool);
+    size_t  tWaveTable_writeToMemory(tWaveTable* const osc, void* data);
     void    tWaveTable_free(tWaveTable* const osc);
     void    tWaveTable_setSampleRate (tWaveTable* const osc, float sr);
     
@@ -1035,6 +1901,15 @@ extern "C" {
      @param maxFreq The maximum expected frequency of the oscillator. The higher this is, the more memory will be needed.
      @param mempool A pointer to the tMempool to use.
      
+     @fn void    tWaveOsc_initShared(tWaveOsc* const osc, float** tables, int n, int size, float maxFreq, LEAF* const leaf)
+     @brief Initialize a tWaveOsc to the default mempool of a LEAF instance, with tWaveTables made by tWaveTable_initShared(). Oscillators made this way from the same data all read from one set of tables, which are released again when the oscillator is freed.
+     @param osc A pointer to the tWaveOsc to initialize.
+     @param tables An array of pointers to wavetable data.
+     @param n The number of wavetables.
+     @param size The number of samples in each of the wavetables.
+     @param maxFreq The maximum expected frequency of the oscillator. The higher this is, the more memory will be needed.
+     @param leaf A pointer to the leaf instance.
+     
      @fn void    tWaveOsc_free         (tWaveOsc* const osc)
      @brief Free a tWaveOsc from its mempool.
      @param osc A pointer to the tWaveOsc to free.
@@ -1044,6 +1919,14 @@ extern "C" {
      @param osc A pointer to the relevant tWaveOsc.
      @return The ticked sample as a float from -1 to 1.
      
+     @fn void    tWaveOsc_tickBlock    (tWaveOsc* const osc, float* const out, const float* const freq, const float* const index, int size)
+     @brief Tick a tWaveOsc oscillator for a block of samples. The output is identical to calling tWaveOsc_setFreq() and tWaveOsc_setIndex() with each sample of the given buffers and then tWaveOsc_tick(), and the last frequency and index given stay set. Without either buffer the tables are picked once for the whole block.
+     @param osc A pointer to the relevant tWaveOsc.
+     @param out The buffer to write the samples to.
+     @param freq The frequency of each sample in Hz, or NULL to keep the current frequency.
+     @param index The index of each sample, as in tWaveOsc_setIndex(), or NULL to keep the current index.
+     @param size The number of samples to tick.
+     
      @fn void    tWaveOsc_setFreq      (tWaveOsc* const osc, float freq)
      @brief Set the frequency of a tWaveOsc oscillator.
      @param osc A pointer to the relevant tWaveOsc.
@@ -1079,6 +1962,8 @@ extern "C" {
            float w;
            float aa;
            int numSubTables;
+           // Set when the tables came from tWaveOsc_initShared() and are released on free
+           int ownsTables;
 
        } _tWaveOsc;
     
@@ -1086,9 +1971,11 @@ extern "C" {
     
     void tWaveOsc_init(tWaveOsc* const cy, tWaveTable* tables, int numTables, LEAF* const leaf);
     void tWaveOsc_initToPool(tWaveOsc* const cy, tWaveTable* tables, int numTables, tMempool* const mp);
+    void tWaveOsc_initShared(tWaveOsc* const cy, float** tables, int numTables, int size, float maxFreq, LEAF* const leaf);
     void    tWaveOsc_free(tWaveOsc* const osc);
     
     float   tWaveOsc_tick(tWaveOsc* const osc);
+    void    tWaveOsc_tickBlock(tWaveOsc* const osc, float* const out, const float* const freq, const float* const index, int size);
     void 	tWaveOsc_setFreq(tWaveOsc* const cy, float freq);
     void    tWaveOsc_setAntiAliasing(tWaveOsc* const osc, float aa);
     void    tWaveOsc_setIndex(tWaveOsc* const osc, float index);
@@ -1119,8 +2006,90 @@ extern "C" {
      @param maxFreq The maximum expected frequency of the oscillator. The higher this is, the more memory will be needed.
      @param mempool A pointer to the tMempool to use.
      
+     @fn void    tWaveTableS_initShared   (tWaveTableS* const osc, float* table, int size, float maxFreq, LEAF* const leaf)
+     @brief Initialize a tWaveTableS that is shared with any other tWaveTableS made from the same data with this function, as with tWaveTable_initShared().
+     @param osc A pointer to the tWaveTableS to initialize.
+     @param table A pointer to the wavetable data.
+     @param size The number of samples in the wavetable.
+     @param maxFreq The maximum expected frequency of the oscillator. The higher this is, the more memory will be needed.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tWaveTableS_initCompact   (tWaveTableS* const osc, float* table, int size, float maxFreq, WaveTableFormat format, LEAF* const leaf)
+     @brief Initialize a tWaveTableS to the default mempool of a LEAF instance, keeping its levels in a compact format, as with tWaveTable_initCompact().
+     @param osc A pointer to the tWaveTableS to initialize.
+     @param table A pointer to the wavetable data.
+     @param size The number of samples in the wavetable.
+     @param maxFreq The maximum expected frequency of the oscillator. The higher this is, the more memory will be needed.
+     @param format The format to store the levels in. WaveTableFloat is the same as tWaveTableS_init().
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tWaveTableS_initCompactToPool   (tWaveTableS* const osc, float* table, int size, float maxFreq, WaveTableFormat format, tMempool* const mempool)
+     @brief Initialize a tWaveTableS to a specified mempool, keeping its levels in a compact format.
+     @param osc A pointer to the tWaveTableS to initialize.
+     @param table A pointer to the wavetable data.
+     @param size The number of samples in the wavetable.
+     @param maxFreq The maximum expected frequency of the oscillator. The higher this is, the more memory will be needed.
+     @param format The format to store the levels in.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tWaveTableS_initFromData   (tWaveTableS* const osc, const void* data, int size, int numTables, WaveTableFormat format, LEAF* const leaf)
+     @brief Initialize a tWaveTableS to the default mempool of a LEAF instance from levels that were built ahead of time, as with tWaveTable_initFromData(). Each level is half the size of the one before it, down to no less than 128 samples.
+     @param osc A pointer to the tWaveTableS to initialize.
+     @param data The levels, one after another from the full bandwidth one down, in the given format.
+     @param size The number of samples in the first level. Must be a power of two.
+     @param numTables The number of levels in the data, at least 2.
+     @param format The format of the data, which is also the format the levels are kept in.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tWaveTableS_initFromDataToPool   (tWaveTableS* const osc, const void* data, int size, int numTables, WaveTableFormat format, tMempool* const mempool)
+     @brief Initialize a tWaveTableS to a specified mempool from levels that were built ahead of time.
+     @param osc A pointer to the tWaveTableS to initialize.
+     @param data The levels, one after another from the full bandwidth one down, in the given format.
+     @param size The number of samples in the first level. Must be a power of two.
+     @param numTables The number of levels in the data, at least 2.
+     @param format The format of the data.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tWaveTableS_initFromLevels   (tWaveTableS* const osc, const void* levels, int size, int numTables, WaveTableFormat format, LEAF* const leaf)
+     @brief Initialize a tWaveTableS to the default mempool of a LEAF instance that reads its levels in place, without copying them, as with tWaveTable_initFromLevels().
+     @param osc A pointer to the tWaveTableS to initialize.
+     @param levels The levels, one after another from the full bandwidth one down, in the given format. Each level is half the size of the one before it, down to no less than 128 samples.
+     @param size The number of samples in the first level. Must be a power of two.
+     @param numTables The number of levels, at least 2.
+     @param format The format of the levels.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tWaveTableS_initFromLevelsToPool   (tWaveTableS* const osc, const void* levels, int size, int numTables, WaveTableFormat format, tMempool* const mempool)
+     @brief Initialize a tWaveTableS to a specified mempool that reads its levels in place, without copying them.
+     @param osc A pointer to the tWaveTableS to initialize.
+     @param levels The levels, one after another from the full bandwidth one down, in the given format.
+     @param size The number of samples in the first level. Must be a power of two.
+     @param numTables The number of levels, at least 2.
+     @param format The format of the levels.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn void    tWaveTableS_initFromMemory   (tWaveTableS* const osc, const void* data, size_t length, LEAF* const leaf)
+     @brief Initialize a tWaveTableS to the default mempool of a LEAF instance from data written by tWaveTableS_writeToMemory(), as with tWaveTable_initFromMemory().
+     @param osc A pointer to the tWaveTableS to initialize.
+     @param data The data, starting with a WaveTableDataHeader. Must be aligned to at least 4 bytes.
+     @param length The size of the data in bytes, as returned by the writeToMemory function that wrote it. Data too short for the levels its header describes is not valid.
+     @param leaf A pointer to the leaf instance.
+     
+     @fn void    tWaveTableS_initFromMemoryToPool   (tWaveTableS* const osc, const void* data, size_t length, tMempool* const mempool)
+     @brief Initialize a tWaveTableS to a specified mempool from data written by tWaveTableS_writeToMemory().
+     @param osc A pointer to the tWaveTableS to initialize.
+     @param data The data, starting with a WaveTableDataHeader. Must be aligned to at least 4 bytes.
+     @param length The size of the data in bytes, as returned by the writeToMemory function that wrote it. Data too short for the levels its header describes is not valid.
+     @param mempool A pointer to the tMempool to use.
+     
+     @fn size_t  tWaveTableS_writeToMemory   (tWaveTableS* const osc, void* data)
+     @brief Write a tWaveTableS in the format read by tWaveTableS_initFromMemory().
+     @param osc A pointer to the relevant tWaveTableS.
+     @param data The memory to write to, or NULL to only get the size needed.
+     @return The size of the data in bytes.
+     
      @fn void    tWaveTableS_free         (tWaveTableS* const osc)
-     @brief Free a tWaveTableS from its mempool.
+     @brief Free a tWaveTableS from its mempool, or release this holder's reference to it if it is shared.
      @param osc A pointer to the tWaveTableS to free.
      
      @} */
@@ -1131,6 +2100,11 @@ extern "C" {
         
         float* baseTable;
         float** tables;
+        // Levels kept in a compact format instead of tables, see tWaveTableS_initCompact()
+        WaveTableFormat format;
+        int16_t** compactTables;
+        // Set when the levels are read in place, see tWaveTableS_initFromLevels()
+        int externalLevels;
         int numTables;
         int* sizes;
         int* sizeMasks;
@@ -1140,12 +2114,33 @@ extern "C" {
         float dsBuffer[2];
         tOversampler ds;
         float sampleRate;
+        // Sharing, see tWaveTableS_initShared()
+        int refCount;
+        int shared;
+        uint32_t hash;
+        struct _tWaveTableS* nextShared;
     } _tWaveTableS;
     
     typedef _tWaveTableS* tWaveTableS;
     
     void    tWaveTableS_init(tWaveTableS* const osc, float* table, int size, float maxFreq, LEAF* const leaf);
     void    tWaveTableS_initToPool(tWaveTableS* const osc, float* table, int size, float maxFreq, tMempool* const mempool);
+    void    tWaveTableS_initShared(tWaveTableS* const osc, float* table, int size, float maxFreq, LEAF* const leaf);
+    void    tWaveTableS_initCompact(tWaveTableS* const osc, float* table, int size, float maxFreq,
+                                    WaveTableFormat format, LEAF* const leaf);
+    void    tWaveTableS_initCompactToPool(tWaveTableS* const osc, float* table, int size, float maxFreq,
+                                          WaveTableFormat format, tMempool* const mempool);
+    void    tWaveTableS_initFromData(tWaveTableS* const osc, const void* data, int size, int numTables,
+                                     WaveTableFormat format, LEAF* const leaf);
+    void    tWaveTableS_initFromDataToPool(tWaveTableS* const osc, const void* data, int size, int numTables,
+                                           WaveTableFormat format, tMempool* const mempool);
+    void    tWaveTableS_initFromLevels(tWaveTableS* const osc, const void* levels, int size, int numTables,
+                                       WaveTableFormat format, LEAF* const leaf);
+    void    tWaveTableS_initFromLevelsToPool(tWaveTableS* const osc, const void* levels, int size, int numTables,
+                                             WaveTableFormat format, tMempool* const mempool);
+    void    tWaveTableS_initFromMemory(tWaveTableS* const osc, const void* data, size_t length, LEAF* const leaf);
+    void    tWaveTableS_initFromMemoryToPool(tWaveTableS* const osc, const void* data, size_t length, tMempool* const mempool);
+    size_t  tWaveTableS_writeToMemory(tWaveTableS* const osc, void* data);
     void    tWaveTableS_free(tWaveTableS* const osc);
     void    tWaveTableS_setSampleRate (tWaveTableS* const osc, float sr);
     
@@ -1173,6 +2168,15 @@ extern "C" {
      @param maxFreq The maximum expected frequency of the oscillator. The higher this is, the more memory will be needed.
      @param mempool A pointer to the tMempool to use.
      
+     @fn void    tWaveOscS_initShared(tWaveOscS* const osc, float** tables, int n, int size, float maxFreq, LEAF* const leaf)
+     @brief Initialize a tWaveOscS to the default mempool of a LEAF instance, with tWaveTableSs made by tWaveTableS_initShared(), as with tWaveOsc_initShared().
+     @param osc A pointer to the tWaveOscS to initialize.
+     @param tables An array of pointers to wavetable data.
+     @param n The number of wavetables.
+     @param size The number of samples in each of the wavetables.
+     @param maxFreq The maximum expected frequency of the oscillator. The higher this is, the more memory will be needed.
+     @param leaf A pointer to the leaf instance.
+     
      @fn void    tWaveOscS_free         (tWaveOsc* const osc)
      @brief Free a tWaveOscS from its mempool.
      @param osc A pointer to the tWaveOscS to free.
@@ -1182,6 +2186,14 @@ extern "C" {
      @param osc A pointer to the relevant tWaveOscS.
      @return The ticked sample as a float from -1 to 1.
      
+     @fn void    tWaveOscS_tickBlock    (tWaveOscS* const osc, float* const out, const float* const freq, const float* const index, int size)
+     @brief Tick a tWaveOscS oscillator for a block of samples. The output is identical to calling tWaveOscS_setFreq() and tWaveOscS_setIndex() with each sample of the given buffers and then tWaveOscS_tick(), and the last frequency and index given stay set. Without either buffer the tables are picked once for the whole block.
+     @param osc A pointer to the relevant tWaveOscS.
+     @param out The buffer to write the samples to.
+     @param freq The frequency of each sample in Hz, or NULL to keep the current frequency.
+     @param index The index of each sample, as in tWaveOscS_setIndex(), or NULL to keep the current index.
+     @param size The number of samples to tick.
+     
      @fn void    tWaveOscS_setFreq      (tWaveOsc* const osc, float freq)
      @brief Set the frequency of a tWaveOscS oscillator.
      @param osc A pointer to the relevant tWaveOscS.
@@ -1221,6 +2233,8 @@ extern "C" {
         float w;
         float aa;
         int numSubTables;
+        // Set when the tables came from tWaveOscS_initShared() and are released on free
+        int ownsTables;
 
     } _tWaveOscS;
     
@@ -1228,9 +2242,11 @@ extern "C" {
     
     void 	tWaveOscS_init(tWaveOscS* const cy, tWaveTableS* tables, int numTables, LEAF* const leaf);
     void    tWaveOscS_initToPool(tWaveOscS* const osc, tWaveTableS* tables, int numTables, tMempool* const mempool);
+    void    tWaveOscS_initShared(tWaveOscS* const osc, float** tables, int numTables, int size, float maxFreq, LEAF* const leaf);
     void    tWaveOscS_free(tWaveOscS* const osc);
     
     float   tWaveOscS_tick(tWaveOscS* const osc);
+    void    tWaveOscS_tickBlock(tWaveOscS* const osc, float* const out, const float* const freq, const float* const index, int size);
     void    tWaveOscS_setFreq(tWaveOscS* const osc, float freq);
     void    tWaveOscS_setAntiAliasing(tWaveOscS* const osc, float aa);
     void    tWaveOscS_setIndex(tWaveOscS* const osc, float index);
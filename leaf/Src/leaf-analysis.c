@@ -494,10 +494,10 @@ void    tSNAC_initToPool    (tSNAC* const snac, int overlaparg, tMempool* const
     s->minrms = DEFMINRMS;
     s->framesize = SNAC_FRAME_SIZE;
     
-    s->inputbuf = (float*) mpool_calloc(sizeof(float) * SNAC_FRAME_SIZE, m);
-    s->processbuf = (float*) mpool_calloc(sizeof(float) * (SNAC_FRAME_SIZE * 2), m);
-    s->spectrumbuf = (float*) mpool_calloc(sizeof(float) * (SNAC_FRAME_SIZE / 2), m);
-    s->biasbuf = (float*) mpool_calloc(sizeof(float) * SNAC_FRAME_SIZE, m);
+    s->inputbuf = (float*) mpool_calloc_aligned(sizeof(float) * SNAC_FRAME_SIZE, MPOOL_CACHE_LINE_SIZE, m);
+    s->processbuf = (float*) mpool_calloc_aligned(sizeof(float) * (SNAC_FRAME_SIZE * 2), MPOOL_CACHE_LINE_SIZE, m);
+    s->spectrumbuf = (float*) mpool_calloc_aligned(sizeof(float) * (SNAC_FRAME_SIZE / 2), MPOOL_CACHE_LINE_SIZE, m);
+    s->biasbuf = (float*) mpool_calloc_aligned(sizeof(float) * SNAC_FRAME_SIZE, MPOOL_CACHE_LINE_SIZE, m);
     
     snac_biasbuf(snac);
     tSNAC_setOverlap(snac, overlaparg);
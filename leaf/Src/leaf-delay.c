@@ -34,7 +34,7 @@ void    tDelay_initToPool   (tDelay* const dl, uint32_t delay, uint32_t maxDelay
 
     d->delay = delay;
 
-    d->buff = (float*) mpool_alloc(sizeof(float) * maxDelay, m);
+    d->buff = (float*) mpool_alloc_aligned(sizeof(float) * maxDelay, MPOOL_CACHE_LINE_SIZE, m);
     
     d->inPoint = 0;
     d->outPoint = 0;
@@ -177,7 +177,7 @@ void tLinearDelay_initToPool  (tLinearDelay* const dl, float delay, uint32_t max
     else if (delay < 0.0f)  d->delay = 0.0f;
     else                    d->delay = delay;
 
-    d->buff = (float*) mpool_alloc(sizeof(float) * maxDelay, m);
+    d->buff = (float*) mpool_alloc_aligned(sizeof(float) * maxDelay, MPOOL_CACHE_LINE_SIZE, m);
 
     d->gain = 1.0f;
 
@@ -384,7 +384,7 @@ void tHermiteDelay_initToPool  (tHermiteDelay* const dl, float delay, uint32_t m
         d->maxDelay = maxDelay;
         d->bufferMask = maxDelay - 1;
     }
-    d->buff = (float*) mpool_alloc(sizeof(float) * maxDelay, m);
+    d->buff = (float*) mpool_alloc_aligned(sizeof(float) * maxDelay, MPOOL_CACHE_LINE_SIZE, m);
 
     d->gain = 1.0f;
 
@@ -580,7 +580,7 @@ void tAllpassDelay_initToPool  (tAllpassDelay* const dl, float delay, uint32_t m
     else if (delay < 0.0f)  d->delay = 0.0f;
     else                    d->delay = delay;
 
-    d->buff = (float*) mpool_alloc(sizeof(float) * maxDelay, m);
+    d->buff = (float*) mpool_alloc_aligned(sizeof(float) * maxDelay, MPOOL_CACHE_LINE_SIZE, m);
 
     d->gain = 1.0f;
     
@@ -749,7 +749,7 @@ void tTapeDelay_initToPool (tTapeDelay* const dl, float delay, uint32_t maxDelay
 
     d->maxDelay = maxDelay;
 
-    d->buff = (float*) mpool_alloc(sizeof(float) * maxDelay, m);
+    d->buff = (float*) mpool_alloc_aligned(sizeof(float) * maxDelay, MPOOL_CACHE_LINE_SIZE, m);
 
     d->gain = 1.0f;
 
@@ -930,7 +930,7 @@ void    tRingBuffer_initToPool   (tRingBuffer* const ring, int size, tMempool* c
     else r->size = pow(2, ceil(log2(size)));
     r->mask = r->size - 1;
     
-    r->buffer = (float*) mpool_calloc(sizeof(float) * r->size, m);
+    r->buffer = (float*) mpool_calloc_aligned(sizeof(float) * r->size, MPOOL_CACHE_LINE_SIZE, m);
     r->pos = 0;
 }
 
@@ -96,8 +96,8 @@ void tOversampler_initToPool (tOversampler* const osr, int maxRatio, int extraQu
         os->numTaps = __leaf_tablesize_firNumTaps[idx];
         os->phaseLength = os->numTaps / os->ratio;
         os->pCoeffs = (float*) __leaf_tableref_firCoeffs[idx];
-        os->upState = (float*) mpool_alloc(sizeof(float) * os->numTaps * 2, m);
-        os->downState = (float*) mpool_alloc(sizeof(float) * os->numTaps * 2, m);
+        os->upState = (float*) mpool_alloc_aligned(sizeof(float) * os->numTaps * 2, MPOOL_CACHE_LINE_SIZE, m);
+        os->downState = (float*) mpool_alloc_aligned(sizeof(float) * os->numTaps * 2, MPOOL_CACHE_LINE_SIZE, m);
     }
 }
 
@@ -11,12 +11,14 @@
 #include "..\Inc\leaf-filters.h"
 #include "..\Inc\leaf-tables.h"
 #include "..\leaf.h"
+#include "..\Externals\d_fft_mayer.h"
 
 #else
 
 #include "../Inc/leaf-filters.h"
 #include "../Inc/leaf-tables.h"
 #include "../leaf.h"
+#include "../Externals/d_fft_mayer.h"
 //#include "tim.h"
 #endif
 
@@ -925,6 +927,148 @@ void    tSVF_setSampleRate  (tSVF* const svff, float sr)
     tSVF_setFreq(svff, svf->cutoff);
 }
 
+#define SVF_CHUNK_SIZE 32
+
+// Clamps x to [lo, hi], for lo >= 0, on the bits, which sort the same way as
+// the values of floats that aren't negative. Unlike float compares, integer
+// min and max always vectorize, and negative numbers and NaN still end up at
+// one end or the other.
+static inline float svf_clamp(float x, float lo, float hi)
+{
+    union { float f; int32_t i; } v = { x }, l = { lo }, h = { hi };
+    v.i = v.i > l.i ? v.i : l.i;
+    v.i = v.i < h.i ? v.i : h.i;
+    return v.f;
+}
+
+// tan over [0, pi/2], for cutoffs that change every sample, as sin over cos.
+// The cos series is cut after a positive term so it stays above zero, which
+// keeps the gain finite and positive up to Nyquist.
+static inline float svf_tan(float w)
+{
+    float x2 = w * w;
+    float s = 1.0f / 362880.0f;
+    s = s * x2 - 1.0f / 5040.0f;
+    s = s * x2 + 1.0f / 120.0f;
+    s = s * x2 - 1.0f / 6.0f;
+    s = s * x2 + 1.0f;
+    s *= w;
+    float c = 1.0f / 479001600.0f;
+    c = c * x2 - 1.0f / 3628800.0f;
+    c = c * x2 + 1.0f / 40320.0f;
+    c = c * x2 - 1.0f / 720.0f;
+    c = c * x2 + 1.0f / 24.0f;
+    c = c * x2 - 0.5f;
+    c = c * x2 + 1.0f;
+    return s / svf_clamp(c, 1e-6f, 1.0f);
+}
+
+// The block functions check for NaN once per block, where the ticks check every
+// sample. A state that has blown up is cleared and its block silenced, so that
+// the filter recovers.
+static inline void svf_checkState(float* const ic1eq, float* const ic2eq, float* const out, int size)
+{
+    if (isnan(*ic1eq) || isnan(*ic2eq))
+    {
+        *ic1eq = 0.0f;
+        *ic2eq = 0.0f;
+        for (int i = 0; i < size; ++i) out[i] = 0.0f;
+    }
+}
+
+// The output of each type as a mix of the input, band and low outputs, the
+// same way tSVF stores it
+static void svf_mix(SVFType type, float* const cH, float* const cB, float* const cBK, float* const cL)
+{
+    *cH = 0.0f; *cB = 0.0f; *cBK = 0.0f; *cL = 0.0f;
+    if (type == SVFTypeLowpass)         *cL = 1.0f;
+    else if (type == SVFTypeBandpass)   *cB = 1.0f;
+    else if (type == SVFTypeHighpass)   { *cH = 1.0f; *cBK = -1.0f; *cL = -1.0f; }
+    else if (type == SVFTypeNotch)      { *cH = 1.0f; *cBK = -1.0f; }
+    else if (type == SVFTypePeak)       { *cH = 1.0f; *cBK = -1.0f; *cL = -2.0f; }
+}
+
+void    tSVF_processBlock(tSVF* const svff, const float* const in, float* const out, int size)
+{
+    _tSVF* svf = *svff;
+    float ic1eq = svf->ic1eq;
+    float ic2eq = svf->ic2eq;
+    float a1 = svf->a1, a2 = svf->a2, a3 = svf->a3, k = svf->k;
+    float cH = svf->cH, cB = svf->cB, cBK = svf->cBK, cL = svf->cL;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        float v0 = in[i];
+        float v3 = v0 - ic2eq;
+        float v1 = (a1 * ic1eq) + (a2 * v3);
+        float v2 = ic2eq + (a2 * ic1eq) + (a3 * v3);
+        ic1eq = (2.0f * v1) - ic1eq;
+        ic2eq = (2.0f * v2) - ic2eq;
+        out[i] = (v0 * cH) + (v1 * cB) + (k * v1 * cBK) + (v2 * cL);
+    }
+    
+    svf_checkState(&ic1eq, &ic2eq, out, size);
+    svf->ic1eq = ic1eq;
+    svf->ic2eq = ic2eq;
+}
+
+void    tSVF_processBlockModulated(tSVF* const svff, const float* const in, const float* const freq, const float* const Q,
+                                   float* const out, int size)
+{
+    _tSVF* svf = *svff;
+    float ic1eq = svf->ic1eq;
+    float ic2eq = svf->ic2eq;
+    float cH = svf->cH, cB = svf->cB, cBK = svf->cBK, cL = svf->cL;
+    float maxFreq = svf->sampleRate * 0.5f;
+    float freqToAngle = PI * svf->invSampleRate;
+    float fc = svf->cutoff, k = svf->k;
+    
+    for (int i = 0; i < size; i += SVF_CHUNK_SIZE)
+    {
+        int n = size - i < SVF_CHUNK_SIZE ? size - i : SVF_CHUNK_SIZE;
+        float gs[SVF_CHUNK_SIZE], ks[SVF_CHUNK_SIZE];
+        float a1[SVF_CHUNK_SIZE], a2[SVF_CHUNK_SIZE], a3[SVF_CHUNK_SIZE];
+        
+        // Coefficients for the whole chunk first, as they don't depend on each other
+        for (int j = 0; j < n; ++j) gs[j] = svf_tan(svf_clamp(freq[i + j], 0.0f, maxFreq) * freqToAngle);
+        if (Q != NULL) for (int j = 0; j < n; ++j) ks[j] = 1.0f / Q[i + j];
+        else for (int j = 0; j < n; ++j) ks[j] = k;
+        for (int j = 0; j < n; ++j)
+        {
+            a1[j] = 1.0f / (1.0f + gs[j] * (gs[j] + ks[j]));
+            a2[j] = gs[j] * a1[j];
+            a3[j] = gs[j] * a2[j];
+        }
+        
+        for (int j = 0; j < n; ++j)
+        {
+            float v0 = in[i + j];
+            float v3 = v0 - ic2eq;
+            float v1 = (a1[j] * ic1eq) + (a2[j] * v3);
+            float v2 = ic2eq + (a2[j] * ic1eq) + (a3[j] * v3);
+            ic1eq = (2.0f * v1) - ic1eq;
+            ic2eq = (2.0f * v2) - ic2eq;
+            out[i + j] = (v0 * cH) + (v1 * cB) + (ks[j] * v1 * cBK) + (v2 * cL);
+        }
+        
+        fc = svf_clamp(freq[i + n - 1], 0.0f, maxFreq);
+        k = ks[n - 1];
+    }
+    
+    svf_checkState(&ic1eq, &ic2eq, out, size);
+    svf->ic1eq = ic1eq;
+    svf->ic2eq = ic2eq;
+    
+    // Leave the filter set to the last sample, with the exact tan as tSVF_setFreq
+    svf->cutoff = fc;
+    if (Q != NULL && size > 0) svf->Q = Q[size - 1];
+    svf->g = tanf(PI * svf->cutoff * svf->invSampleRate);
+    svf->k = k;
+    svf->a1 = 1.0f/(1.0f + svf->g * (svf->g + svf->k));
+    svf->a2 = svf->g * svf->a1;
+    svf->a3 = svf->g * svf->a2;
+}
+
 #if LEAF_INCLUDE_FILTERTAN_TABLE
 // Efficient version of tSVF where frequency is set based on 12-bit integer input for lookup in tanh wavetable.
 void   tEfficientSVF_init(tEfficientSVF* const svff, SVFType type, uint16_t input, float Q, LEAF* const leaf)
@@ -1006,6 +1150,89 @@ void    tEfficientSVF_setFreqAndQ   (tEfficientSVF* const svff, uint16_t input,
     svf->a2 = svf->g * svf->a1;
     svf->a3 = svf->g * svf->a2;
 }
+
+void    tEfficientSVF_processBlock(tEfficientSVF* const svff, const float* const in, float* const out, int size)
+{
+    _tEfficientSVF* svf = *svff;
+    float ic1eq = svf->ic1eq;
+    float ic2eq = svf->ic2eq;
+    float a1 = svf->a1, a2 = svf->a2, a3 = svf->a3, k = svf->k;
+    float cH, cB, cBK, cL;
+    svf_mix(svf->type, &cH, &cB, &cBK, &cL);
+    
+    for (int i = 0; i < size; ++i)
+    {
+        float v0 = in[i];
+        float v3 = v0 - ic2eq;
+        float v1 = (a1 * ic1eq) + (a2 * v3);
+        float v2 = ic2eq + (a2 * ic1eq) + (a3 * v3);
+        ic1eq = (2.0f * v1) - ic1eq;
+        ic2eq = (2.0f * v2) - ic2eq;
+        out[i] = (v0 * cH) + (v1 * cB) + (k * v1 * cBK) + (v2 * cL);
+    }
+    
+    svf_checkState(&ic1eq, &ic2eq, out, size);
+    svf->ic1eq = ic1eq;
+    svf->ic2eq = ic2eq;
+}
+
+void    tEfficientSVF_processBlockModulated(tEfficientSVF* const svff, const float* const in, const uint16_t* const controlFreq,
+                                            const float* const Q, float* const out, int size)
+{
+    _tEfficientSVF* svf = *svff;
+    float ic1eq = svf->ic1eq;
+    float ic2eq = svf->ic2eq;
+    float cH, cB, cBK, cL;
+    svf_mix(svf->type, &cH, &cB, &cBK, &cL);
+    float g = svf->g, k = svf->k;
+    
+    for (int i = 0; i < size; i += SVF_CHUNK_SIZE)
+    {
+        int n = size - i < SVF_CHUNK_SIZE ? size - i : SVF_CHUNK_SIZE;
+        float gs[SVF_CHUNK_SIZE], ks[SVF_CHUNK_SIZE];
+        float a1[SVF_CHUNK_SIZE], a2[SVF_CHUNK_SIZE], a3[SVF_CHUNK_SIZE];
+        
+        for (int j = 0; j < n; ++j)
+        {
+            int index = controlFreq[i + j];
+            gs[j] = __leaf_table_filtertan[index < FILTERTAN_TABLE_SIZE ? index : FILTERTAN_TABLE_SIZE - 1];
+        }
+        if (Q != NULL) for (int j = 0; j < n; ++j) ks[j] = 1.0f / Q[i + j];
+        else for (int j = 0; j < n; ++j) ks[j] = k;
+        for (int j = 0; j < n; ++j)
+        {
+            a1[j] = 1.0f / (1.0f + gs[j] * (gs[j] + ks[j]));
+            a2[j] = gs[j] * a1[j];
+            a3[j] = gs[j] * a2[j];
+        }
+        
+        for (int j = 0; j < n; ++j)
+        {
+            float v0 = in[i + j];
+            float v3 = v0 - ic2eq;
+            float v1 = (a1[j] * ic1eq) + (a2[j] * v3);
+            float v2 = ic2eq + (a2[j] * ic1eq) + (a3[j] * v3);
+            ic1eq = (2.0f * v1) - ic1eq;
+            ic2eq = (2.0f * v2) - ic2eq;
+            out[i + j] = (v0 * cH) + (v1 * cB) + (ks[j] * v1 * cBK) + (v2 * cL);
+        }
+        
+        g = gs[n - 1];
+        k = ks[n - 1];
+    }
+    
+    svf_checkState(&ic1eq, &ic2eq, out, size);
+    svf->ic1eq = ic1eq;
+    svf->ic2eq = ic2eq;
+    
+    // Leave the filter set to the last sample
+    if (Q != NULL && size > 0) svf->Q = Q[size - 1];
+    svf->g = g;
+    svf->k = k;
+    svf->a1 = 1.0f/(1.0f + svf->g * (svf->g + svf->k));
+    svf->a2 = svf->g * svf->a1;
+    svf->a3 = svf->g * svf->a2;
+}
 #endif // LEAF_INCLUDE_FILTERTAN_TABLE
 
 /* Highpass */
@@ -1152,6 +1379,302 @@ void    tButterworth_setSampleRate  (tButterworth* const ft, float sr)
 
 //================================================================================
 
+// Sections are stored b0, b1, b2, a1, a2, the same as tBiQuad_setCoefficients
+static void biquad_coeffsFromBiQuad(_tBiQuad* const f, float* const coeffs)
+{
+    // tBiQuad applies its gain to the input, so it goes on the zeros
+    coeffs[0] = f->b0 * f->gain;
+    coeffs[1] = f->b1 * f->gain;
+    coeffs[2] = f->b2 * f->gain;
+    coeffs[3] = f->a1;
+    coeffs[4] = f->a2;
+}
+
+// The high, band and low outputs of a tSVF share the denominator s^2 + ks + 1,
+// so its output mix is (m0 s^2 + (m0 k + m1) s + m0 + m2) / (s^2 + ks + 1),
+// which the bilinear transform with prewarped g turns into a biquad.
+static void biquad_coeffsFromSVF(_tSVF* const svf, float* const coeffs)
+{
+    float g = svf->g;
+    float k = svf->k;
+    float m0 = svf->cH;
+    float m1 = svf->cB + k * svf->cBK;
+    float m2 = svf->cL;
+    
+    float x0 = m0;
+    float x1 = (m0 * k + m1) * g;
+    float x2 = (m0 + m2) * g * g;
+    coeffs[0] = (x0 + x1 + x2) * svf->a1;
+    coeffs[1] = 2.0f * (x2 - x0) * svf->a1;
+    coeffs[2] = (x0 - x1 + x2) * svf->a1;
+    coeffs[3] = 2.0f * (g * g - 1.0f) * svf->a1;
+    coeffs[4] = (1.0f - g * k + g * g) * svf->a1;
+}
+
+// Sets lane i of a run of groups, counting across the groups
+static void biquad_setLane(_tBiquadLanes* const lanes, int i, const float* const coeffs)
+{
+    _tBiquadLanes* g = &lanes[i / BIQUAD_LANES];
+    int lane = i % BIQUAD_LANES;
+    
+    g->b0[lane] = coeffs[0];
+    g->b1[lane] = coeffs[1];
+    g->b2[lane] = coeffs[2];
+    g->a1[lane] = coeffs[3];
+    g->a2[lane] = coeffs[4];
+}
+
+static _tBiquadLanes* biquad_allocLanes(int numGroups, _tMempool* const m)
+{
+    _tBiquadLanes* lanes = (_tBiquadLanes*) mpool_calloc_aligned(sizeof(_tBiquadLanes) * numGroups, MPOOL_CACHE_LINE_SIZE, m);
+    
+    // Sections pass their input through until they are set
+    for (int g = 0; g < numGroups; ++g)
+        for (int l = 0; l < BIQUAD_LANES; ++l) lanes[g].b0[l] = 1.0f;
+    return lanes;
+}
+
+void    tBiquadCascade_init(tBiquadCascade* const cascade, int numSections, LEAF* const leaf)
+{
+    tBiquadCascade_initToPool(cascade, numSections, &leaf->mempool);
+}
+
+void    tBiquadCascade_initToPool(tBiquadCascade* const cascade, int numSections, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tBiquadCascade* c = *cascade = (_tBiquadCascade*) mpool_alloc(sizeof(_tBiquadCascade), m);
+    c->mempool = m;
+    
+    if (numSections < 1) numSections = 1;
+    c->numSections = numSections;
+    c->numGroups = (numSections + BIQUAD_LANES - 1) / BIQUAD_LANES;
+    c->sections = biquad_allocLanes(c->numGroups, m);
+    c->pipe[0] = (float*) mpool_calloc_aligned(sizeof(float) * (numSections + 1), MPOOL_CACHE_LINE_SIZE, m);
+    c->pipe[1] = (float*) mpool_calloc_aligned(sizeof(float) * (numSections + 1), MPOOL_CACHE_LINE_SIZE, m);
+}
+
+void    tBiquadCascade_free(tBiquadCascade* const cascade)
+{
+    _tBiquadCascade* c = *cascade;
+    
+    mpool_free((char*)c->pipe[1], c->mempool);
+    mpool_free((char*)c->pipe[0], c->mempool);
+    mpool_free((char*)c->sections, c->mempool);
+    mpool_free((char*)c, c->mempool);
+}
+
+static inline float biquadcascade_tick(_tBiquadCascade* const c, float x)
+{
+    for (int j = 0; j < c->numSections; ++j)
+    {
+        _tBiquadLanes* g = &c->sections[j / BIQUAD_LANES];
+        int l = j % BIQUAD_LANES;
+        float y = g->b0[l] * x + g->s1[l];
+        g->s1[l] = g->b1[l] * x - g->a1[l] * y + g->s2[l];
+        g->s2[l] = g->b2[l] * x - g->a2[l] * y;
+        x = y;
+    }
+    return x;
+}
+
+float   tBiquadCascade_tick(tBiquadCascade* const cascade, float input)
+{
+    _tBiquadCascade* c = *cascade;
+    
+    return biquadcascade_tick(c, input);
+}
+
+void    tBiquadCascade_processBlock(tBiquadCascade* const cascade, const float* const in, float* const out, int size)
+{
+    _tBiquadCascade* c = *cascade;
+    int numSections = c->numSections;
+    float* x = c->pipe[0];
+    float* y = c->pipe[1];
+    
+    // Cascades shorter than a group of lanes gain too little from the pipeline
+    if (numSections < BIQUAD_LANES)
+    {
+        for (int i = 0; i < size; ++i) out[i] = biquadcascade_tick(c, in[i]);
+        return;
+    }
+    
+    // At step t, section j works on sample t - j, so the sections don't wait on
+    // each other and run side by side. The pipeline fills at the start of the
+    // block and drains at the end, so there is no added latency.
+    for (int t = 0; t < size + numSections - 1; ++t)
+    {
+        int first = t - size + 1 > 0 ? t - size + 1 : 0;
+        int last = t < numSections - 1 ? t : numSections - 1;
+        
+        if (t < size) x[0] = in[t];
+        for (int base = first - first % BIQUAD_LANES; base <= last; base += BIQUAD_LANES)
+        {
+            _tBiquadLanes* g = &c->sections[base / BIQUAD_LANES];
+            const float* xg = x + base;
+            float* yg = y + base + 1;
+            int lo = first > base ? first - base : 0;
+            int hi = last - base < BIQUAD_LANES - 1 ? last - base : BIQUAD_LANES - 1;
+            
+            for (int l = lo; l <= hi; ++l)
+            {
+                float xl = xg[l];
+                float yl = g->b0[l] * xl + g->s1[l];
+                g->s1[l] = g->b1[l] * xl - g->a1[l] * yl + g->s2[l];
+                g->s2[l] = g->b2[l] * xl - g->a2[l] * yl;
+                yg[l] = yl;
+            }
+        }
+        if (last == numSections - 1) out[t - last] = y[numSections];
+        
+        float* swap = x;
+        x = y;
+        y = swap;
+    }
+}
+
+void    tBiquadCascade_setCoefficients(tBiquadCascade* const cascade, int section, float b0, float b1, float b2, float a1, float a2)
+{
+    _tBiquadCascade* c = *cascade;
+    float k[5] = { b0, b1, b2, a1, a2 };
+    
+    if (section < 0 || section >= c->numSections) return;
+    biquad_setLane(c->sections, section, k);
+}
+
+void    tBiquadCascade_setFromBiQuad(tBiquadCascade* const cascade, int section, tBiQuad* const filter)
+{
+    float k[5];
+    biquad_coeffsFromBiQuad(*filter, k);
+    tBiquadCascade_setCoefficients(cascade, section, k[0], k[1], k[2], k[3], k[4]);
+}
+
+void    tBiquadCascade_setFromSVF(tBiquadCascade* const cascade, int section, tSVF* const filter)
+{
+    float k[5];
+    biquad_coeffsFromSVF(*filter, k);
+    tBiquadCascade_setCoefficients(cascade, section, k[0], k[1], k[2], k[3], k[4]);
+}
+
+void    tBiquadCascade_setFromButterworth(tBiquadCascade* const cascade, tButterworth* const filter)
+{
+    _tBiquadCascade* c = *cascade;
+    _tButterworth* f = *filter;
+    
+    for (int j = 0; j < c->numSections; ++j)
+    {
+        if (j < f->numSVF) tBiquadCascade_setFromSVF(cascade, j, &f->svf[j]);
+        else tBiquadCascade_setCoefficients(cascade, j, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+    }
+}
+
+void    tBiquadBank_init(tBiquadBank* const bank, int numVoices, int numSections, LEAF* const leaf)
+{
+    tBiquadBank_initToPool(bank, numVoices, numSections, &leaf->mempool);
+}
+
+void    tBiquadBank_initToPool(tBiquadBank* const bank, int numVoices, int numSections, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tBiquadBank* c = *bank = (_tBiquadBank*) mpool_alloc(sizeof(_tBiquadBank), m);
+    c->mempool = m;
+    
+    if (numSections < 1) numSections = 1;
+    c->numVoices = numVoices;
+    c->numSections = numSections;
+    c->numGroups = (numVoices + BIQUAD_LANES - 1) / BIQUAD_LANES;
+    c->sections = biquad_allocLanes(c->numGroups * numSections, m);
+    c->x = (float*) mpool_calloc_aligned(sizeof(float) * c->numGroups * BIQUAD_LANES, MPOOL_CACHE_LINE_SIZE, m);
+}
+
+void    tBiquadBank_free(tBiquadBank* const bank)
+{
+    _tBiquadBank* c = *bank;
+    
+    mpool_free((char*)c->x, c->mempool);
+    mpool_free((char*)c->sections, c->mempool);
+    mpool_free((char*)c, c->mempool);
+}
+
+// Runs one sample of every voice in c->x through all of the sections, in place
+static void biquadbank_tick(_tBiquadBank* const c)
+{
+    for (int j = 0; j < c->numSections; ++j)
+    {
+        for (int vg = 0; vg < c->numGroups; ++vg)
+        {
+            _tBiquadLanes* g = &c->sections[j * c->numGroups + vg];
+            float* x = c->x + vg * BIQUAD_LANES;
+            
+            for (int l = 0; l < BIQUAD_LANES; ++l)
+            {
+                float xl = x[l];
+                float yl = g->b0[l] * xl + g->s1[l];
+                g->s1[l] = g->b1[l] * xl - g->a1[l] * yl + g->s2[l];
+                g->s2[l] = g->b2[l] * xl - g->a2[l] * yl;
+                x[l] = yl;
+            }
+        }
+    }
+}
+
+void    tBiquadBank_tick(tBiquadBank* const bank, const float* const in, float* const out)
+{
+    _tBiquadBank* c = *bank;
+    
+    for (int v = 0; v < c->numVoices; ++v) c->x[v] = in[v];
+    biquadbank_tick(c);
+    for (int v = 0; v < c->numVoices; ++v) out[v] = c->x[v];
+}
+
+void    tBiquadBank_processBlock(tBiquadBank* const bank, float** const in, float** const out, int size)
+{
+    _tBiquadBank* c = *bank;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        for (int v = 0; v < c->numVoices; ++v) c->x[v] = in[v][i];
+        biquadbank_tick(c);
+        for (int v = 0; v < c->numVoices; ++v) out[v][i] = c->x[v];
+    }
+}
+
+void    tBiquadBank_setCoefficients(tBiquadBank* const bank, int voice, int section, float b0, float b1, float b2, float a1, float a2)
+{
+    _tBiquadBank* c = *bank;
+    float k[5] = { b0, b1, b2, a1, a2 };
+    
+    if (voice < 0 || voice >= c->numVoices || section < 0 || section >= c->numSections) return;
+    biquad_setLane(c->sections + section * c->numGroups, voice, k);
+}
+
+void    tBiquadBank_setFromBiQuad(tBiquadBank* const bank, int voice, int section, tBiQuad* const filter)
+{
+    float k[5];
+    biquad_coeffsFromBiQuad(*filter, k);
+    tBiquadBank_setCoefficients(bank, voice, section, k[0], k[1], k[2], k[3], k[4]);
+}
+
+void    tBiquadBank_setFromSVF(tBiquadBank* const bank, int voice, int section, tSVF* const filter)
+{
+    float k[5];
+    biquad_coeffsFromSVF(*filter, k);
+    tBiquadBank_setCoefficients(bank, voice, section, k[0], k[1], k[2], k[3], k[4]);
+}
+
+void    tBiquadBank_setFromButterworth(tBiquadBank* const bank, int voice, tButterworth* const filter)
+{
+    _tBiquadBank* c = *bank;
+    _tButterworth* f = *filter;
+    
+    for (int j = 0; j < c->numSections; ++j)
+    {
+        if (j < f->numSVF) tBiquadBank_setFromSVF(bank, voice, j, &f->svf[j]);
+        else tBiquadBank_setCoefficients(bank, voice, j, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+    }
+}
+
+//================================================================================
+
 void    tFIR_init(tFIR* const firf, float* coeffs, int numTaps, LEAF* const leaf)
 {
     tFIR_initToPool(firf, coeffs, numTaps, &leaf->mempool);
@@ -1165,29 +1688,363 @@ void    tFIR_initToPool     (tFIR* const firf, float* coeffs, int numTaps, tMemp
     
     fir->numTaps = numTaps;
     fir->coeff = coeffs;
-    fir->past = (float*) mpool_alloc(sizeof(float) * fir->numTaps, m);
-    for (int i = 0; i < fir->numTaps; ++i) fir->past[i] = 0.0f;
+    fir->past = (float*) mpool_calloc_aligned(sizeof(float) * fir->numTaps * 2, MPOOL_CACHE_LINE_SIZE, m);
+    fir->pastReversed = NULL;
+    fir->pos = 0;
+    fir->symmetric = 0;
 }
 
 void    tFIR_free   (tFIR* const firf)
 {
     _tFIR* fir = *firf;
     
+    if (fir->pastReversed != NULL) mpool_free((char*)fir->pastReversed, fir->mempool);
     mpool_free((char*)fir->past, fir->mempool);
     mpool_free((char*)fir, fir->mempool);
 }
 
-float   tFIR_tick(tFIR* const firf, float input)
+#define FIR_LANES 16
+
+// Dot product of the coefficients with the history, newest sample first. The
+// sum is split over FIR_LANES accumulators, which the compiler can keep in
+// vector registers, and they are added together at the end.
+static inline float fir_dot(const float* const coeff, const float* const x, int numTaps)
 {
-    _tFIR* fir = *firf;
+    float acc[FIR_LANES] = { 0.0f };
+    int i = 0;
+    
+    for (; i + FIR_LANES <= numTaps; i += FIR_LANES)
+        for (int j = 0; j < FIR_LANES; ++j) acc[j] += coeff[i + j] * x[i + j];
+    for (int j = 0; j < FIR_LANES && i + j < numTaps; ++j) acc[j] += coeff[i + j] * x[i + j];
     
-    fir->past[0] = input;
     float y = 0.0f;
-    for (int i = 0; i < fir->numTaps; ++i) y += fir->past[i]*fir->coeff[i];
-    for (int i = fir->numTaps-1; i > 0; --i) fir->past[i] = fir->past[i-1];
+    for (int j = 0; j < FIR_LANES; ++j) y += acc[j];
     return y;
 }
 
+// Same for coefficients that are symmetric about their middle. Samples that
+// share a coefficient are added first, so only the first half is multiplied.
+// r is the history oldest sample first, so that both halves are read forwards.
+static inline float fir_dotSymmetric(const float* const coeff, const float* const x, const float* const r,
+                                     int numTaps)
+{
+    float acc[FIR_LANES] = { 0.0f };
+    int half = numTaps / 2;
+    int i = 0;
+    
+    for (; i + FIR_LANES <= half; i += FIR_LANES)
+        for (int j = 0; j < FIR_LANES; ++j) acc[j] += coeff[i + j] * (x[i + j] + r[i + j]);
+    for (int j = 0; j < FIR_LANES && i + j < half; ++j) acc[j] += coeff[i + j] * (x[i + j] + r[i + j]);
+    if (numTaps & 1) acc[0] += coeff[half] * x[half];
+    
+    float y = 0.0f;
+    for (int j = 0; j < FIR_LANES; ++j) y += acc[j];
+    return y;
+}
+
+// The history is kept twice, numTaps samples apart, so the last numTaps inputs
+// can always be read from pos onwards without wrapping. In symmetric mode
+// pastReversed holds the same samples back to front, with pastReversed[k] equal
+// to past[2 * numTaps - 1 - k].
+static inline float fir_tick(_tFIR* const fir, float input)
+{
+    int numTaps = fir->numTaps;
+    
+    if (--fir->pos < 0) fir->pos = numTaps - 1;
+    int pos = fir->pos;
+    float* x = fir->past + pos;
+    x[0] = input;
+    x[numTaps] = input;
+    
+    if (fir->symmetric)
+    {
+        fir->pastReversed[numTaps - 1 - pos] = input;
+        fir->pastReversed[2 * numTaps - 1 - pos] = input;
+        return fir_dotSymmetric(fir->coeff, x, fir->pastReversed + numTaps - pos, numTaps);
+    }
+    return fir_dot(fir->coeff, x, numTaps);
+}
+
+float   tFIR_tick(tFIR* const firf, float input)
+{
+    _tFIR* fir = *firf;
+    
+    return fir_tick(fir, input);
+}
+
+void    tFIR_processBlock(tFIR* const firf, const float* const in, float* const out, int size)
+{
+    _tFIR* fir = *firf;
+    
+    for (int i = 0; i < size; ++i) out[i] = fir_tick(fir, in[i]);
+}
+
+void    tFIR_setSymmetric(tFIR* const firf, int symmetric)
+{
+    _tFIR* fir = *firf;
+    
+    if (symmetric && !fir->symmetric)
+    {
+        int length = fir->numTaps * 2;
+        if (fir->pastReversed == NULL)
+            fir->pastReversed = (float*) mpool_alloc_aligned(sizeof(float) * length, MPOOL_CACHE_LINE_SIZE, fir->mempool);
+        for (int i = 0; i < length; ++i) fir->pastReversed[i] = fir->past[length - 1 - i];
+    }
+    fir->symmetric = symmetric ? 1 : 0;
+}
+
+//================================================================================
+
+#define CONVOLVER_PARTITIONS_PER_SIZE 2
+#define CONVOLVER_MIN_HEAD_SIZE 8
+
+// Sizes are rounded up to powers of two for the FFT
+static int convolver_powerOfTwo(int size)
+{
+    int p = 1;
+    while (p < size) p <<= 1;
+    return p;
+}
+
+// mayer_realfft leaves the imaginary parts back to front in the second half of
+// the spectrum. Stages keep them front to back instead, with the Nyquist bin in
+// the slot of the DC imaginary part, which is always zero, so that the complex
+// multiplies read everything in order. Reversing again gives back the layout
+// mayer_realifft expects.
+static void convolver_reverseImag(float* const spectrum, int blockSize)
+{
+    float* a = spectrum + blockSize + 1;
+    float* b = spectrum + 2 * blockSize - 1;
+    while (a < b)
+    {
+        float t = *a;
+        *a++ = *b;
+        *b-- = t;
+    }
+}
+
+// Fills in one stage, with its blockSize long partitions of the impulse
+// response starting at offset. The inverse FFT scaling is folded into the filters.
+static void convolver_initStage(_tConvolverStage* const st, const float* ir, int length, int blockSize,
+                                int numPartitions, int offset, _tMempool* const m)
+{
+    int fftSize = 2 * blockSize;
+    float scale = 1.0f / (float) fftSize;
+    
+    st->blockSize = blockSize;
+    st->numPartitions = numPartitions;
+    st->offset = offset;
+    st->current = 0;
+    st->input = (float*) mpool_calloc_aligned(sizeof(float) * fftSize, MPOOL_CACHE_LINE_SIZE, m);
+    st->spectra = (float*) mpool_calloc_aligned(sizeof(float) * fftSize * numPartitions, MPOOL_CACHE_LINE_SIZE, m);
+    st->filters = (float*) mpool_calloc_aligned(sizeof(float) * fftSize * numPartitions, MPOOL_CACHE_LINE_SIZE, m);
+    
+    for (int p = 0; p < numPartitions; ++p)
+    {
+        float* h = st->filters + p * fftSize;
+        int start = offset + p * blockSize;
+        for (int i = 0; i < blockSize && start + i < length; ++i) h[i] = ir[start + i] * scale;
+        mayer_realfft(fftSize, h);
+        convolver_reverseImag(h, blockSize);
+    }
+}
+
+// Runs once a stage has a full block of new input. The convolution of that
+// block with the stage's part of the impulse response is added to the output
+// ahead of time, from offset - blockSize samples after the current one.
+static void convolver_processStage(_tConvolver* const c, _tConvolverStage* const st)
+{
+    int L = st->blockSize;
+    int fftSize = 2 * L;
+    int P = st->numPartitions;
+    float* sum = c->sum;
+    
+    st->current = st->current > 0 ? st->current - 1 : P - 1;
+    float* x = st->spectra + st->current * fftSize;
+    for (int i = 0; i < fftSize; ++i) x[i] = st->input[i];
+    mayer_realfft(fftSize, x);
+    convolver_reverseImag(x, L);
+    
+    for (int i = 0; i < fftSize; ++i) sum[i] = 0.0f;
+    for (int p = 0; p < P; ++p)
+    {
+        int q = st->current + p;
+        if (q >= P) q -= P;
+        const float* xr = st->spectra + q * fftSize;
+        const float* xi = xr + L;
+        const float* hr = st->filters + p * fftSize;
+        const float* hi = hr + L;
+        float* sr = sum;
+        float* si = sum + L;
+        
+        sr[0] += xr[0] * hr[0];
+        si[0] += xi[0] * hi[0];
+        for (int i = 1; i < L; ++i)
+        {
+            sr[i] += xr[i] * hr[i] - xi[i] * hi[i];
+            si[i] += xr[i] * hi[i] + xi[i] * hr[i];
+        }
+    }
+    
+    convolver_reverseImag(sum, L);
+    mayer_realifft(fftSize, sum);
+    
+    // The second half of the block is free of wrap around
+    uint32_t start = c->time - L + st->offset;
+    for (int i = 0; i < L; ++i) c->output[(start + i) & c->outputMask] += sum[L + i];
+    
+    for (int i = 0; i < L; ++i) st->input[i] = st->input[L + i];
+}
+
+// Splits the impulse response after the head into partitions that double in
+// size every CONVOLVER_PARTITIONS_PER_SIZE partitions, up to maxBlockSize, and
+// returns the number of stages. Each stage starts at least its own block size
+// into the impulse response, so its output is always ready in time. Only
+// counts when m is NULL.
+static int convolver_layout(_tConvolver* const c, const float* ir, int length, int maxBlockSize, _tMempool* const m)
+{
+    int numStages = 0;
+    int offset = c->headSize;
+    int blockSize = c->headSize;
+    
+    while (offset < length)
+    {
+        int numPartitions = (length - offset + blockSize - 1) / blockSize;
+        if (blockSize < maxBlockSize && numPartitions > CONVOLVER_PARTITIONS_PER_SIZE)
+            numPartitions = CONVOLVER_PARTITIONS_PER_SIZE;
+        if (m != NULL) convolver_initStage(&c->stages[numStages], ir, length, blockSize, numPartitions, offset, m);
+        offset += numPartitions * blockSize;
+        if (blockSize < maxBlockSize) blockSize *= 2;
+        numStages++;
+    }
+    
+    return numStages;
+}
+
+static void convolver_process(_tConvolver* const c, const float* const in, float* const out, int size)
+{
+    int headSize = c->headSize;
+    
+    for (int i = 0; i < size; )
+    {
+        // Go as far as the next boundary of the smallest block
+        int n = headSize - (int)(c->time & (headSize - 1));
+        if (n > size - i) n = size - i;
+        
+        // Queue the input first, as in and out may be the same buffer
+        for (int s = 0; s < c->numStages; ++s)
+        {
+            _tConvolverStage* st = &c->stages[s];
+            float* queue = st->input + st->blockSize + (c->time & (st->blockSize - 1));
+            for (int j = 0; j < n; ++j) queue[j] = in[i + j];
+        }
+        
+        tFIR_processBlock(&c->head, in + i, out + i, n);
+        
+        for (int j = 0; j < n; ++j)
+        {
+            uint32_t k = (c->time + j) & c->outputMask;
+            out[i + j] += c->output[k];
+            c->output[k] = 0.0f;
+        }
+        
+        c->time += n;
+        i += n;
+        
+        for (int s = 0; s < c->numStages; ++s)
+        {
+            _tConvolverStage* st = &c->stages[s];
+            if ((c->time & (st->blockSize - 1)) == 0) convolver_processStage(c, st);
+        }
+    }
+}
+
+void    tConvolver_init(tConvolver* const conv, const float* ir, int length, int headSize, int maxBlockSize,
+                        LEAF* const leaf)
+{
+    tConvolver_initToPool(conv, ir, length, headSize, maxBlockSize, &leaf->mempool);
+}
+
+void    tConvolver_initToPool(tConvolver* const conv, const float* ir, int length, int headSize, int maxBlockSize,
+                              tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tConvolver* c = *conv = (_tConvolver*) mpool_alloc(sizeof(_tConvolver), m);
+    c->mempool = m;
+    
+    if (length < 0) length = 0;
+    if (headSize < CONVOLVER_MIN_HEAD_SIZE) headSize = CONVOLVER_MIN_HEAD_SIZE;
+    headSize = convolver_powerOfTwo(headSize);
+    maxBlockSize = convolver_powerOfTwo(maxBlockSize);
+    if (maxBlockSize < headSize) maxBlockSize = headSize;
+    
+    c->length = length;
+    c->headSize = headSize;
+    c->time = 0;
+    
+    // The head runs in the time domain, with no latency
+    int headTaps = length < headSize ? length : headSize;
+    if (headTaps < 1) headTaps = 1;
+    c->headCoeffs = (float*) mpool_calloc_aligned(sizeof(float) * headTaps, MPOOL_CACHE_LINE_SIZE, m);
+    for (int i = 0; i < headTaps && i < length; ++i) c->headCoeffs[i] = ir[i];
+    tFIR_initToPool(&c->head, c->headCoeffs, headTaps, mp);
+    
+    int numStages = convolver_layout(c, ir, length, maxBlockSize, NULL);
+    
+    c->numStages = numStages;
+    c->stages = NULL;
+    c->sum = NULL;
+    int outputSize = 1;
+    if (numStages > 0)
+    {
+        c->stages = (_tConvolverStage*) mpool_alloc(sizeof(_tConvolverStage) * numStages, m);
+        convolver_layout(c, ir, length, maxBlockSize, m);
+        
+        _tConvolverStage* last = &c->stages[numStages - 1];
+        outputSize = convolver_powerOfTwo(last->offset + last->blockSize);
+        c->sum = (float*) mpool_alloc_aligned(sizeof(float) * 2 * last->blockSize, MPOOL_CACHE_LINE_SIZE, m);
+    }
+    c->output = (float*) mpool_calloc_aligned(sizeof(float) * outputSize, MPOOL_CACHE_LINE_SIZE, m);
+    c->outputMask = outputSize - 1;
+}
+
+void    tConvolver_free(tConvolver* const conv)
+{
+    _tConvolver* c = *conv;
+    
+    mpool_free((char*)c->output, c->mempool);
+    if (c->numStages > 0)
+    {
+        for (int s = 0; s < c->numStages; ++s)
+        {
+            mpool_free((char*)c->stages[s].filters, c->mempool);
+            mpool_free((char*)c->stages[s].spectra, c->mempool);
+            mpool_free((char*)c->stages[s].input, c->mempool);
+        }
+        mpool_free((char*)c->sum, c->mempool);
+        mpool_free((char*)c->stages, c->mempool);
+    }
+    tFIR_free(&c->head);
+    mpool_free((char*)c->headCoeffs, c->mempool);
+    mpool_free((char*)c, c->mempool);
+}
+
+float   tConvolver_tick(tConvolver* const conv, float input)
+{
+    _tConvolver* c = *conv;
+    float output;
+    
+    convolver_process(c, &input, &output, 1);
+    return output;
+}
+
+void    tConvolver_processBlock(tConvolver* const conv, const float* const in, float* const out, int size)
+{
+    _tConvolver* c = *conv;
+    
+    convolver_process(c, in, out, size);
+}
+
 //---------------------------------------------
 ////
 /// Median filter implemented based on James McCartney's median filter in Supercollider,
@@ -1304,11 +2161,8 @@ void    tVZFilter_free   (tVZFilter* const vf)
     mpool_free((char*)f, f->mempool);
 }
 
-float   tVZFilter_tick              (tVZFilter* const vf, float in)
+static inline float vzfilter_tick(_tVZFilter* const f, float in)
 {
-    _tVZFilter* f = *vf;
-    
-    
     float yL, yB, yH, v1, v2;
     
     // compute highpass output via Eq. 5.1:
@@ -1336,7 +2190,22 @@ float   tVZFilter_tick              (tVZFilter* const vf, float in)
     
     // if we wanted to go into self-oscillation with stabiity we would need to use an anti-saturator on the feedback loop, haven't figured that out yet. -JS
     
-    return f->cL*yL + f->cB*yB + f->cH*yH;
+    return f->cL*yL + f->cB*yB + f->cH*yH;
+}
+
+float   tVZFilter_tick              (tVZFilter* const vf, float in)
+{
+    _tVZFilter* f = *vf;
+    
+    return vzfilter_tick(f, in);
+}
+
+void    tVZFilter_processBlock      (tVZFilter* const vf, const float* const in, float* const out, int size)
+{
+    _tVZFilter* f = *vf;
+    
+    for (int i = 0; i < size; ++i) out[i] = vzfilter_tick(f, in[i]);
+    svf_checkState(&f->s1, &f->s2, out, size);
 }
 
 float   tVZFilter_tickEfficient             (tVZFilter* const vf, float in)
@@ -1361,10 +2230,11 @@ float   tVZFilter_tickEfficient             (tVZFilter* const vf, float in)
     return f->cL*yL + f->cB*yB + f->cH*yH;
 }
 
-void   tVZFilter_calcCoeffs           (tVZFilter* const vf)
+// Sets the coefficients from the embedded integrator gain g and, for Bell, the
+// warped lower bandedge wl, which are all that need a tan
+static inline void vzfilter_setCoeffs(_tVZFilter* const f, float g, float wl)
 {
-    _tVZFilter* f = *vf;
-    f->g = tanf(PI * f->fc * f->invSampleRate);  // embedded integrator gain (Fig 3.11)
+    f->g = g;  // embedded integrator gain (Fig 3.11)
     
     switch( f->type )
     {
@@ -1416,8 +2286,6 @@ void   tVZFilter_calcCoeffs           (tVZFilter* const vf)
             break;
         case Bell:
         {
-            float fl = f->fc*powf(2.0f, (-f->B)*0.5f); // lower bandedge frequency (in Hz)
-            float wl = tanf(PI*fl*f->invSampleRate);   // warped radian lower bandedge frequency /(2*fs)
             float r  = f->g/wl;
             r *= r;    // warped frequency ratio wu/wl == (wc/wl)^2 where wu is the
             // warped upper bandedge, wc the center
@@ -1482,6 +2350,64 @@ void   tVZFilter_calcCoeffs           (tVZFilter* const vf)
     f->h = 1.0f / (1.0f + (f->R2*f->g) + (f->g*f->g));  // factor for feedback precomputation
 }
 
+static void vzfilter_calcCoeffs(_tVZFilter* const f)
+{
+    float wl = 0.0f;
+    if (f->type == Bell)
+    {
+        float fl = f->fc*powf(2.0f, (-f->B)*0.5f); // lower bandedge frequency (in Hz)
+        wl = tanf(PI*fl*f->invSampleRate);   // warped radian lower bandedge frequency /(2*fs)
+    }
+    vzfilter_setCoeffs(f, tanf(PI * f->fc * f->invSampleRate), wl);
+}
+
+void   tVZFilter_calcCoeffs           (tVZFilter* const vf)
+{
+    _tVZFilter* f = *vf;
+    vzfilter_calcCoeffs(f);
+}
+
+void    tVZFilter_processBlockModulated(tVZFilter* const vf, const float* const in, const float* const freq,
+                                        const float* const resonance, float* const out, int size)
+{
+    _tVZFilter* f = *vf;
+    float maxFreq = 0.5f * f->sampleRate;
+    float freqToAngle = PI * f->invSampleRate;
+    // The lower bandedge of Bell is a fixed ratio below the cutoff
+    float bandedge = (f->type == Bell) ? powf(2.0f, (-f->B)*0.5f) : 0.0f;
+    
+    for (int i = 0; i < size; i += SVF_CHUNK_SIZE)
+    {
+        int n = size - i < SVF_CHUNK_SIZE ? size - i : SVF_CHUNK_SIZE;
+        float fcs[SVF_CHUNK_SIZE], gs[SVF_CHUNK_SIZE], wls[SVF_CHUNK_SIZE], R2s[SVF_CHUNK_SIZE];
+        
+        // The tans for the whole chunk first, as in tSVF_processBlockModulated
+        for (int j = 0; j < n; ++j) fcs[j] = svf_clamp(freq[i + j], 0.0f, maxFreq);
+        for (int j = 0; j < n; ++j) gs[j] = svf_tan(fcs[j] * freqToAngle);
+        if (f->type == Bell) for (int j = 0; j < n; ++j) wls[j] = svf_tan(svf_clamp(fcs[j] * bandedge, 0.0f, maxFreq) * freqToAngle);
+        else for (int j = 0; j < n; ++j) wls[j] = 0.0f;
+        if (resonance != NULL) for (int j = 0; j < n; ++j) R2s[j] = 1.0f / svf_clamp(resonance[i + j], 0.01f, 100.0f);
+        else for (int j = 0; j < n; ++j) R2s[j] = f->R2;
+        
+        for (int j = 0; j < n; ++j)
+        {
+            f->fc = fcs[j];
+            f->R2 = R2s[j];
+            vzfilter_setCoeffs(f, gs[j], wls[j]);
+            out[i + j] = vzfilter_tick(f, in[i + j]);
+        }
+    }
+    svf_checkState(&f->s1, &f->s2, out, size);
+    
+    // Leave the filter set to the last sample
+    if (resonance != NULL && size > 0)
+    {
+        f->Q = LEAF_clip(0.01f, resonance[size - 1], 100.0f);
+        f->R2 = 1.0f / f->Q;
+    }
+    vzfilter_calcCoeffs(f);
+}
+
 void   tVZFilter_calcCoeffsEfficientBP           (tVZFilter* const vf)
 {
     _tVZFilter* f = *vf;
@@ -1933,3 +2859,659 @@ void    tLadderFilter_setSampleRate(tLadderFilter* const vf, float sr)
     f->c = tanf(PI * f->cutoff * f->invSampleRate);
 }
 
+//================================================================================
+
+// The banks keep FILTERBANK_LANES voices to a group, and work through each
+// group lane by lane, so that the same step of every voice in the group is
+// computed at once. Voices past numVoices fill out the last group; they are
+// fed silence and their outputs ignored.
+
+static float* filterbank_allocVoices(int numGroups, _tMempool* const m)
+{
+    return (float*) mpool_calloc_aligned(sizeof(float) * numGroups * FILTERBANK_LANES, MPOOL_CACHE_LINE_SIZE, m);
+}
+
+// tanh to within 1e-4, as the same Pade approximation as fast_tanh, held at
+// 1 from where it reaches it. The sign and the limit are handled on the bits
+// so that it can be computed across voices, where calling tanhf for each of
+// them would cost more than the filters do.
+static inline float filterbank_tanh(float x)
+{
+    union { float f; uint32_t i; } v = { x };
+    uint32_t sign = v.i & 0x80000000u;
+    v.i ^= sign;
+    float a = svf_clamp(v.f, 0.0f, 4.97f);
+    float a2 = a * a;
+    v.f = a * (135135.0f + a2 * (17325.0f + a2 * (378.0f + a2))) / (135135.0f + a2 * (62370.0f + a2 * (3150.0f + a2 * 28.0f)));
+    v.i |= sign;
+    return v.f;
+}
+
+// Sets the coefficients of one voice from its cutoff and Q
+static void svfbank_setCoeffs(_tSVFBank* const c, _tSVFLanes* const g, int l)
+{
+    g->g[l] = tanf(PI * g->cutoff[l] * c->invSampleRate);
+    g->a1[l] = 1.0f/(1.0f + g->g[l] * (g->g[l] + g->k[l]));
+    g->a2[l] = g->g[l] * g->a1[l];
+    g->a3[l] = g->g[l] * g->a2[l];
+}
+
+void    tSVFBank_init(tSVFBank* const bank, SVFType type, int numVoices, float freq, float Q, LEAF* const leaf)
+{
+    tSVFBank_initToPool(bank, type, numVoices, freq, Q, &leaf->mempool);
+}
+
+void    tSVFBank_initToPool(tSVFBank* const bank, SVFType type, int numVoices, float freq, float Q, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tSVFBank* c = *bank = (_tSVFBank*) mpool_alloc(sizeof(_tSVFBank), m);
+    c->mempool = m;
+    
+    LEAF* leaf = c->mempool->leaf;
+    
+    c->sampleRate = leaf->sampleRate;
+    c->invSampleRate = leaf->invSampleRate;
+    c->type = type;
+    svf_mix(type, &c->cH, &c->cB, &c->cBK, &c->cL);
+    
+    c->numVoices = numVoices;
+    c->numGroups = (numVoices + FILTERBANK_LANES - 1) / FILTERBANK_LANES;
+    c->voices = (_tSVFLanes*) mpool_calloc_aligned(sizeof(_tSVFLanes) * c->numGroups, MPOOL_CACHE_LINE_SIZE, m);
+    c->x = filterbank_allocVoices(c->numGroups, m);
+    c->y = filterbank_allocVoices(c->numGroups, m);
+    c->fc = filterbank_allocVoices(c->numGroups, m);
+    
+    for (int v = 0; v < c->numGroups * FILTERBANK_LANES; ++v)
+    {
+        _tSVFLanes* g = &c->voices[v / FILTERBANK_LANES];
+        int l = v % FILTERBANK_LANES;
+        g->Q[l] = Q;
+        g->k[l] = 1.0f / Q;
+        g->cutoff[l] = LEAF_clip(0.0f, freq, c->sampleRate * 0.5f);
+        g->ic1eq[l] = 0.0f;
+        g->ic2eq[l] = 0.0f;
+        svfbank_setCoeffs(c, g, l);
+        c->fc[v] = g->cutoff[l];
+    }
+}
+
+void    tSVFBank_free(tSVFBank* const bank)
+{
+    _tSVFBank* c = *bank;
+    
+    mpool_free((char*)c->fc, c->mempool);
+    mpool_free((char*)c->y, c->mempool);
+    mpool_free((char*)c->x, c->mempool);
+    mpool_free((char*)c->voices, c->mempool);
+    mpool_free((char*)c, c->mempool);
+}
+
+// Runs one sample of every voice from c->x to c->y
+static void svfbank_tick(_tSVFBank* const c)
+{
+    float cH = c->cH, cB = c->cB, cBK = c->cBK, cL = c->cL;
+    
+    for (int vg = 0; vg < c->numGroups; ++vg)
+    {
+        _tSVFLanes* g = &c->voices[vg];
+        const float* x = c->x + vg * FILTERBANK_LANES;
+        float* y = c->y + vg * FILTERBANK_LANES;
+        
+        for (int l = 0; l < FILTERBANK_LANES; ++l)
+        {
+            float v0 = x[l];
+            float v3 = v0 - g->ic2eq[l];
+            float v1 = (g->a1[l] * g->ic1eq[l]) + (g->a2[l] * v3);
+            float v2 = g->ic2eq[l] + (g->a2[l] * g->ic1eq[l]) + (g->a3[l] * v3);
+            g->ic1eq[l] = (2.0f * v1) - g->ic1eq[l];
+            g->ic2eq[l] = (2.0f * v2) - g->ic2eq[l];
+            y[l] = (v0 * cH) + (v1 * cB) + (g->k[l] * v1 * cBK) + (v2 * cL);
+        }
+    }
+}
+
+// Sets the cutoff of every voice from c->fc
+static void svfbank_setFreqs(_tSVFBank* const c)
+{
+    float maxFreq = c->sampleRate * 0.5f;
+    float freqToAngle = PI * c->invSampleRate;
+    
+    for (int vg = 0; vg < c->numGroups; ++vg)
+    {
+        _tSVFLanes* g = &c->voices[vg];
+        const float* fc = c->fc + vg * FILTERBANK_LANES;
+        
+        for (int l = 0; l < FILTERBANK_LANES; ++l)
+        {
+            g->cutoff[l] = svf_clamp(fc[l], 0.0f, maxFreq);
+            g->g[l] = svf_tan(g->cutoff[l] * freqToAngle);
+            g->a1[l] = 1.0f / (1.0f + g->g[l] * (g->g[l] + g->k[l]));
+            g->a2[l] = g->g[l] * g->a1[l];
+            g->a3[l] = g->g[l] * g->a2[l];
+        }
+    }
+}
+
+void    tSVFBank_tick(tSVFBank* const bank, const float* const in, float* const out)
+{
+    _tSVFBank* c = *bank;
+    
+    for (int v = 0; v < c->numVoices; ++v) c->x[v] = in[v];
+    svfbank_tick(c);
+    for (int v = 0; v < c->numVoices; ++v)
+    {
+        _tSVFLanes* g = &c->voices[v / FILTERBANK_LANES];
+        out[v] = isnan(g->ic1eq[v % FILTERBANK_LANES]) ? 0.0f : c->y[v];
+    }
+}
+
+// Resets and silences the voices that have blown up during a block
+static void svfbank_checkState(_tSVFBank* const c, float** const out, int size)
+{
+    for (int v = 0; v < c->numVoices; ++v)
+    {
+        _tSVFLanes* g = &c->voices[v / FILTERBANK_LANES];
+        int l = v % FILTERBANK_LANES;
+        svf_checkState(&g->ic1eq[l], &g->ic2eq[l], out[v], size);
+    }
+}
+
+void    tSVFBank_processBlock(tSVFBank* const bank, float** const in, float** const out, int size)
+{
+    _tSVFBank* c = *bank;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        for (int v = 0; v < c->numVoices; ++v) c->x[v] = in[v][i];
+        svfbank_tick(c);
+        for (int v = 0; v < c->numVoices; ++v) out[v][i] = c->y[v];
+    }
+    svfbank_checkState(c, out, size);
+}
+
+void    tSVFBank_processBlockModulated(tSVFBank* const bank, float** const in, float** const freq, float** const out, int size)
+{
+    _tSVFBank* c = *bank;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        for (int v = 0; v < c->numVoices; ++v)
+        {
+            c->x[v] = in[v][i];
+            c->fc[v] = freq[v][i];
+        }
+        svfbank_setFreqs(c);
+        svfbank_tick(c);
+        for (int v = 0; v < c->numVoices; ++v) out[v][i] = c->y[v];
+    }
+    svfbank_checkState(c, out, size);
+}
+
+void    tSVFBank_setFreq(tSVFBank* const bank, int voice, float freq)
+{
+    _tSVFBank* c = *bank;
+    if (voice < 0 || voice >= c->numVoices) return;
+    
+    _tSVFLanes* g = &c->voices[voice / FILTERBANK_LANES];
+    int l = voice % FILTERBANK_LANES;
+    g->cutoff[l] = LEAF_clip(0.0f, freq, c->sampleRate * 0.5f);
+    svfbank_setCoeffs(c, g, l);
+}
+
+void    tSVFBank_setQ(tSVFBank* const bank, int voice, float Q)
+{
+    _tSVFBank* c = *bank;
+    if (voice < 0 || voice >= c->numVoices) return;
+    
+    _tSVFLanes* g = &c->voices[voice / FILTERBANK_LANES];
+    int l = voice % FILTERBANK_LANES;
+    g->Q[l] = Q;
+    g->k[l] = 1.0f/Q;
+    g->a1[l] = 1.0f/(1.0f + g->g[l] * (g->g[l] + g->k[l]));
+    g->a2[l] = g->g[l] * g->a1[l];
+    g->a3[l] = g->g[l] * g->a2[l];
+}
+
+void    tSVFBank_setSampleRate(tSVFBank* const bank, float sr)
+{
+    _tSVFBank* c = *bank;
+    c->sampleRate = sr;
+    c->invSampleRate = 1.0f/c->sampleRate;
+    
+    for (int vg = 0; vg < c->numGroups; ++vg)
+    {
+        _tSVFLanes* g = &c->voices[vg];
+        for (int l = 0; l < FILTERBANK_LANES; ++l)
+        {
+            // A cutoff above the new Nyquist would put tan past its pole
+            g->cutoff[l] = LEAF_clip(0.0f, g->cutoff[l], c->sampleRate * 0.5f);
+            svfbank_setCoeffs(c, g, l);
+        }
+    }
+}
+
+//================================================================================
+
+void    tDiodeFilterBank_init(tDiodeFilterBank* const bank, int numVoices, float freq, float Q, LEAF* const leaf)
+{
+    tDiodeFilterBank_initToPool(bank, numVoices, freq, Q, &leaf->mempool);
+}
+
+void    tDiodeFilterBank_initToPool(tDiodeFilterBank* const bank, int numVoices, float freq, float Q, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tDiodeFilterBank* c = *bank = (_tDiodeFilterBank*) mpool_alloc(sizeof(_tDiodeFilterBank), m);
+    c->mempool = m;
+    
+    LEAF* leaf = c->mempool->leaf;
+    
+    c->invSampleRate = leaf->invSampleRate;
+    // Vt = 0.5 and n = 1.836, as in tDiodeFilter
+    float Vt = 0.5f;
+    float gamma = Vt * 1.836f;
+    c->g0inv = 1.f/(2.f*Vt);
+    c->g1inv = 1.f/(2.f*gamma);
+    c->g2inv = 1.f/(6.f*gamma);
+    
+    c->numVoices = numVoices;
+    c->numGroups = (numVoices + FILTERBANK_LANES - 1) / FILTERBANK_LANES;
+    c->voices = (_tDiodeLanes*) mpool_calloc_aligned(sizeof(_tDiodeLanes) * c->numGroups, MPOOL_CACHE_LINE_SIZE, m);
+    c->x = filterbank_allocVoices(c->numGroups, m);
+    c->y = filterbank_allocVoices(c->numGroups, m);
+    c->fc = filterbank_allocVoices(c->numGroups, m);
+    
+    for (int v = 0; v < c->numGroups * FILTERBANK_LANES; ++v)
+    {
+        _tDiodeLanes* g = &c->voices[v / FILTERBANK_LANES];
+        int l = v % FILTERBANK_LANES;
+        g->cutoff[l] = LEAF_clip(40.0f, freq, 18000.0f);
+        g->f[l] = tanf(PI * g->cutoff[l] * c->invSampleRate);
+        g->r[l] = LEAF_clip(0.5f, (7.0f * Q + 0.5f), 8.0f);
+        g->zi[l] = 0.0f;
+        g->s0[l] = 0.01f;
+        g->s1[l] = 0.02f;
+        g->s2[l] = 0.03f;
+        g->s3[l] = 0.04f;
+        c->fc[v] = g->cutoff[l];
+    }
+}
+
+void    tDiodeFilterBank_free(tDiodeFilterBank* const bank)
+{
+    _tDiodeFilterBank* c = *bank;
+    
+    mpool_free((char*)c->fc, c->mempool);
+    mpool_free((char*)c->y, c->mempool);
+    mpool_free((char*)c->x, c->mempool);
+    mpool_free((char*)c->voices, c->mempool);
+    mpool_free((char*)c, c->mempool);
+}
+
+// tanhXdX without the check for a zero denominator, which can't happen, so
+// that it can be computed across voices
+static inline float diodebank_tanhXdX(float x)
+{
+    float a = x*x;
+    return ((a + 105.0f)*a + 945.0f) / ((15.0f*a + 420.0f)*a + 945.0f);
+}
+
+// Runs one sample of every voice from c->x to c->y. The cutoff is kept at
+// 40 Hz or more, so the t factors and the denominator are never zero and
+// tDiodeFilter_tick's guards for them are left out.
+static void diodebank_tick(_tDiodeFilterBank* const c)
+{
+    float g0inv = c->g0inv, g1inv = c->g1inv, g2inv = c->g2inv;
+    
+    for (int vg = 0; vg < c->numGroups; ++vg)
+    {
+        _tDiodeLanes* g = &c->voices[vg];
+        const float* x = c->x + vg * FILTERBANK_LANES;
+        float* y = c->y + vg * FILTERBANK_LANES;
+        
+        for (int l = 0; l < FILTERBANK_LANES; ++l)
+        {
+            float in = x[l];
+            float f = g->f[l], r = g->r[l];
+            float s0 = g->s0[l], s1 = g->s1[l], s2 = g->s2[l], s3 = g->s3[l];
+            float ih = 0.5f * (in + g->zi[l]);
+            
+            float t0 = f*diodebank_tanhXdX((ih - r * s3)*g0inv)*g0inv;
+            float t1 = f*diodebank_tanhXdX((s1-s0)*g1inv)*g1inv;
+            float t2 = f*diodebank_tanhXdX((s2-s1)*g1inv)*g1inv;
+            float t3 = f*diodebank_tanhXdX((s3-s2)*g1inv)*g1inv;
+            float t4 = f*diodebank_tanhXdX((s3)*g2inv)*g2inv;
+            
+            float y3 = (s2 + s3 + t2*(s1 + s2 + s3 + t1*(s0 + s1 + s2 + s3 + t0*in)) + t1*(2.0f*s2 + 2.0f*s3))*t3 + s3 + 2.0f*s3*t1 + t2*(2.0f*s3 + 3.0f*s3*t1);
+            y3 = y3 / ((t4 + t1*(2.0f*t4 + 4.0f) + t2*(t4 + t1*(t4 + r*t0 + 4.0f) + 3.0f) + 2.0f)*t3 + t4 + t1*(2.0f*t4 + 2.0f) + t2*(2.0f*t4 + t1*(3.0f*t4 + 3.0f) + 2.0f) + 1.0f);
+            float y2 = (s3 - (1+t4+t3)*y3) / (-t3);
+            float y1 = (s2 - (1+t3+t2)*y2 + t3*y3) / (-t2);
+            float y0 = (s1 - (1+t2+t1)*y1 + t2*y2) / (-t1);
+            float xx = (in - r*y3);
+            
+            g->s0[l] = s0 + 2.0f * (t0*xx + t1*(y1-y0));
+            g->s1[l] = s1 + 2.0f * (t2*(y2-y1) - t1*(y1-y0));
+            g->s2[l] = s2 + 2.0f * (t3*(y3-y2) - t2*(y2-y1));
+            g->s3[l] = s3 + 2.0f * (-t4*(y3) - t3*(y3-y2));
+            g->zi[l] = in;
+            y[l] = filterbank_tanh(y3*r);
+        }
+    }
+}
+
+// Sets the cutoff of every voice from c->fc
+static void diodebank_setFreqs(_tDiodeFilterBank* const c)
+{
+    float freqToAngle = PI * c->invSampleRate;
+    
+    for (int vg = 0; vg < c->numGroups; ++vg)
+    {
+        _tDiodeLanes* g = &c->voices[vg];
+        const float* fc = c->fc + vg * FILTERBANK_LANES;
+        
+        for (int l = 0; l < FILTERBANK_LANES; ++l)
+        {
+            g->cutoff[l] = svf_clamp(fc[l], 40.0f, 18000.0f);
+            g->f[l] = svf_tan(g->cutoff[l] * freqToAngle);
+        }
+    }
+}
+
+void    tDiodeFilterBank_tick(tDiodeFilterBank* const bank, const float* const in, float* const out)
+{
+    _tDiodeFilterBank* c = *bank;
+    
+    for (int v = 0; v < c->numVoices; ++v) c->x[v] = in[v];
+    diodebank_tick(c);
+    for (int v = 0; v < c->numVoices; ++v) out[v] = c->y[v];
+}
+
+void    tDiodeFilterBank_processBlock(tDiodeFilterBank* const bank, float** const in, float** const out, int size)
+{
+    _tDiodeFilterBank* c = *bank;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        for (int v = 0; v < c->numVoices; ++v) c->x[v] = in[v][i];
+        diodebank_tick(c);
+        for (int v = 0; v < c->numVoices; ++v) out[v][i] = c->y[v];
+    }
+}
+
+void    tDiodeFilterBank_processBlockModulated(tDiodeFilterBank* const bank, float** const in, float** const freq, float** const out, int size)
+{
+    _tDiodeFilterBank* c = *bank;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        for (int v = 0; v < c->numVoices; ++v)
+        {
+            c->x[v] = in[v][i];
+            c->fc[v] = freq[v][i];
+        }
+        diodebank_setFreqs(c);
+        diodebank_tick(c);
+        for (int v = 0; v < c->numVoices; ++v) out[v][i] = c->y[v];
+    }
+}
+
+void    tDiodeFilterBank_setFreq(tDiodeFilterBank* const bank, int voice, float cutoff)
+{
+    _tDiodeFilterBank* c = *bank;
+    if (voice < 0 || voice >= c->numVoices) return;
+    
+    _tDiodeLanes* g = &c->voices[voice / FILTERBANK_LANES];
+    int l = voice % FILTERBANK_LANES;
+    g->cutoff[l] = LEAF_clip(40.0f, cutoff, 18000.0f);
+    g->f[l] = tanf(PI * g->cutoff[l] * c->invSampleRate);
+}
+
+void    tDiodeFilterBank_setQ(tDiodeFilterBank* const bank, int voice, float resonance)
+{
+    _tDiodeFilterBank* c = *bank;
+    if (voice < 0 || voice >= c->numVoices) return;
+    
+    c->voices[voice / FILTERBANK_LANES].r[voice % FILTERBANK_LANES] = LEAF_clip(0.5f, (7.0f * resonance + 0.5f), 8.0f);
+}
+
+void    tDiodeFilterBank_setSampleRate(tDiodeFilterBank* const bank, float sr)
+{
+    _tDiodeFilterBank* c = *bank;
+    c->invSampleRate = 1.0f/sr;
+    
+    for (int vg = 0; vg < c->numGroups; ++vg)
+    {
+        _tDiodeLanes* g = &c->voices[vg];
+        for (int l = 0; l < FILTERBANK_LANES; ++l) g->f[l] = tanf(PI * g->cutoff[l] * c->invSampleRate);
+    }
+}
+
+//================================================================================
+
+void    tLadderFilterBank_init(tLadderFilterBank* const bank, int numVoices, float freq, float Q, LEAF* const leaf)
+{
+    tLadderFilterBank_initToPool(bank, numVoices, freq, Q, &leaf->mempool);
+}
+
+void    tLadderFilterBank_initToPool(tLadderFilterBank* const bank, int numVoices, float freq, float Q, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tLadderFilterBank* c = *bank = (_tLadderFilterBank*) mpool_alloc(sizeof(_tLadderFilterBank), m);
+    c->mempool = m;
+    
+    LEAF* leaf = c->mempool->leaf;
+    
+    c->invSampleRate = leaf->invSampleRate;
+    c->oversampling = 1;
+    // shaper coefficients, as in tLadderFilter
+    c->a = 2.0f;
+    c->s = 0.1f;
+    c->d = 1.0f;
+    
+    c->numVoices = numVoices;
+    c->numGroups = (numVoices + FILTERBANK_LANES - 1) / FILTERBANK_LANES;
+    c->voices = (_tLadderLanes*) mpool_calloc_aligned(sizeof(_tLadderLanes) * c->numGroups, MPOOL_CACHE_LINE_SIZE, m);
+    c->x = filterbank_allocVoices(c->numGroups, m);
+    c->y = filterbank_allocVoices(c->numGroups, m);
+    c->fc = filterbank_allocVoices(c->numGroups, m);
+    
+    for (int v = 0; v < c->numGroups * FILTERBANK_LANES; ++v)
+    {
+        _tLadderLanes* g = &c->voices[v / FILTERBANK_LANES];
+        int l = v % FILTERBANK_LANES;
+        g->cutoff[l] = LEAF_clip(40.0f, freq, 18000.0f);
+        g->c[l] = tanf(PI * (g->cutoff[l] / (float)c->oversampling) * c->invSampleRate);
+        g->c2[l] = 2.0f * g->c[l];
+        g->fb[l] = LEAF_clip(0.2f, Q, 24.0f);
+        g->compensation[l] = 1.0f + smoothclip(g->fb[l], 0.0f, 4.0f);
+        g->b0[l] = 0.01f;
+        g->b1[l] = 0.02f;
+        g->b2[l] = 0.03f;
+        g->b3[l] = 0.04f;
+        c->fc[v] = g->cutoff[l];
+    }
+}
+
+void    tLadderFilterBank_free(tLadderFilterBank* const bank)
+{
+    _tLadderFilterBank* c = *bank;
+    
+    mpool_free((char*)c->fc, c->mempool);
+    mpool_free((char*)c->y, c->mempool);
+    mpool_free((char*)c->x, c->mempool);
+    mpool_free((char*)c->voices, c->mempool);
+    mpool_free((char*)c, c->mempool);
+}
+
+// Runs one sample of every voice from c->x to c->y, solving the stages
+// c->oversampling times on the same input as tLadderFilter_tick does. The
+// feedback clipper calls sqrtf, which keeps the loop it is in from being
+// vectorized, so it gets a loop of its own between the ones that solve the stages.
+static void ladderbank_tick(_tLadderFilterBank* const c)
+{
+    float a = c->a, d = c->d, s = c->s;
+    
+    for (int vg = 0; vg < c->numGroups; ++vg)
+    {
+        _tLadderLanes* g = &c->voices[vg];
+        const float* x = c->x + vg * FILTERBANK_LANES;
+        float* y = c->y + vg * FILTERBANK_LANES;
+        
+        for (int os = 0; os < c->oversampling; ++os)
+        {
+            float t0[FILTERBANK_LANES], t1[FILTERBANK_LANES], t2[FILTERBANK_LANES], t3[FILTERBANK_LANES];
+            float g0[FILTERBANK_LANES], g1[FILTERBANK_LANES], g2[FILTERBANK_LANES], g3[FILTERBANK_LANES];
+            float fbEstimate[FILTERBANK_LANES], cgfbr[FILTERBANK_LANES];
+            
+            for (int l = 0; l < FILTERBANK_LANES; ++l)
+            {
+                float in = x[l] + 0.015f;
+                float fc = g->c[l];
+                
+                t0[l] = tanhd(g->b0[l] + a, d, s);
+                t1[l] = tanhd(g->b1[l] + a, d, s);
+                t2[l] = tanhd(g->b2[l] + a, d, s);
+                t3[l] = tanhd(g->b3[l] + a, d, s);
+                
+                g0[l] = 1.0f / (1.0f + fc*t0[l]);
+                g1[l] = 1.0f / (1.0f + fc*t1[l]);
+                g2[l] = 1.0f / (1.0f + fc*t2[l]);
+                g3[l] = 1.0f / (1.0f + fc*t3[l]);
+                
+                float z0 = fc*t0[l] / (1.0f + fc*t0[l]);
+                float z1 = fc*t1[l] / (1.0f + fc*t1[l]);
+                float z2 = fc*t2[l] / (1.0f + fc*t2[l]);
+                float z3 = fc*t3[l] / (1.0f + fc*t3[l]);
+                
+                float f3 = fc       * t2[l]*g3[l];
+                float f2 = fc*fc     * t1[l]*g2[l] * t2[l]*g3[l];
+                float f1 = fc*fc*fc   * t0[l]*g1[l] * t1[l]*g2[l] * t2[l]*g3[l];
+                float f0 = fc*fc*fc*fc *    g0[l] * t0[l]*g1[l] * t1[l]*g2[l] * t2[l]*g3[l];
+                
+                float estimate =
+                g3[l] * g->b3[l] +
+                f3 * g2[l] * g->b2[l] +
+                f2 * g1[l] * g->b1[l] +
+                f1 * g0[l] * g->b0[l] +
+                f0 * in;
+                
+                fbEstimate[l] = g->fb[l] * estimate;
+                cgfbr[l] = 1.0f / (1.0f + g->fb[l] * z0*z1*z2*z3);
+            }
+            
+            for (int l = 0; l < FILTERBANK_LANES; ++l) fbEstimate[l] = smoothclip(fbEstimate[l], -1.0f, 1.0f);
+            
+            for (int l = 0; l < FILTERBANK_LANES; ++l)
+            {
+                float in = x[l] + 0.015f;
+                float fc = g->c[l];
+                float xx = in - fbEstimate[l] * cgfbr[l];
+                float y0 = t0[l] * g0[l] * (g->b0[l] + fc * xx);
+                float y1 = t1[l] * g1[l] * (g->b1[l] + fc * y0);
+                float y2 = t2[l] * g2[l] * (g->b2[l] + fc * y1);
+                float y3 = t3[l] * g3[l] * (g->b3[l] + fc * y2);
+                
+                g->b0[l] += g->c2[l] * (xx - y0);
+                g->b1[l] += g->c2[l] * (y0 - y1);
+                g->b2[l] += g->c2[l] * (y1 - y2);
+                g->b3[l] += g->c2[l] * (y2 - y3);
+                y[l] = y3 * g->compensation[l];
+            }
+        }
+    }
+}
+
+// Sets the cutoff of every voice from c->fc
+static void ladderbank_setFreqs(_tLadderFilterBank* const c)
+{
+    float freqToAngle = PI * c->invSampleRate / (float)c->oversampling;
+    
+    for (int vg = 0; vg < c->numGroups; ++vg)
+    {
+        _tLadderLanes* g = &c->voices[vg];
+        const float* fc = c->fc + vg * FILTERBANK_LANES;
+        
+        for (int l = 0; l < FILTERBANK_LANES; ++l)
+        {
+            g->cutoff[l] = svf_clamp(fc[l], 40.0f, 18000.0f);
+            g->c[l] = svf_tan(g->cutoff[l] * freqToAngle);
+            g->c2[l] = 2.0f * g->c[l];
+        }
+    }
+}
+
+void    tLadderFilterBank_tick(tLadderFilterBank* const bank, const float* const in, float* const out)
+{
+    _tLadderFilterBank* c = *bank;
+    
+    for (int v = 0; v < c->numVoices; ++v) c->x[v] = in[v];
+    ladderbank_tick(c);
+    for (int v = 0; v < c->numVoices; ++v) out[v] = c->y[v];
+}
+
+void    tLadderFilterBank_processBlock(tLadderFilterBank* const bank, float** const in, float** const out, int size)
+{
+    _tLadderFilterBank* c = *bank;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        for (int v = 0; v < c->numVoices; ++v) c->x[v] = in[v][i];
+        ladderbank_tick(c);
+        for (int v = 0; v < c->numVoices; ++v) out[v][i] = c->y[v];
+    }
+}
+
+void    tLadderFilterBank_processBlockModulated(tLadderFilterBank* const bank, float** const in, float** const freq, float** const out, int size)
+{
+    _tLadderFilterBank* c = *bank;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        for (int v = 0; v < c->numVoices; ++v)
+        {
+            c->x[v] = in[v][i];
+            c->fc[v] = freq[v][i];
+        }
+        ladderbank_setFreqs(c);
+        ladderbank_tick(c);
+        for (int v = 0; v < c->numVoices; ++v) out[v][i] = c->y[v];
+    }
+}
+
+void    tLadderFilterBank_setFreq(tLadderFilterBank* const bank, int voice, float cutoff)
+{
+    _tLadderFilterBank* c = *bank;
+    if (voice < 0 || voice >= c->numVoices) return;
+    
+    _tLadderLanes* g = &c->voices[voice / FILTERBANK_LANES];
+    int l = voice % FILTERBANK_LANES;
+    g->cutoff[l] = LEAF_clip(40.0f, cutoff, 18000.0f);
+    g->c[l] = tanf(PI * (g->cutoff[l] / (float)c->oversampling) * c->invSampleRate);
+    g->c2[l] = 2.0f * g->c[l];
+}
+
+void    tLadderFilterBank_setQ(tLadderFilterBank* const bank, int voice, float resonance)
+{
+    _tLadderFilterBank* c = *bank;
+    if (voice < 0 || voice >= c->numVoices) return;
+    
+    _tLadderLanes* g = &c->voices[voice / FILTERBANK_LANES];
+    int l = voice % FILTERBANK_LANES;
+    g->fb[l] = LEAF_clip(0.2f, resonance, 24.0f);
+    g->compensation[l] = 1.0f + smoothclip(g->fb[l], 0.0f, 4.0f);
+}
+
+void    tLadderFilterBank_setSampleRate(tLadderFilterBank* const bank, float sr)
+{
+    _tLadderFilterBank* c = *bank;
+    c->invSampleRate = 1.0f/sr;
+    
+    for (int vg = 0; vg < c->numGroups; ++vg)
+    {
+        _tLadderLanes* g = &c->voices[vg];
+        for (int l = 0; l < FILTERBANK_LANES; ++l)
+        {
+            g->c[l] = tanf(PI * (g->cutoff[l] / (float)c->oversampling) * c->invSampleRate);
+            g->c2[l] = 2.0f * g->c[l];
+        }
+    }
+}
@@ -840,10 +840,15 @@ void place_step_dd(float *buffer, int index, float phase, float w, float scale)
     r -= (float)i;
     i &= MINBLEP_PHASE_MASK;  /* extreme modulation can cause i to be out-of-range */
     
-    while (i < MINBLEP_PHASES * STEP_DD_PULSE_LENGTH) {
-        buffer[index] += scale * (step_dd_table[i].value + r * step_dd_table[i].delta);
-        i += MINBLEP_PHASES;
-        index++;
+    /* i is now below MINBLEP_PHASES, so the pulse always spans STEP_DD_PULSE_LENGTH
+     * samples. Counting them out instead of testing i leaves a loop with a fixed
+     * trip count and independent iterations that the compiler can vectorize. */
+    const float_value_delta* table = &step_dd_table[i];
+    buffer += index;
+    for (int n = 0; n < STEP_DD_PULSE_LENGTH; ++n)
+    {
+        const float_value_delta* t = &table[n * MINBLEP_PHASES];
+        buffer[n] += scale * (t->value + r * t->delta);
     }
 }
 //----------------------------------------------------------------------------------------------------------
@@ -860,10 +865,13 @@ void place_slope_dd(float *buffer, int index, float phase, float w, float slope_
     
     slope_delta *= w;
     
-    while (i < MINBLEP_PHASES * SLOPE_DD_PULSE_LENGTH) {
-        buffer[index] += slope_delta * (slope_dd_table[i] + r * (slope_dd_table[i + 1] - slope_dd_table[i]));
-        i += MINBLEP_PHASES;
-        index++;
+    /* as in place_step_dd, the pulse always spans SLOPE_DD_PULSE_LENGTH samples */
+    const float* table = &slope_dd_table[i];
+    buffer += index;
+    for (int n = 0; n < SLOPE_DD_PULSE_LENGTH; ++n)
+    {
+        const float* t = &table[n * MINBLEP_PHASES];
+        buffer[n] += slope_delta * (t[0] + r * (t[1] - t[0]));
     }
 }
 #endif // LEAF_INCLUDE_MINBLEP_TABLES
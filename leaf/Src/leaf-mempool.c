@@ -1,475 +1,2178 @@
-
-/** mpool source significantly modified by Mike Mulshine, Jeff Snyder, et al., Princeton University Music Department **/
-
-/**
- In short, mpool is distributed under so called "BSD license",
- 
- Copyright (c) 2009-2010 Tatsuhiko Kubo <cubicdaiya@gmail.com>
- All rights reserved.
- 
- Redistribution and use in source and binary forms, with or without modification,
- are permitted provided that the following conditions are met:
- 
- * Redistributions of source code must retain the above copyright notice,
- this list of conditions and the following disclaimer.
- 
- * Redistributions in binary form must reproduce the above copyright notice,
- this list of conditions and the following disclaimer in the documentation
- and/or other materials provided with the distribution.
- 
- * Neither the name of the authors nor the names of its contributors
- may be used to endorse or promote products derived from this software
- without specific prior written permission.
- 
- THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
- "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
- LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
- A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
- OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
- SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
- TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
- PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
- LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
- NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
- SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
- */
-
-/* written with C99 style */
-
-#if _WIN32 || _WIN64
-
-#include "..\Inc\leaf-mempool.h"
-#include "..\leaf.h"
-
-#else
-
-#include "../Inc/leaf-mempool.h"
-#include "../leaf.h"
-
-#endif
-
-#include <stdlib.h>
-
-#if LEAF_DEBUG
-#include "../../TestPlugin/JuceLibraryCode/JuceHeader.h"
-#endif
-
-/**
- * private function
- */
-static inline size_t mpool_align(size_t size);
-static inline mpool_node_t* create_node(char* block_location, mpool_node_t* next, mpool_node_t* prev, size_t size, size_t header_size);
-static inline void delink_node(mpool_node_t* node);
-
-/**
- * create memory pool
- */
-void mpool_create (char* memory, size_t size, _tMempool* pool)
-{
-    pool->leaf->header_size = mpool_align(sizeof(mpool_node_t));
-    
-    pool->mpool = (char*)memory;
-    pool->usize  = 0;
-    pool->msize  = size;
-    
-    pool->head = create_node(pool->mpool, NULL, NULL, pool->msize - pool->leaf->header_size, pool->leaf->header_size);
-    
-    /*
-    for (int i = 0; i < pool->head->size; i++)
-    {
-        memory[i+leaf.header_size]=0;
-    }
-    */
-    //is zeroing out the memory necessary? This takes a long time on large pools - JS
-}
-
-void leaf_pool_init(LEAF* const leaf, char* memory, size_t size)
-{
-    mpool_create(memory, size, &leaf->_internal_mempool);
-    
-    leaf->mempool = &leaf->_internal_mempool;
-}
-
-/**
- * allocate memory from memory pool
- */
-char* mpool_alloc(size_t asize, _tMempool* pool)
-{
-    pool->leaf->allocCount++;
-#if LEAF_DEBUG
-    DBG("alloc " + String(asize));
-#endif
-#if LEAF_USE_DYNAMIC_ALLOCATION
-    char* temp = (char*) malloc(asize);
-    if (temp == NULL)
-    {
-        // allocation failed, exit from the program
-        fprintf(stderr, "Out of memory.\n");
-        exit(1);
-    }
-    if (pool->leaf->clearOnAllocation > 0)
-    {
-        memset(temp, 0, asize);
-    }
-    return temp;
-#else
-    // If the head is NULL, the mempool is full
-    if (pool->head == NULL)
-    {
-        if ((pool->msize - pool->usize) > asize)
-        {
-            LEAF_internalErrorCallback(pool->leaf, LEAFMempoolFragmentation);
-        }
-        else
-        {
-            LEAF_internalErrorCallback(pool->leaf, LEAFMempoolOverrun);
-        }
-        return NULL;
-    }
-    
-    // Should we alloc the first block large enough or check all blocks and pick the one closest in size?
-    size_t size_to_alloc = mpool_align(asize);
-    mpool_node_t* node_to_alloc = pool->head;
-    
-    // Traverse the free list for a large enough block
-    while (node_to_alloc->size < size_to_alloc)
-    {
-        node_to_alloc = node_to_alloc->next;
-        
-        // If we reach the end of the free list, there
-        // are no blocks large enough, return NULL
-        if (node_to_alloc == NULL)
-        {
-            if ((pool->msize - pool->usize) > asize)
-            {
-                LEAF_internalErrorCallback(pool->leaf, LEAFMempoolFragmentation);
-            }
-            else
-            {
-                LEAF_internalErrorCallback(pool->leaf, LEAFMempoolOverrun);
-            }
-            return NULL;
-        }
-    }
-    
-    // Create a new node after the node to be allocated if there is enough space
-    mpool_node_t* new_node;
-    size_t leftover = node_to_alloc->size - size_to_alloc;
-    node_to_alloc->size = size_to_alloc;
-    if (leftover > pool->leaf->header_size)
-    {
-        long offset = (char*) node_to_alloc - (char*) pool->mpool;
-        offset += pool->leaf->header_size + node_to_alloc->size;
-        new_node = create_node(&pool->mpool[offset],
-                               node_to_alloc->next,
-                               node_to_alloc->prev,
-                               leftover - pool->leaf->header_size, pool->leaf->header_size);
-    }
-    else
-    {
-        // Add any leftover space to the allocated node to avoid fragmentation
-        node_to_alloc->size += leftover;
-        
-        new_node = node_to_alloc->next;
-    }
-    
-    // Update the head if we are allocating the first node of the free list
-    // The head will be NULL if there is no space left
-    if (pool->head == node_to_alloc)
-    {
-        pool->head = new_node;
-    }
-    
-    // Remove the allocated node from the free list
-    delink_node(node_to_alloc);
-    
-    pool->usize += pool->leaf->header_size + node_to_alloc->size;
-    
-    if (pool->leaf->clearOnAllocation > 0)
-    {
-        char* new_pool = (char*)node_to_alloc->pool;
-        for (int i = 0; i < node_to_alloc->size; i++) new_pool[i] = 0;
-    }
-    
-    // Return the pool of the allocated node;
-    return node_to_alloc->pool;
-#endif
-}
-
-
-/**
- * allocate memory from memory pool and also clear that memory to be blank
- */
-char* mpool_calloc(size_t asize, _tMempool* pool)
-{
-    pool->leaf->allocCount++;
-#if LEAF_DEBUG
-    DBG("calloc " + String(asize));
-#endif
-#if LEAF_USE_DYNAMIC_ALLOCATION
-    char* ret = (char*) malloc(asize);
-    if (ret == NULL)
-    {
-        // allocation failed, exit from the program
-        fprintf(stderr, "Out of memory.\n");
-        exit(1);
-    }
-    memset(ret, 0, asize);
-    return ret;
-#else
-    // If the head is NULL, the mempool is full
-    if (pool->head == NULL)
-    {
-        if ((pool->msize - pool->usize) > asize)
-        {
-            LEAF_internalErrorCallback(pool->leaf, LEAFMempoolFragmentation);
-        }
-        else
-        {
-            LEAF_internalErrorCallback(pool->leaf, LEAFMempoolOverrun);
-        }
-        return NULL;
-    }
-    
-    // Should we alloc the first block large enough or check all blocks and pick the one closest in size?
-    size_t size_to_alloc = mpool_align(asize);
-    mpool_node_t* node_to_alloc = pool->head;
-    
-    // Traverse the free list for a large enough block
-    while (node_to_alloc->size < size_to_alloc)
-    {
-        node_to_alloc = node_to_alloc->next;
-        
-        // If we reach the end of the free list, there
-        // are no blocks large enough, return NULL
-        if (node_to_alloc == NULL)
-        {
-            if ((pool->msize - pool->usize) > asize)
-            {
-                LEAF_internalErrorCallback(pool->leaf, LEAFMempoolFragmentation);
-            }
-            else
-            {
-                LEAF_internalErrorCallback(pool->leaf, LEAFMempoolOverrun);
-            }
-            return NULL;
-        }
-    }
-    
-    // Create a new node after the node to be allocated if there is enough space
-    mpool_node_t* new_node;
-    size_t leftover = node_to_alloc->size - size_to_alloc;
-    node_to_alloc->size = size_to_alloc;
-    if (leftover > pool->leaf->header_size)
-    {
-        long offset = (char*) node_to_alloc - (char*) pool->mpool;
-        offset += pool->leaf->header_size + node_to_alloc->size;
-        new_node = create_node(&pool->mpool[offset],
-                               node_to_alloc->next,
-                               node_to_alloc->prev,
-                               leftover - pool->leaf->header_size, pool->leaf->header_size);
-    }
-    else
-    {
-        // Add any leftover space to the allocated node to avoid fragmentation
-        node_to_alloc->size += leftover;
-        
-        new_node = node_to_alloc->next;
-    }
-    
-    // Update the head if we are allocating the first node of the free list
-    // The head will be NULL if there is no space left
-    if (pool->head == node_to_alloc)
-    {
-        pool->head = new_node;
-    }
-    
-    // Remove the allocated node from the free list
-    delink_node(node_to_alloc);
-    
-    pool->usize += pool->leaf->header_size + node_to_alloc->size;
-    // Format the new pool
-    for (int i = 0; i < node_to_alloc->size; i++) node_to_alloc->pool[i] = 0;
-    // Return the pool of the allocated node;
-    return node_to_alloc->pool;
-#endif
-}
-
-char* leaf_alloc(LEAF* const leaf, size_t size)
-{
-    //printf("alloc %i\n", size);
-    return mpool_alloc(size, &leaf->_internal_mempool);
-}
-
-char* leaf_calloc(LEAF* const leaf, size_t size)
-{
-    //printf("alloc %i\n", size);
-    return mpool_calloc(size, &leaf->_internal_mempool);
-}
-
-void mpool_free(char* ptr, _tMempool* pool)
-{
-    pool->leaf->freeCount++;
-#if LEAF_DEBUG
-    DBG("free");
-#endif
-#if LEAF_USE_DYNAMIC_ALLOCATION
-    free(ptr);
-#else
-    //if (ptr < pool->mpool || ptr >= pool->mpool + pool->msize)
-    // Get the node at the freed space
-    mpool_node_t* freed_node = (mpool_node_t*) (ptr - pool->leaf->header_size);
-    
-    pool->usize -= pool->leaf->header_size + freed_node->size;
-    
-    // Check each node in the list against the newly freed one to see if it's adjacent in memory
-    mpool_node_t* other_node = pool->head;
-    mpool_node_t* next_node;
-    while (other_node != NULL)
-    {
-        if ((long) other_node < (long) pool->mpool ||
-            (long) other_node >= (((long) pool->mpool) + pool->msize))
-        {
-            LEAF_internalErrorCallback(pool->leaf, LEAFInvalidFree);
-            return;
-        }
-        next_node = other_node->next;
-        // Check if a node is directly after the freed node
-        if (((long) freed_node) + (pool->leaf->header_size + freed_node->size) == (long) other_node)
-        {
-            // Increase freed node's size
-            freed_node->size += pool->leaf->header_size + other_node->size;
-            // If we are merging with the head, move the head forward
-            if (other_node == pool->head) pool->head = pool->head->next;
-            // Delink the merged node
-            delink_node(other_node);
-        }
-        
-        // Check if a node is directly before the freed node
-        else if (((long) other_node) + (pool->leaf->header_size + other_node->size) == (long) freed_node)
-        {
-            // Increase the merging node's size
-            other_node->size += pool->leaf->header_size + freed_node->size;
-            
-            if (other_node != pool->head)
-            {
-                // Delink the merging node
-                delink_node(other_node);
-                // Attach the merging node to the head
-                other_node->next = pool->head;
-                // Merge
-                freed_node = other_node;
-            }
-            else
-            {
-                // If we are merging with the head, move the head forward
-                pool->head = pool->head->next;
-                // Merge
-                freed_node = other_node;
-            }
-        }
-        
-        other_node = next_node;
-    }
-    
-    // Ensure the freed node is attached to the head
-    freed_node->next = pool->head;
-    if (pool->head != NULL) pool->head->prev = freed_node;
-    pool->head = freed_node;
-    
-    // Format the freed pool
-    //    char* freed_pool = (char*)freed_node->pool;
-    //    for (int i = 0; i < freed_node->size; i++) freed_pool[i] = 0;
-#endif
-}
-
-void leaf_free(LEAF* const leaf, char* ptr)
-{
-    mpool_free(ptr, &leaf->_internal_mempool);
-}
-
-size_t mpool_get_size(_tMempool* pool)
-{
-    return pool->msize;
-}
-
-size_t mpool_get_used(_tMempool* pool)
-{
-    return pool->usize;
-}
-
-size_t leaf_pool_get_size(LEAF* const leaf)
-{
-    return mpool_get_size(&leaf->_internal_mempool);
-}
-
-size_t leaf_pool_get_used(LEAF* const leaf)
-{
-    return mpool_get_used(&leaf->_internal_mempool);
-}
-
-char* leaf_pool_get_pool(LEAF* const leaf)
-{
-    char* buff = leaf->_internal_mempool.mpool;
-    
-    return buff;
-}
-
-/**
- * align byte boundary
- */
-static inline size_t mpool_align(size_t size) {
-    return (size + (MPOOL_ALIGN_SIZE - 1)) & ~(MPOOL_ALIGN_SIZE - 1);
-}
-
-static inline mpool_node_t* create_node(char* block_location, mpool_node_t* next, mpool_node_t* prev, size_t size, size_t header_size)
-{
-    mpool_node_t* node = (mpool_node_t*)block_location;
-    node->pool = block_location + header_size;
-    node->next = next;
-    node->prev = prev;
-    node->size = size;
-    
-    return node;
-}
-
-static inline void delink_node(mpool_node_t* node)
-{
-    // If there is a node after the node to remove
-    if (node->next != NULL)
-    {
-        // Close the link
-        node->next->prev = node->prev;
-    }
-    // If there is a node before the node to remove
-    if (node->prev != NULL)
-    {
-        // Close the link
-        node->prev->next = node->next;
-    }
-    
-    node->next = NULL;
-    node->prev = NULL;
-}
-
-void tMempool_init(tMempool* const mp, char* memory, size_t size, LEAF* const leaf)
-{
-    tMempool_initToPool(mp, memory, size, &leaf->mempool);
-}
-
-void tMempool_free(tMempool* const mp)
-{
-    _tMempool* m = *mp;
-
-    mpool_free((char*)m, m->mempool);
-}
-
-void    tMempool_initToPool     (tMempool* const mp, char* memory, size_t size, tMempool* const mem)
-{
-    _tMempool* mm = *mem;
-    _tMempool* m = *mp = (_tMempool*) mpool_alloc(sizeof(_tMempool), mm);
-    m->leaf = mm->leaf;
-    
-    mpool_create (memory, size, m);
-}
-
+
+/** mpool source significantly modified by Mike Mulshine, Jeff Snyder, et al., Princeton University Music Department **/
+
+/**
+ In short, mpool is distributed under so called "BSD license",
+ 
+ Copyright (c) 2009-2010 Tatsuhiko Kubo <cubicdaiya@gmail.com>
+ All rights reserved.
+ 
+ Redistribution and use in source and binary forms, with or without modification,
+ are permitted provided that the following conditions are met:
+ 
+ * Redistributions of source code must retain the above copyright notice,
+ this list of conditions and the following disclaimer.
+ 
+ * Redistributions in binary form must reproduce the above copyright notice,
+ this list of conditions and the following disclaimer in the documentation
+ and/or other materials provided with the distribution.
+ 
+ * Neither the name of the authors nor the names of its contributors
+ may be used to endorse or promote products derived from this software
+ without specific prior written permission.
+ 
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* written with C99 style */
+
+// MAP_ANONYMOUS and friends are only declared by glibc when asked for
+#if defined(__linux__) && !defined(_DEFAULT_SOURCE)
+#define _DEFAULT_SOURCE
+#endif
+
+#if _WIN32 || _WIN64
+
+#include "..\Inc\leaf-mempool.h"
+#include "..\leaf.h"
+
+#else
+
+#include "../Inc/leaf-mempool.h"
+#include "../leaf.h"
+
+#endif
+
+#include <stdlib.h>
+#include <stdarg.h>
+
+#if LEAF_USE_MMAP
+#include <sys/mman.h>
+#include <unistd.h>
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif
+
+#if LEAF_MEMPOOL_TRACK_CALLERS && (defined(__GNUC__) || defined(__clang__))
+#define MPOOL_CALLER __builtin_return_address(0)
+#elif LEAF_MEMPOOL_TRACK_CALLERS && defined(_MSC_VER)
+#include <intrin.h>
+#pragma intrinsic(_ReturnAddress)
+#define MPOOL_CALLER _ReturnAddress()
+#else
+#define MPOOL_CALLER NULL
+#endif
+
+#if LEAF_DEBUG
+#include "../../TestPlugin/JuceLibraryCode/JuceHeader.h"
+#endif
+
+/**
+ * private function
+ */
+static inline size_t mpool_align(size_t size);
+static inline size_t mpool_alignment(size_t alignment);
+static inline mpool_node_t* create_node(char* block_location, mpool_node_t* next, mpool_node_t* prev, size_t size, size_t header_size);
+static inline void delink_node(mpool_node_t* node);
+static inline mpool_node_t* next_phys_node(mpool_node_t* node, _tMempool* pool);
+static inline void insert_free_node(mpool_node_t* node, _tMempool* pool);
+static inline void remove_free_node(mpool_node_t* node, _tMempool* pool);
+static inline void use_node(mpool_node_t* node, size_t size, _tMempool* pool);
+static inline void alloc_failed(size_t asize, _tMempool* pool);
+static inline void count_steps(unsigned int steps, _tMempool* pool);
+static inline void count_ticks(uint32_t start, uint32_t* total, uint32_t* max, _tMempool* pool);
+static inline mpool_node_t* first_phys_node(_tMempool* pool);
+
+static inline mpool_node_t* firstfit_find_node(size_t asize, _tMempool* pool);
+
+static inline char* arena_alloc(size_t asize, size_t alignment, _tMempool* pool);
+static inline mpool_node_t* align_node(mpool_node_t* node, size_t alignment, _tMempool* pool);
+static inline char* alloc_block(size_t asize, size_t alignment, _tMempool* pool);
+static inline char* locked_alloc_block(size_t asize, size_t alignment, _tMempool* pool);
+static inline char* pool_alloc(size_t asize, size_t alignment, int clear, void* caller, _tMempool* pool);
+static inline void free_block(char* ptr, _tMempool* pool);
+
+static inline void mpool_lock(_tMempool* pool);
+static inline void mpool_unlock(_tMempool* pool);
+static inline void count_event(unsigned int* counter, _tMempool* pool);
+
+static inline char* cache_alloc(size_t asize, size_t alignment, _tMempool* pool);
+static inline void cache_free(char* ptr, _tMempool* pool);
+static inline void cache_collect(_tMempool* pool);
+static inline void cache_flush(_tMempool* pool);
+
+static inline void release_block(char* ptr, _tMempool* pool);
+static inline char* slab_alloc(size_t asize, size_t alignment, _tMempool* pool);
+static inline void slab_free(char* ptr, _tMempool* pool);
+static inline int slab_owns(char* ptr, _tMempool* pool);
+#if LEAF_USE_MMAP
+static char* mapped_grow_alloc(size_t asize, size_t alignment, _tMempool* pool);
+static inline _tMempool* mapped_region_for(char* ptr, _tMempool* pool);
+static void mapped_unmap(_tMempool* pool);
+#endif
+static inline int defer_free(char* ptr, _tMempool* pool);
+static void defer_drain(LEAF* const leaf);
+static inline int mpool_is_arena(_tMempool* pool);
+#if LEAF_USE_DYNAMIC_ALLOCATION
+static char* dynamic_alloc(size_t asize, size_t alignment);
+static void dynamic_free(char* ptr);
+#endif
+
+static void tlsf_create(_tMempool* pool);
+static inline void tlsf_insert_node(_tMempool* pool, mpool_node_t* node);
+static inline void tlsf_remove_node(_tMempool* pool, mpool_node_t* node);
+static inline mpool_node_t* tlsf_find_node(size_t asize, _tMempool* pool);
+static inline int tlsf_can_merge(size_t size, _tMempool* pool);
+
+/**
+ * create memory pool
+ */
+void mpool_create (char* memory, size_t size, _tMempool* pool)
+{
+    mpool_create_with_type(memory, size, MempoolFirstFit, pool);
+}
+
+void mpool_create_with_type (char* memory, size_t size, MempoolType type, _tMempool* pool)
+{
+    pool->leaf->header_size = mpool_align(sizeof(mpool_node_t));
+    
+    pool->mpool = (char*)memory;
+    pool->usize  = 0;
+    pool->msize  = size;
+    pool->type = type;
+    pool->tlsf = NULL;
+    pool->alignment = MPOOL_ALIGN_SIZE;
+    pool->cache = NULL;
+    pool->concurrent = 0;
+    pool->lock = 0;
+    pool->slab = NULL;
+    memset(&pool->stats, 0, sizeof(mpool_stats_t));
+    pool->clock = NULL;
+#if LEAF_USE_MMAP
+    pool->map_flags = 0;
+    pool->map_base = NULL;
+    pool->map_size = 0;
+    pool->next = NULL;
+#endif
+    
+    if (type == MempoolTLSF)
+    {
+        tlsf_create(pool);
+        return;
+    }
+    
+    if (type == MempoolArena)
+    {
+        // Arena pools have no nodes, usize is the bump offset
+        pool->head = NULL;
+        return;
+    }
+    
+    pool->head = create_node(pool->mpool, NULL, NULL,
+                             (pool->msize - pool->leaf->header_size) & ~((size_t) MPOOL_ALIGN_SIZE - 1),
+                             pool->leaf->header_size);
+    
+    /*
+    for (int i = 0; i < pool->head->size; i++)
+    {
+        memory[i+leaf.header_size]=0;
+    }
+    */
+    //is zeroing out the memory necessary? This takes a long time on large pools - JS
+}
+
+void leaf_pool_init(LEAF* const leaf, char* memory, size_t size)
+{
+    mpool_create(memory, size, &leaf->_internal_mempool);
+    
+    leaf->mempool = &leaf->_internal_mempool;
+}
+
+/**
+ * allocate memory from memory pool
+ */
+char* mpool_alloc(size_t asize, _tMempool* pool)
+{
+#if LEAF_DEBUG
+    DBG("alloc " + String(asize));
+#endif
+    return pool_alloc(asize, pool->alignment, pool->leaf->clearOnAllocation > 0, MPOOL_CALLER, pool);
+}
+
+/**
+ * allocate memory from memory pool starting at a multiple of the given alignment
+ */
+char* mpool_alloc_aligned(size_t asize, size_t alignment, _tMempool* pool)
+{
+#if LEAF_DEBUG
+    DBG("alloc " + String(asize));
+#endif
+    return pool_alloc(asize, alignment, pool->leaf->clearOnAllocation > 0, MPOOL_CALLER, pool);
+}
+
+
+/**
+ * allocate memory from memory pool and also clear that memory to be blank
+ */
+char* mpool_calloc(size_t asize, _tMempool* pool)
+{
+#if LEAF_DEBUG
+    DBG("calloc " + String(asize));
+#endif
+    return pool_alloc(asize, pool->alignment, 1, MPOOL_CALLER, pool);
+}
+
+char* mpool_calloc_aligned(size_t asize, size_t alignment, _tMempool* pool)
+{
+#if LEAF_DEBUG
+    DBG("calloc " + String(asize));
+#endif
+    return pool_alloc(asize, alignment, 1, MPOOL_CALLER, pool);
+}
+
+char* leaf_alloc(LEAF* const leaf, size_t size)
+{
+    //printf("alloc %i\n", size);
+    return mpool_alloc(size, &leaf->_internal_mempool);
+}
+
+char* leaf_calloc(LEAF* const leaf, size_t size)
+{
+    //printf("alloc %i\n", size);
+    return mpool_calloc(size, &leaf->_internal_mempool);
+}
+
+void mpool_free(char* ptr, _tMempool* pool)
+{
+    count_event(&pool->leaf->freeCount, pool);
+    count_event(&pool->stats.frees, pool);
+#if LEAF_DEBUG
+    DBG("free");
+#endif
+    uint32_t start = (pool->clock != NULL) ? pool->clock() : 0;
+    
+    if (pool->leaf->deferredFrees == NULL || !defer_free(ptr, pool))
+    {
+        release_block(ptr, pool);
+    }
+    
+    if (pool->clock != NULL)
+    {
+        count_ticks(start, &pool->stats.free_ticks, &pool->stats.max_free_ticks, pool);
+    }
+}
+
+/**
+ * release every allocation in a memory pool at once
+ */
+void mpool_reset(_tMempool* pool)
+{
+#if LEAF_USE_DYNAMIC_ALLOCATION
+    // Everything else is allocated with malloc() and freed one by one
+    if (!mpool_is_arena(pool)) return;
+#endif
+    defer_drain(pool->leaf);
+    
+    // A thread cache has no memory of its own, just give back what it holds
+    if (pool->cache != NULL)
+    {
+        cache_flush(pool);
+        return;
+    }
+    
+    size_t alignment = pool->alignment;
+    int concurrent = pool->concurrent;
+    mpool_stats_t stats = pool->stats;
+    uint32_t (*clock)(void) = pool->clock;
+    size_t slab_size = (pool->slab != NULL) ? pool->slab->chunk_count * MPOOL_SLAB_CHUNK_SIZE : 0;
+#if LEAF_USE_MMAP
+    int map_flags = pool->map_flags;
+    char* map_base = pool->map_base;
+    size_t map_size = pool->map_size;
+    _tMempool* next = pool->next;
+#endif
+    if (concurrent) mpool_lock(pool);
+    // Recreating the pool also clears the lock
+    mpool_create_with_type(pool->mpool, pool->msize, pool->type, pool);
+    pool->alignment = alignment;
+    pool->concurrent = concurrent;
+    pool->stats = stats;
+    pool->clock = clock;
+#if LEAF_USE_MMAP
+    pool->map_flags = map_flags;
+    pool->map_base = map_base;
+    pool->map_size = map_size;
+    pool->next = next;
+    // Regions mapped as the pool grew stay mapped for reuse
+    if (next != NULL) mpool_reset(next);
+#endif
+    
+    // The slabs were part of the pool, so they need to be reserved again
+    if (slab_size > 0) mpool_reserve_slabs(slab_size, pool);
+}
+
+void leaf_free(LEAF* const leaf, char* ptr)
+{
+    mpool_free(ptr, &leaf->_internal_mempool);
+}
+
+size_t mpool_get_size(_tMempool* pool)
+{
+#if LEAF_USE_MMAP
+    if (pool->next != NULL) return pool->msize + mpool_get_size(pool->next);
+#endif
+    return pool->msize;
+}
+
+size_t mpool_get_used(_tMempool* pool)
+{
+#if LEAF_USE_MMAP
+    if (pool->next != NULL) return pool->usize + mpool_get_used(pool->next);
+#endif
+    return pool->usize;
+}
+
+size_t leaf_pool_get_size(LEAF* const leaf)
+{
+    return mpool_get_size(&leaf->_internal_mempool);
+}
+
+size_t leaf_pool_get_used(LEAF* const leaf)
+{
+    return mpool_get_used(&leaf->_internal_mempool);
+}
+
+char* leaf_pool_get_pool(LEAF* const leaf)
+{
+    char* buff = leaf->_internal_mempool.mpool;
+    
+    return buff;
+}
+
+/**
+ * align byte boundary
+ */
+static inline size_t mpool_align(size_t size) {
+    return (size + (MPOOL_ALIGN_SIZE - 1)) & ~(MPOOL_ALIGN_SIZE - 1);
+}
+
+/**
+ * round a requested alignment up to a power of two no smaller than MPOOL_ALIGN_SIZE
+ */
+static inline size_t mpool_alignment(size_t alignment) {
+    size_t a = MPOOL_ALIGN_SIZE;
+    while (a < alignment) a <<= 1;
+    return a;
+}
+
+static inline mpool_node_t* create_node(char* block_location, mpool_node_t* next, mpool_node_t* prev, size_t size, size_t header_size)
+{
+    mpool_node_t* node = (mpool_node_t*)block_location;
+    node->pool = block_location + header_size;
+    node->next = next;
+    node->prev = prev;
+    node->prev_phys = NULL;
+    node->size = size;
+    node->is_free = 1;
+    
+    return node;
+}
+
+static inline void delink_node(mpool_node_t* node)
+{
+    // If there is a node after the node to remove
+    if (node->next != NULL)
+    {
+        // Close the link
+        node->next->prev = node->prev;
+    }
+    // If there is a node before the node to remove
+    if (node->prev != NULL)
+    {
+        // Close the link
+        node->prev->next = node->next;
+    }
+    
+    node->next = NULL;
+    node->prev = NULL;
+}
+
+/**
+ * node directly after the given one in memory, or NULL at the end of the pool
+ */
+static inline mpool_node_t* next_phys_node(mpool_node_t* node, _tMempool* pool)
+{
+    char* next = node->pool + node->size;
+    if (next + pool->leaf->header_size > pool->mpool + pool->msize) return NULL;
+    return (mpool_node_t*) next;
+}
+
+static inline void insert_free_node(mpool_node_t* node, _tMempool* pool)
+{
+    if (pool->type == MempoolTLSF)
+    {
+        tlsf_insert_node(pool, node);
+        return;
+    }
+    
+    // Attach the node to the head
+    node->prev = NULL;
+    node->next = pool->head;
+    if (pool->head != NULL) pool->head->prev = node;
+    pool->head = node;
+    node->is_free = 1;
+}
+
+static inline void remove_free_node(mpool_node_t* node, _tMempool* pool)
+{
+    if (pool->type == MempoolTLSF)
+    {
+        tlsf_remove_node(pool, node);
+        return;
+    }
+    
+    // If we are removing the head, move the head forward
+    if (pool->head == node) pool->head = node->next;
+    delink_node(node);
+    node->is_free = 0;
+}
+
+/**
+ * take a free node off its free list for an allocation of the given (aligned) size,
+ * splitting off any leftover space large enough to hold another node
+ */
+static inline void use_node(mpool_node_t* node, size_t size, _tMempool* pool)
+{
+    size_t header_size = pool->leaf->header_size;
+    
+    remove_free_node(node, pool);
+    
+    size_t leftover = node->size - size;
+    if (leftover >= header_size + MPOOL_ALIGN_SIZE)
+    {
+        node->size = size;
+        mpool_node_t* new_node = create_node(node->pool + size, NULL, NULL,
+                                             leftover - header_size, header_size);
+        new_node->prev_phys = node;
+        mpool_node_t* next_node = next_phys_node(new_node, pool);
+        if (next_node != NULL) next_node->prev_phys = new_node;
+        insert_free_node(new_node, pool);
+    }
+    // Otherwise the leftover space stays with the allocated node to avoid fragmentation
+    
+    pool->usize += header_size + node->size;
+}
+
+static inline void alloc_failed(size_t asize, _tMempool* pool)
+{
+    pool->stats.failed_allocs++;
+    
+    if ((pool->msize - pool->usize) > asize)
+    {
+        LEAF_internalErrorCallback(pool->leaf, LEAFMempoolFragmentation);
+    }
+    else
+    {
+        LEAF_internalErrorCallback(pool->leaf, LEAFMempoolOverrun);
+    }
+}
+
+static inline mpool_node_t* firstfit_find_node(size_t asize, _tMempool* pool)
+{
+    // Should we alloc the first block large enough or check all blocks and pick the one closest in size?
+    size_t size_to_alloc = mpool_align(asize);
+    mpool_node_t* node_to_alloc = pool->head;
+    unsigned int steps = 1;
+    
+    // Traverse the free list for a large enough block. If the head is NULL
+    // or we reach the end of the free list, there are no blocks large enough
+    while (node_to_alloc != NULL && node_to_alloc->size < size_to_alloc)
+    {
+        node_to_alloc = node_to_alloc->next;
+        steps++;
+    }
+    
+    count_steps(steps, pool);
+    return node_to_alloc;
+}
+
+static inline char* arena_alloc(size_t asize, size_t alignment, _tMempool* pool)
+{
+    size_t size_to_alloc = mpool_align(asize);
+    
+    // Pad the bump offset up to the requested alignment
+    uintptr_t location = (uintptr_t) (pool->mpool + pool->usize);
+    size_t padding = (size_t) (((location + alignment - 1) & ~((uintptr_t) alignment - 1)) - location);
+    
+    if (padding + size_to_alloc > pool->msize - pool->usize)
+    {
+        pool->stats.failed_allocs++;
+        LEAF_internalErrorCallback(pool->leaf, LEAFMempoolOverrun);
+        return NULL;
+    }
+    
+    char* ret = pool->mpool + pool->usize + padding;
+    pool->usize += padding + size_to_alloc;
+    
+    return ret;
+}
+
+/**
+ * move the start of a free node forward so its pool is aligned, leaving the skipped
+ * space behind as a free node of its own. the node must have room for the worst case
+ * padding of header_size + alignment + MPOOL_ALIGN_SIZE bytes
+ */
+static inline mpool_node_t* align_node(mpool_node_t* node, size_t alignment, _tMempool* pool)
+{
+    size_t header_size = pool->leaf->header_size;
+    
+    if (((uintptr_t) node->pool & (alignment - 1)) == 0) return node;
+    
+    // The skipped space has to be big enough to hold a node
+    uintptr_t location = (uintptr_t) node->pool + header_size + MPOOL_ALIGN_SIZE;
+    char* aligned = (char*) ((location + alignment - 1) & ~((uintptr_t) alignment - 1));
+    size_t gap = aligned - node->pool;
+    
+    remove_free_node(node, pool);
+    
+    mpool_node_t* aligned_node = create_node(aligned - header_size, NULL, NULL, node->size - gap, header_size);
+    aligned_node->prev_phys = node;
+    mpool_node_t* next_node = next_phys_node(aligned_node, pool);
+    if (next_node != NULL) next_node->prev_phys = aligned_node;
+    
+    node->size = gap - header_size;
+    insert_free_node(node, pool);
+    insert_free_node(aligned_node, pool);
+    
+    return aligned_node;
+}
+
+/**
+ * find, take, and return a block of at least asize bytes
+ */
+static inline char* alloc_block(size_t asize, size_t alignment, _tMempool* pool)
+{
+    alignment = mpool_alignment(alignment);
+    
+    if (pool->type == MempoolArena) return arena_alloc(asize, alignment, pool);
+    
+    // Leave room to move the start of the node forward to an aligned position
+    size_t search_size = asize;
+    if (alignment > MPOOL_ALIGN_SIZE) search_size += pool->leaf->header_size + alignment + MPOOL_ALIGN_SIZE;
+    
+    mpool_node_t* node_to_alloc = (pool->type == MempoolTLSF) ?
+        tlsf_find_node(search_size, pool) : firstfit_find_node(search_size, pool);
+    
+    if (node_to_alloc == NULL)
+    {
+#if LEAF_USE_MMAP
+        if (pool->map_flags & MempoolMapGrow) return mapped_grow_alloc(asize, alignment, pool);
+#endif
+        alloc_failed(asize, pool);
+        return NULL;
+    }
+    
+    if (alignment > MPOOL_ALIGN_SIZE) node_to_alloc = align_node(node_to_alloc, alignment, pool);
+    
+    use_node(node_to_alloc, mpool_align(asize), pool);
+#if LEAF_MEMPOOL_COMPACTION
+    node_to_alloc->alignment = (unsigned int) alignment;
+    node_to_alloc->owner = NULL;
+#endif
+    
+    // Return the pool of the allocated node;
+    return node_to_alloc->pool;
+}
+
+/**
+ * return a block to the pool it was allocated from, merging it with free neighbours
+ */
+static inline void free_block(char* ptr, _tMempool* pool)
+{
+    // Arena memory is only released by resetting the whole pool
+    if (pool->type == MempoolArena) return;
+    
+    size_t header_size = pool->leaf->header_size;
+    
+    if (ptr < pool->mpool + header_size || ptr >= pool->mpool + pool->msize)
+    {
+        LEAF_internalErrorCallback(pool->leaf, LEAFInvalidFree);
+        return;
+    }
+    
+    // Get the node at the freed space
+    mpool_node_t* freed_node = (mpool_node_t*) (ptr - header_size);
+    if (freed_node->is_free)
+    {
+        LEAF_internalErrorCallback(pool->leaf, LEAFInvalidFree);
+        return;
+    }
+    
+    pool->usize -= header_size + freed_node->size;
+    
+    // The boundary tags give us the physical neighbours directly,
+    // so only those two need to be checked for merging
+    
+    // Check if the node directly after the freed node is free
+    mpool_node_t* other_node = next_phys_node(freed_node, pool);
+    if (other_node != NULL && other_node->is_free &&
+        tlsf_can_merge(freed_node->size + header_size + other_node->size, pool))
+    {
+        remove_free_node(other_node, pool);
+        // Increase freed node's size
+        freed_node->size += header_size + other_node->size;
+    }
+    
+    // Check if the node directly before the freed node is free
+    other_node = freed_node->prev_phys;
+    if (other_node != NULL && other_node->is_free &&
+        tlsf_can_merge(other_node->size + header_size + freed_node->size, pool))
+    {
+        remove_free_node(other_node, pool);
+        // Increase the merging node's size
+        other_node->size += header_size + freed_node->size;
+        // Merge
+        freed_node = other_node;
+    }
+    
+    other_node = next_phys_node(freed_node, pool);
+    if (other_node != NULL) other_node->prev_phys = freed_node;
+    
+    insert_free_node(freed_node, pool);
+    
+    // Format the freed pool
+    //    char* freed_pool = (char*)freed_node->pool;
+    //    for (int i = 0; i < freed_node->size; i++) freed_pool[i] = 0;
+}
+
+static inline char* locked_alloc_block(size_t asize, size_t alignment, _tMempool* pool)
+{
+    if (pool->cache != NULL) return cache_alloc(asize, alignment, pool);
+    
+    if (pool->concurrent) mpool_lock(pool);
+    char* ret = alloc_block(asize, alignment, pool);
+    if (ret != NULL && pool->usize > pool->stats.max_used) pool->stats.max_used = pool->usize;
+    if (pool->concurrent) mpool_unlock(pool);
+    
+    return ret;
+}
+
+/**
+ * common path of all allocations, keeping count of them
+ */
+static inline char* pool_alloc(size_t asize, size_t alignment, int clear, void* caller, _tMempool* pool)
+{
+    // Only recorded for blocks of the pool's own memory with LEAF_MEMPOOL_TRACK_CALLERS
+    (void) caller;
+    count_event(&pool->leaf->allocCount, pool);
+    count_event(&pool->stats.allocs, pool);
+#if LEAF_USE_DYNAMIC_ALLOCATION
+    // Arena mempools still bump allocate from their own memory, so that
+    // resetting them releases everything allocated from them
+    if (!mpool_is_arena(pool))
+    {
+        char* ret = dynamic_alloc(asize, alignment);
+        if (ret != NULL && clear) memset(ret, 0, asize);
+        return ret;
+    }
+#endif
+    uint32_t start = (pool->clock != NULL) ? pool->clock() : 0;
+    
+    char* ret = (pool->slab != NULL) ? slab_alloc(asize, alignment, pool) : NULL;
+    if (ret == NULL)
+    {
+        ret = locked_alloc_block(asize, alignment, pool);
+#if LEAF_MEMPOOL_TRACK_CALLERS
+        if (ret != NULL && pool->type != MempoolArena) ((mpool_node_t*) (ret - pool->leaf->header_size))->caller = caller;
+#endif
+    }
+    
+    if (ret != NULL && clear) memset(ret, 0, asize);
+    
+    if (pool->clock != NULL)
+    {
+        count_ticks(start, &pool->stats.alloc_ticks, &pool->stats.max_alloc_ticks, pool);
+    }
+    
+    return ret;
+}
+
+#if LEAF_USE_DYNAMIC_ALLOCATION
+static char* dynamic_alloc(size_t asize, size_t alignment)
+{
+    char* temp = NULL;
+#if defined(__unix__) || defined(__APPLE__)
+    if (alignment > MPOOL_ALIGN_SIZE)
+    {
+        // memory from posix_memalign can be released with free()
+        void* aligned = NULL;
+        if (posix_memalign(&aligned, mpool_alignment(alignment), asize) == 0) temp = (char*) aligned;
+    }
+    else
+    {
+        temp = (char*) malloc(asize);
+    }
+#else
+    // Without posix_memalign, such as on Windows, every block is over-allocated
+    // and offset to its alignment, with what malloc returned kept right before
+    // it for dynamic_free
+    alignment = mpool_alignment(alignment);
+    char* block = (char*) malloc(asize + alignment + sizeof(void*));
+    if (block != NULL)
+    {
+        uintptr_t location = (uintptr_t) (block + sizeof(void*));
+        temp = (char*) ((location + alignment - 1) & ~((uintptr_t) alignment - 1));
+        ((void**) temp)[-1] = block;
+    }
+#endif
+    if (temp == NULL)
+    {
+        // allocation failed, exit from the program
+        fprintf(stderr, "Out of memory.\n");
+        exit(1);
+    }
+    return temp;
+}
+
+static void dynamic_free(char* ptr)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    free(ptr);
+#else
+    if (ptr != NULL) free(((void**) ptr)[-1]);
+#endif
+}
+#endif
+
+//==============================================================================
+// TLSF
+//
+// Free nodes are kept in segregated lists indexed by a first level (power of two)
+// and a second level (linear subdivision of that power of two), with a bitmap
+// for each level so a suitable list is found with two bit scans. Neighbouring
+// nodes are found through prev_phys and the node size, so coalescing on free
+// does not depend on the length of any list.
+//==============================================================================
+
+#define MPOOL_TLSF_BLOCK_SIZE_MAX (((size_t) 1 << MPOOL_TLSF_FL_INDEX_MAX) - MPOOL_ALIGN_SIZE)
+
+// index of the most significant set bit, -1 for 0
+static inline int mpool_fls(uint32_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return word ? 31 - __builtin_clz(word) : -1;
+#else
+    int bit = -1;
+    while (word)
+    {
+        word >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+// index of the least significant set bit, -1 for 0
+static inline int mpool_ffs(uint32_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ffs((int) word) - 1;
+#else
+    int bit = 0;
+    if (word == 0) return -1;
+    while (!(word & 1))
+    {
+        word >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+static inline void tlsf_mapping_insert(size_t size, int* fl, int* sl)
+{
+    if (size < MPOOL_TLSF_SMALL_BLOCK_SIZE)
+    {
+        *fl = 0;
+        *sl = (int) size / (MPOOL_TLSF_SMALL_BLOCK_SIZE / MPOOL_TLSF_SL_INDEX_COUNT);
+    }
+    else
+    {
+        int f = mpool_fls((uint32_t) size);
+        *sl = (int) (size >> (f - MPOOL_TLSF_SL_INDEX_COUNT_LOG2)) ^ MPOOL_TLSF_SL_INDEX_COUNT;
+        *fl = f - (MPOOL_TLSF_FL_INDEX_SHIFT - 1);
+    }
+}
+
+// round the size up to the next list boundary so any node in the found list is large enough
+static inline void tlsf_mapping_search(size_t size, int* fl, int* sl)
+{
+    if (size >= MPOOL_TLSF_SMALL_BLOCK_SIZE)
+    {
+        size += ((size_t) 1 << (mpool_fls((uint32_t) size) - MPOOL_TLSF_SL_INDEX_COUNT_LOG2)) - 1;
+    }
+    tlsf_mapping_insert(size, fl, sl);
+}
+
+static inline mpool_node_t* tlsf_find_suitable(mpool_tlsf_t* tlsf, int* fl, int* sl)
+{
+    uint32_t sl_map = tlsf->sl_bitmap[*fl] & (~0U << *sl);
+    if (!sl_map)
+    {
+        // Nothing left in this first-level list, move up to the next non-empty one
+        uint32_t fl_map = (*fl + 1 < 32) ? tlsf->fl_bitmap & (~0U << (*fl + 1)) : 0;
+        if (!fl_map) return NULL;
+        
+        *fl = mpool_ffs(fl_map);
+        sl_map = tlsf->sl_bitmap[*fl];
+    }
+    *sl = mpool_ffs(sl_map);
+    
+    return tlsf->blocks[*fl][*sl];
+}
+
+static inline void tlsf_insert_node(_tMempool* pool, mpool_node_t* node)
+{
+    mpool_tlsf_t* tlsf = pool->tlsf;
+    int fl, sl;
+    tlsf_mapping_insert(node->size, &fl, &sl);
+    
+    node->prev = NULL;
+    node->next = tlsf->blocks[fl][sl];
+    if (node->next != NULL) node->next->prev = node;
+    tlsf->blocks[fl][sl] = node;
+    node->is_free = 1;
+    
+    tlsf->fl_bitmap |= 1U << fl;
+    tlsf->sl_bitmap[fl] |= 1U << sl;
+}
+
+static inline void tlsf_remove_node(_tMempool* pool, mpool_node_t* node)
+{
+    mpool_tlsf_t* tlsf = pool->tlsf;
+    int fl, sl;
+    tlsf_mapping_insert(node->size, &fl, &sl);
+    
+    if (tlsf->blocks[fl][sl] == node)
+    {
+        tlsf->blocks[fl][sl] = node->next;
+        if (node->next == NULL)
+        {
+            tlsf->sl_bitmap[fl] &= ~(1U << sl);
+            if (!tlsf->sl_bitmap[fl]) tlsf->fl_bitmap &= ~(1U << fl);
+        }
+    }
+    delink_node(node);
+    node->is_free = 0;
+}
+
+static void tlsf_create(_tMempool* pool)
+{
+    size_t header_size = pool->leaf->header_size;
+    size_t control_size = mpool_align(sizeof(mpool_tlsf_t));
+    
+    pool->head = NULL;
+    if (pool->msize < control_size + header_size + MPOOL_ALIGN_SIZE)
+    {
+        // Not enough room for the control structure and a single node
+        pool->usize = pool->msize;
+        return;
+    }
+    
+    pool->tlsf = (mpool_tlsf_t*) pool->mpool;
+    memset(pool->tlsf, 0, sizeof(mpool_tlsf_t));
+    pool->usize = control_size;
+    
+    // A node can't be larger than the biggest list holds, so very large pools
+    // are laid out as a run of nodes of the largest size
+    size_t offset = control_size;
+    mpool_node_t* prev_phys = NULL;
+    while (pool->msize - offset >= header_size + MPOOL_ALIGN_SIZE)
+    {
+        size_t size = (pool->msize - offset - header_size) & ~((size_t) MPOOL_ALIGN_SIZE - 1);
+        if (size > MPOOL_TLSF_BLOCK_SIZE_MAX) size = MPOOL_TLSF_BLOCK_SIZE_MAX;
+        
+        mpool_node_t* node = create_node(&pool->mpool[offset], NULL, NULL, size, header_size);
+        node->prev_phys = prev_phys;
+        tlsf_insert_node(pool, node);
+        prev_phys = node;
+        offset += header_size + size;
+    }
+    
+    // End the pool at the last node, so next_phys_node never reads the
+    // unused bytes after it as a node
+    pool->msize = offset;
+}
+
+// Neighbouring free nodes are only merged while the result still fits in a list
+static inline int tlsf_can_merge(size_t size, _tMempool* pool)
+{
+    return pool->type != MempoolTLSF || size <= MPOOL_TLSF_BLOCK_SIZE_MAX;
+}
+
+static inline mpool_node_t* tlsf_find_node(size_t asize, _tMempool* pool)
+{
+    size_t size_to_alloc = mpool_align(asize);
+    mpool_node_t* node_to_alloc = NULL;
+    
+    // Searching from the rounded up list means any node found fits, so this
+    // never walks a list
+    if (pool->tlsf != NULL && size_to_alloc <= MPOOL_TLSF_BLOCK_SIZE_MAX)
+    {
+        int fl, sl;
+        tlsf_mapping_search(size_to_alloc, &fl, &sl);
+        if (fl < MPOOL_TLSF_FL_INDEX_COUNT) node_to_alloc = tlsf_find_suitable(pool->tlsf, &fl, &sl);
+    }
+    
+    count_steps(1, pool);
+    return node_to_alloc;
+}
+
+//==============================================================================
+// Concurrency
+//
+// Pools used by more than one thread are flagged concurrent and serialize
+// allocation and free with a spinlock. A thread cache sits in front of such a
+// shared pool and keeps blocks of a few power of two size classes for the one
+// thread that allocates through it. Frees through a thread cache, from any
+// thread, are pushed onto a lock-free stack threaded through the node headers
+// and only sorted back into the magazines by the owning thread.
+//==============================================================================
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+static inline int spin_try_lock(volatile int* flag)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return !__atomic_exchange_n(flag, 1, __ATOMIC_ACQUIRE);
+#elif defined(_MSC_VER)
+    return !_InterlockedExchange((long volatile*) flag, 1);
+#else
+    // No atomics available, assume a single core
+    if (*flag) return 0;
+    *flag = 1;
+    return 1;
+#endif
+}
+
+static inline void spin_lock(volatile int* flag)
+{
+    while (!spin_try_lock(flag))
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        while (__atomic_load_n(flag, __ATOMIC_RELAXED)) { }
+#endif
+    }
+}
+
+static inline void spin_unlock(volatile int* flag)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_store_n(flag, 0, __ATOMIC_RELEASE);
+#elif defined(_MSC_VER)
+    _InterlockedExchange((long volatile*) flag, 0);
+#else
+    *flag = 0;
+#endif
+}
+
+static inline void mpool_lock(_tMempool* pool)
+{
+    spin_lock(&pool->lock);
+}
+
+static inline void mpool_unlock(_tMempool* pool)
+{
+    spin_unlock(&pool->lock);
+}
+
+static inline void count_event(unsigned int* counter, _tMempool* pool)
+{
+    // The LEAF counts are shared by every mempool, so any concurrent mempool or
+    // thread cache means they can be updated from more than one thread
+    if (!pool->concurrent && !pool->leaf->concurrentMempools)
+    {
+        (*counter)++;
+        return;
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_fetch_add(counter, 1, __ATOMIC_RELAXED);
+#elif defined(_MSC_VER)
+    _InterlockedIncrement((long volatile*) counter);
+#else
+    (*counter)++;
+#endif
+}
+
+static inline void cache_push_remote(mpool_cache_t* cache, mpool_node_t* node)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    mpool_node_t* head = __atomic_load_n(&cache->remote, __ATOMIC_RELAXED);
+    do
+    {
+        node->next = head;
+    } while (!__atomic_compare_exchange_n(&cache->remote, &head, node, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+#elif defined(_MSC_VER)
+    mpool_node_t* head;
+    do
+    {
+        head = cache->remote;
+        node->next = head;
+    } while (_InterlockedCompareExchangePointer((void* volatile*) &cache->remote, node, head) != head);
+#else
+    node->next = cache->remote;
+    cache->remote = node;
+#endif
+}
+
+static inline mpool_node_t* cache_take_remote(mpool_cache_t* cache)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_exchange_n(&cache->remote, NULL, __ATOMIC_ACQUIRE);
+#elif defined(_MSC_VER)
+    return (mpool_node_t*) _InterlockedExchangePointer((void* volatile*) &cache->remote, NULL);
+#else
+    mpool_node_t* head = cache->remote;
+    cache->remote = NULL;
+    return head;
+#endif
+}
+
+static inline size_t cache_class_size(int c)
+{
+    return (size_t) MPOOL_CACHE_MIN_SIZE << c;
+}
+
+// smallest class that can hold a request, -1 if none can
+static inline int cache_class_for_request(size_t size)
+{
+    for (int c = 0; c < MPOOL_CACHE_CLASS_COUNT; ++c)
+    {
+        if (size <= cache_class_size(c)) return c;
+    }
+    return -1;
+}
+
+// largest class a block can serve, -1 if none or if it is too large to be worth
+// holding on to, such as a delay line, which goes back to the shared pool
+static inline int cache_class_for_block(size_t size)
+{
+    if (size > cache_class_size(MPOOL_CACHE_CLASS_COUNT - 1) * 2) return -1;
+    
+    for (int c = MPOOL_CACHE_CLASS_COUNT - 1; c >= 0; --c)
+    {
+        if (size >= cache_class_size(c)) return c;
+    }
+    return -1;
+}
+
+static inline char* cache_alloc(size_t asize, size_t alignment, _tMempool* pool)
+{
+    mpool_cache_t* cache = pool->cache;
+    _tMempool* shared = pool->mempool;
+    size_t header_size = pool->leaf->header_size;
+    
+    // Arena memory can't be handed back and forth, so there is nothing to cache
+    if (shared->type == MempoolArena) return locked_alloc_block(asize, alignment, shared);
+    
+    int c = (mpool_alignment(alignment) > MPOOL_ALIGN_SIZE) ? -1 : cache_class_for_request(asize);
+    if (c >= 0)
+    {
+        if (cache->magazines[c] == NULL) cache_collect(pool);
+        
+        mpool_node_t* node = cache->magazines[c];
+        if (node != NULL)
+        {
+            cache->magazines[c] = node->next;
+            cache->counts[c]--;
+            node->next = NULL;
+#if LEAF_MEMPOOL_COMPACTION
+            node->owner = NULL;
+#endif
+            pool->usize += header_size + node->size;
+            if (pool->usize > pool->stats.max_used) pool->stats.max_used = pool->usize;
+            return node->pool;
+        }
+        
+        // Take a whole class sized block so it can be reused for any request in the class
+        asize = cache_class_size(c);
+    }
+    
+    char* ret = locked_alloc_block(asize, alignment, shared);
+    if (ret != NULL)
+    {
+        pool->usize += header_size + ((mpool_node_t*) (ret - header_size))->size;
+        if (pool->usize > pool->stats.max_used) pool->stats.max_used = pool->usize;
+    }
+    return ret;
+}
+
+static inline void cache_free(char* ptr, _tMempool* pool)
+{
+    _tMempool* shared = pool->mempool;
+    size_t header_size = pool->leaf->header_size;
+    
+    if (shared->type == MempoolArena) return;
+    
+#if LEAF_USE_MMAP
+    // The block may come from a region the shared pool mapped as it grew
+    shared = mapped_region_for(ptr, shared);
+#endif
+    if (ptr < shared->mpool + header_size || ptr >= shared->mpool + shared->msize)
+    {
+        LEAF_internalErrorCallback(pool->leaf, LEAFInvalidFree);
+        return;
+    }
+    
+    // The block stays allocated in the shared pool, so its list links are free to use
+    cache_push_remote(pool->cache, (mpool_node_t*) (ptr - header_size));
+}
+
+/**
+ * give a block held by a thread cache back to the shared pool, or to the region it
+ * mapped as it grew that the block came from
+ */
+static inline void cache_release(mpool_node_t* node, _tMempool* shared)
+{
+#if LEAF_USE_MMAP
+    shared = mapped_region_for(node->pool, shared);
+#endif
+    mpool_lock(shared);
+    free_block(node->pool, shared);
+    mpool_unlock(shared);
+}
+
+/**
+ * sort blocks freed through a thread cache into its magazines,
+ * giving back to the shared pool what the magazines can't hold
+ */
+static inline void cache_collect(_tMempool* pool)
+{
+    mpool_cache_t* cache = pool->cache;
+    _tMempool* shared = pool->mempool;
+    size_t header_size = pool->leaf->header_size;
+    
+    mpool_node_t* node = cache_take_remote(cache);
+    mpool_node_t* overflow = NULL;
+    while (node != NULL)
+    {
+        mpool_node_t* next = node->next;
+        pool->usize -= header_size + node->size;
+        
+        int c = cache_class_for_block(node->size);
+        if (c >= 0 && cache->counts[c] < MPOOL_CACHE_MAGAZINE_SIZE)
+        {
+            node->next = cache->magazines[c];
+            cache->magazines[c] = node;
+            cache->counts[c]++;
+        }
+        else
+        {
+            node->next = overflow;
+            overflow = node;
+        }
+        node = next;
+    }
+    
+    while (overflow != NULL)
+    {
+        node = overflow;
+        overflow = node->next;
+        node->next = NULL;
+        cache_release(node, shared);
+    }
+}
+
+/**
+ * give every block held by a thread cache back to the shared pool
+ */
+static inline void cache_flush(_tMempool* pool)
+{
+    mpool_cache_t* cache = pool->cache;
+    _tMempool* shared = pool->mempool;
+    
+    cache_collect(pool);
+    
+    for (int c = 0; c < MPOOL_CACHE_CLASS_COUNT; ++c)
+    {
+        while (cache->magazines[c] != NULL)
+        {
+            mpool_node_t* node = cache->magazines[c];
+            cache->magazines[c] = node->next;
+            node->next = NULL;
+            cache_release(node, shared);
+        }
+        cache->counts[c] = 0;
+    }
+}
+
+//==============================================================================
+// Deferred free
+//
+// Freeing a block means searching and coalescing free lists, which is too slow
+// to do many times over on the audio thread. With deferred free enabled,
+// mpool_free only records the block in a ring owned by the LEAF instance and
+// LEAF_collect carries the frees out later, sorted by address so each block is
+// coalesced with neighbours that have already been given back.
+//==============================================================================
+
+static inline unsigned int load_acquire(volatile unsigned int* value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#elif defined(_MSC_VER)
+    unsigned int v = *value;
+    _ReadWriteBarrier();
+    return v;
+#else
+    return *value;
+#endif
+}
+
+static inline int compare_and_swap(volatile unsigned int* value, unsigned int expected, unsigned int desired)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __atomic_compare_exchange_n(value, &expected, desired, 0, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED);
+#elif defined(_MSC_VER)
+    return (unsigned int) _InterlockedCompareExchange((long volatile*) value, (long) desired, (long) expected) == expected;
+#else
+    // No atomics available, assume a single core
+    if (*value != expected) return 0;
+    *value = desired;
+    return 1;
+#endif
+}
+
+static inline void store_release(volatile unsigned int* value, unsigned int v)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_store_n(value, v, __ATOMIC_RELEASE);
+#elif defined(_MSC_VER)
+    _ReadWriteBarrier();
+    *value = v;
+#else
+    *value = v;
+#endif
+}
+
+/**
+ * whether a pool bump allocates from its own memory rather than through a thread cache
+ */
+static inline int mpool_is_arena(_tMempool* pool)
+{
+    return pool->type == MempoolArena && pool->cache == NULL;
+}
+
+/**
+ * give a block back to its pool right away
+ */
+static inline void release_block(char* ptr, _tMempool* pool)
+{
+#if LEAF_USE_DYNAMIC_ALLOCATION
+    if (!mpool_is_arena(pool)) dynamic_free(ptr);
+#else
+    if (pool->cache != NULL)
+    {
+        cache_free(ptr, pool);
+        return;
+    }
+    
+#if LEAF_USE_MMAP
+    pool = mapped_region_for(ptr, pool);
+#endif
+    
+    if (pool->concurrent) mpool_lock(pool);
+    if (slab_owns(ptr, pool)) slab_free(ptr, pool);
+    else free_block(ptr, pool);
+    if (pool->concurrent) mpool_unlock(pool);
+#endif
+}
+
+/**
+ * queue a free for LEAF_collect, returns 0 if it has to be done now instead
+ */
+static inline int defer_free(char* ptr, _tMempool* pool)
+{
+    mpool_deferred_t* deferred = pool->leaf->deferredFrees;
+    
+#if !LEAF_USE_DYNAMIC_ALLOCATION
+    // Arena frees are no-ops and thread cache frees are already lock-free
+    if (pool->type == MempoolArena || pool->cache != NULL) return 0;
+    
+#if LEAF_MEMPOOL_COMPACTION
+    // The block is on its way out, so compaction must leave it where it is
+    if (!slab_owns(ptr, pool) && ptr >= pool->mpool + pool->leaf->header_size && ptr < pool->mpool + pool->msize)
+    {
+        ((mpool_node_t*) (ptr - pool->leaf->header_size))->owner = NULL;
+    }
+#endif
+#endif
+    
+    // Claim the slot at head once LEAF_collect() has emptied it, then fill it
+    // in and mark it written. The sequence of each slot tells how far along it is
+    unsigned int head = load_acquire(&deferred->head);
+    for (;;)
+    {
+        mpool_deferred_free_t* entry = &deferred->entries[head & (deferred->capacity - 1)];
+        int diff = (int) (load_acquire(&entry->sequence) - head);
+        if (diff == 0)
+        {
+            if (compare_and_swap(&deferred->head, head, head + 1))
+            {
+                entry->ptr = ptr;
+                entry->pool = pool;
+                store_release(&entry->sequence, head + 1);
+                return 1;
+            }
+        }
+        // The queue is full
+        else if (diff < 0) return 0;
+        
+        // Another thread claimed the slot first
+        head = load_acquire(&deferred->head);
+    }
+}
+
+static int compare_deferred_free(const void* a, const void* b)
+{
+    uintptr_t pa = (uintptr_t) ((const mpool_deferred_free_t*) a)->ptr;
+    uintptr_t pb = (uintptr_t) ((const mpool_deferred_free_t*) b)->ptr;
+    return (pa > pb) - (pa < pb);
+}
+
+void leaf_enable_deferred_free(LEAF* const leaf, int capacity)
+{
+    if (leaf->deferredFrees != NULL || capacity <= 0) return;
+    
+    unsigned int size = 1;
+    while (size < (unsigned int) capacity) size <<= 1;
+    
+    mpool_deferred_t* deferred = (mpool_deferred_t*) mpool_alloc(sizeof(mpool_deferred_t), leaf->mempool);
+    if (deferred == NULL) return;
+    deferred->entries = (mpool_deferred_free_t*) mpool_alloc(sizeof(mpool_deferred_free_t) * size, leaf->mempool);
+    deferred->scratch = (mpool_deferred_free_t*) mpool_alloc(sizeof(mpool_deferred_free_t) * size, leaf->mempool);
+    if (deferred->entries == NULL || deferred->scratch == NULL)
+    {
+        if (deferred->entries != NULL) mpool_free((char*) deferred->entries, leaf->mempool);
+        if (deferred->scratch != NULL) mpool_free((char*) deferred->scratch, leaf->mempool);
+        mpool_free((char*) deferred, leaf->mempool);
+        return;
+    }
+    deferred->capacity = size;
+    deferred->head = 0;
+    deferred->tail = 0;
+    deferred->lock = 0;
+    for (unsigned int i = 0; i < size; ++i) deferred->entries[i].sequence = i;
+    
+    leaf->deferredFrees = deferred;
+}
+
+// Carries out the frees waiting in the queue, with the lock held
+static int defer_collect(mpool_deferred_t* deferred)
+{
+    unsigned int tail = deferred->tail;
+    unsigned int count = 0;
+    
+    // Stop at the first slot that has been claimed but not written yet
+    while (count < deferred->capacity)
+    {
+        mpool_deferred_free_t* entry = &deferred->entries[(tail + count) & (deferred->capacity - 1)];
+        if (load_acquire(&entry->sequence) != tail + count + 1) break;
+        deferred->scratch[count] = *entry;
+        // The entry is copied out, so the freeing threads can reuse its slot
+        store_release(&entry->sequence, tail + count + deferred->capacity);
+        count++;
+    }
+    if (count == 0) return 0;
+    deferred->tail = tail + count;
+    
+    qsort(deferred->scratch, count, sizeof(mpool_deferred_free_t), compare_deferred_free);
+    
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        release_block(deferred->scratch[i].ptr, deferred->scratch[i].pool);
+    }
+    
+    return (int) count;
+}
+
+int leaf_collect(LEAF* const leaf)
+{
+    mpool_deferred_t* deferred = leaf->deferredFrees;
+    if (deferred == NULL) return 0;
+    
+    // Another thread is collecting already
+    if (!spin_try_lock(&deferred->lock)) return 0;
+    int count = defer_collect(deferred);
+    spin_unlock(&deferred->lock);
+    
+    return count;
+}
+
+/**
+ * carry out every deferred free, waiting for a collection running on another thread
+ * to finish, so that none are left for a mempool about to be freed or reset
+ */
+static void defer_drain(LEAF* const leaf)
+{
+    mpool_deferred_t* deferred = leaf->deferredFrees;
+    if (deferred == NULL) return;
+    
+    spin_lock(&deferred->lock);
+    defer_collect(deferred);
+    spin_unlock(&deferred->lock);
+}
+
+//==============================================================================
+// Slabs
+//
+// A pool can set aside one block of itself as slabs for small objects. The
+// block is split into chunks, and each chunk is handed out whole to a single
+// size class, so objects of the same size end up next to each other. Objects
+// in a slab have no header; their size class is found from the chunk they are
+// in, and a freed object is pushed onto the free list of its class, threaded
+// through the object memory itself.
+//==============================================================================
+
+static inline int slab_owns(char* ptr, _tMempool* pool)
+{
+    mpool_slab_t* slab = pool->slab;
+    return slab != NULL && ptr >= slab->chunks && ptr < slab->chunks + slab->chunk_count * MPOOL_SLAB_CHUNK_SIZE;
+}
+
+static inline char* slab_alloc(size_t asize, size_t alignment, _tMempool* pool)
+{
+    mpool_slab_t* slab = pool->slab;
+    
+    if (asize == 0 || asize > MPOOL_SLAB_CLASS_SIZE * MPOOL_SLAB_CLASS_COUNT) return NULL;
+    if (mpool_alignment(alignment) > MPOOL_SLAB_CLASS_SIZE) return NULL;
+    
+    int c = (int) ((asize - 1) / MPOOL_SLAB_CLASS_SIZE);
+    size_t size = (size_t) (c + 1) * MPOOL_SLAB_CLASS_SIZE;
+    
+    if (pool->concurrent) mpool_lock(pool);
+    
+    char* ret = slab->free[c];
+    if (ret != NULL)
+    {
+        slab->free[c] = *(char**) ret;
+    }
+    else
+    {
+        if (slab->next[c] == NULL || slab->next[c] + size > slab->limit[c])
+        {
+            // Hand this class the next untouched chunk, if there is one
+            if (slab->chunks_used == slab->chunk_count)
+            {
+                if (pool->concurrent) mpool_unlock(pool);
+                return NULL;
+            }
+            slab->chunk_class[slab->chunks_used] = (unsigned char) c;
+            slab->next[c] = slab->chunks + slab->chunks_used * MPOOL_SLAB_CHUNK_SIZE;
+            slab->limit[c] = slab->next[c] + MPOOL_SLAB_CHUNK_SIZE;
+            slab->chunks_used++;
+        }
+        ret = slab->next[c];
+        slab->next[c] += size;
+    }
+    
+    pool->usize += size;
+    if (pool->usize > pool->stats.max_used) pool->stats.max_used = pool->usize;
+    
+    if (pool->concurrent) mpool_unlock(pool);
+    
+    return ret;
+}
+
+static inline void slab_free(char* ptr, _tMempool* pool)
+{
+    mpool_slab_t* slab = pool->slab;
+    
+    size_t chunk = (size_t) (ptr - slab->chunks) / MPOOL_SLAB_CHUNK_SIZE;
+    if (chunk >= slab->chunks_used)
+    {
+        LEAF_internalErrorCallback(pool->leaf, LEAFInvalidFree);
+        return;
+    }
+    
+    int c = slab->chunk_class[chunk];
+    size_t size = (size_t) (c + 1) * MPOOL_SLAB_CLASS_SIZE;
+    if ((size_t) (ptr - (slab->chunks + chunk * MPOOL_SLAB_CHUNK_SIZE)) % size != 0)
+    {
+        LEAF_internalErrorCallback(pool->leaf, LEAFInvalidFree);
+        return;
+    }
+    
+    *(char**) ptr = slab->free[c];
+    slab->free[c] = ptr;
+    pool->usize -= size;
+}
+
+void mpool_reserve_slabs(size_t size, _tMempool* pool)
+{
+#if !LEAF_USE_DYNAMIC_ALLOCATION
+    if (pool->slab != NULL || pool->type == MempoolArena || pool->cache != NULL) return;
+    
+    size_t chunk_count = size / MPOOL_SLAB_CHUNK_SIZE;
+    if (chunk_count == 0) return;
+    
+    // The control structure and chunk classes go in front of the chunks, in the same block
+    size_t control_size = sizeof(mpool_slab_t) + chunk_count;
+    control_size = (control_size + MPOOL_CACHE_LINE_SIZE - 1) & ~((size_t) MPOOL_CACHE_LINE_SIZE - 1);
+    
+    if (pool->concurrent) mpool_lock(pool);
+    
+    char* block = alloc_block(control_size + chunk_count * MPOOL_SLAB_CHUNK_SIZE, MPOOL_CACHE_LINE_SIZE, pool);
+    if (block != NULL)
+    {
+        mpool_slab_t* slab = (mpool_slab_t*) block;
+        memset(slab, 0, sizeof(mpool_slab_t));
+        slab->chunk_class = (unsigned char*) (block + sizeof(mpool_slab_t));
+        slab->chunks = block + control_size;
+        slab->chunk_count = chunk_count;
+        
+        // Only the objects in the chunks count as used
+        pool->usize -= chunk_count * MPOOL_SLAB_CHUNK_SIZE;
+        pool->slab = slab;
+    }
+    
+    if (pool->concurrent) mpool_unlock(pool);
+#else
+    (void) size;
+    (void) pool;
+#endif
+}
+
+#if LEAF_USE_MMAP
+//==============================================================================
+// Mapped memory
+//
+// On hosts with mmap, a pool can be created over memory mapped for it instead
+// of memory handed in by the user. A growing pool maps another region when it
+// runs out and chains it on, with the region's own _tMempool at its start, so
+// allocations that don't fit in one region move on to the next and frees are
+// sent to the region whose memory they are in.
+//==============================================================================
+
+static char* map_region(size_t* size, int flags)
+{
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    int map = MAP_PRIVATE | MAP_ANONYMOUS;
+    void* region = MAP_FAILED;
+    
+#ifdef MAP_POPULATE
+    if (flags & MempoolMapLocked) map |= MAP_POPULATE;
+#endif
+#ifdef MAP_HUGETLB
+    if (flags & MempoolMapHugePages)
+    {
+        size_t huge_size = (*size + MPOOL_HUGE_PAGE_SIZE - 1) & ~((size_t) MPOOL_HUGE_PAGE_SIZE - 1);
+        region = mmap(NULL, huge_size, PROT_READ | PROT_WRITE, map | MAP_HUGETLB, -1, 0);
+        if (region != MAP_FAILED) *size = huge_size;
+    }
+#endif
+    if (region == MAP_FAILED)
+    {
+        *size = (*size + page - 1) & ~(page - 1);
+        region = mmap(NULL, *size, PROT_READ | PROT_WRITE, map, -1, 0);
+        if (region == MAP_FAILED) return NULL;
+#ifdef MADV_HUGEPAGE
+        // No huge pages reserved, so ask for transparent ones instead
+        if (flags & MempoolMapHugePages) madvise(region, *size, MADV_HUGEPAGE);
+#endif
+    }
+    
+    // Locking can fail if RLIMIT_MEMLOCK is too low, the memory is still usable
+    if (flags & MempoolMapLocked) mlock(region, *size);
+    
+    return (char*) region;
+}
+
+static char* mapped_grow_alloc(size_t asize, size_t alignment, _tMempool* pool)
+{
+    if (pool->next == NULL)
+    {
+        size_t header_size = pool->leaf->header_size;
+        size_t control_size = mpool_align(sizeof(_tMempool));
+        
+        // Room for the control structures, the node, and padding to the alignment
+        size_t needed = control_size + mpool_align(sizeof(mpool_tlsf_t)) + 2 * header_size + asize + alignment;
+        // Double the size with each region so the chain stays short
+        size_t size = pool->map_size * 2;
+        while (size < needed) size *= 2;
+        
+        char* region = map_region(&size, pool->map_flags);
+        if (region == NULL)
+        {
+            alloc_failed(asize, pool);
+            return NULL;
+        }
+        
+        _tMempool* next = (_tMempool*) region;
+        next->mempool = NULL;
+        next->leaf = pool->leaf;
+        mpool_create_with_type(region + control_size, size - control_size, pool->type, next);
+        next->alignment = pool->alignment;
+        next->concurrent = pool->concurrent;
+        next->clock = pool->clock;
+        next->map_flags = pool->map_flags;
+        next->map_base = region;
+        next->map_size = size;
+        
+        pool->next = next;
+    }
+    
+    return locked_alloc_block(asize, alignment, pool->next);
+}
+
+/**
+ * region of a growing pool that holds the given memory
+ */
+static inline _tMempool* mapped_region_for(char* ptr, _tMempool* pool)
+{
+    _tMempool* region = pool;
+    while (region != NULL)
+    {
+        if (ptr >= region->mpool && ptr < region->mpool + region->msize) return region;
+        region = region->next;
+    }
+    // Let the first region report the invalid free
+    return pool;
+}
+
+static void mapped_unmap(_tMempool* pool)
+{
+    _tMempool* region = pool->next;
+    while (region != NULL)
+    {
+        // The region's _tMempool goes away with the mapping
+        _tMempool* next = region->next;
+        munmap(region->map_base, region->map_size);
+        region = next;
+    }
+    munmap(pool->map_base, pool->map_size);
+}
+
+#endif
+
+//==============================================================================
+// Statistics
+//
+// Counters that have to be kept as allocations happen live in pool->stats and
+// cost a few increments per allocation and free. Everything about the current
+// layout of the pool is worked out on request by walking its blocks in
+// physical order, so the allocator itself pays nothing for it.
+//==============================================================================
+
+static inline void count_steps(unsigned int steps, _tMempool* pool)
+{
+    pool->stats.alloc_steps += steps;
+    if (steps > pool->stats.max_alloc_steps) pool->stats.max_alloc_steps = steps;
+}
+
+/**
+ * the time is taken before locking, the totals are updated under the lock
+ * of a concurrent pool like everything else in its stats
+ */
+static inline void count_ticks(uint32_t start, uint32_t* total, uint32_t* max, _tMempool* pool)
+{
+    uint32_t ticks = pool->clock() - start;
+    if (pool->concurrent) mpool_lock(pool);
+    *total += ticks;
+    if (ticks > *max) *max = ticks;
+    if (pool->concurrent) mpool_unlock(pool);
+}
+
+static inline int stats_bucket(size_t size)
+{
+    int bucket = 0;
+    size /= MPOOL_STATS_MIN_SIZE;
+    while (size > 1 && bucket < MPOOL_STATS_HISTOGRAM_SIZE - 1)
+    {
+        size >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+static inline void stats_add_free(mpool_stats_t* stats, size_t size)
+{
+    stats->free += size;
+    stats->free_blocks++;
+    stats->free_histogram[stats_bucket(size)]++;
+    if (size > stats->largest_free) stats->largest_free = size;
+}
+
+/**
+ * node at the lowest address of a pool, or NULL if the pool has none
+ */
+static inline mpool_node_t* first_phys_node(_tMempool* pool)
+{
+    if (pool->type == MempoolArena || pool->cache != NULL) return NULL;
+    
+    if (pool->type == MempoolTLSF)
+    {
+        if (pool->tlsf == NULL) return NULL;
+        return (mpool_node_t*) (pool->mpool + mpool_align(sizeof(mpool_tlsf_t)));
+    }
+    
+    return (mpool_node_t*) pool->mpool;
+}
+
+/**
+ * call visit on every block of a pool, free or not, in address order
+ */
+void mpool_walk(_tMempool* pool, void (*visit)(mpool_node_t* node, void* context), void* context)
+{
+#if !LEAF_USE_DYNAMIC_ALLOCATION
+    mpool_node_t* node = first_phys_node(pool);
+    while (node != NULL)
+    {
+        visit(node, context);
+        node = next_phys_node(node, pool);
+    }
+#else
+    (void) pool;
+    (void) visit;
+    (void) context;
+#endif
+}
+
+static inline void stats_visit(mpool_node_t* node, void* context)
+{
+    mpool_stats_t* stats = (mpool_stats_t*) context;
+    
+    if (node->is_free) stats_add_free(stats, node->size);
+    else stats->used_blocks++;
+}
+
+void mpool_get_stats(_tMempool* pool, mpool_stats_t* stats)
+{
+    if (pool->concurrent && pool->cache == NULL) mpool_lock(pool);
+    
+    *stats = pool->stats;
+    stats->size = pool->msize;
+    stats->used = pool->usize;
+    if (stats->max_used < stats->used) stats->max_used = stats->used;
+    stats->free = 0;
+    stats->largest_free = 0;
+    stats->free_blocks = 0;
+    stats->used_blocks = 0;
+    memset(stats->free_histogram, 0, sizeof(stats->free_histogram));
+    
+#if !LEAF_USE_DYNAMIC_ALLOCATION
+    if (pool->cache != NULL)
+    {
+        // Blocks waiting in the magazines are free as far as the thread is concerned
+        for (int c = 0; c < MPOOL_CACHE_CLASS_COUNT; ++c)
+        {
+            for (mpool_node_t* node = pool->cache->magazines[c]; node != NULL; node = node->next)
+            {
+                stats_add_free(stats, node->size);
+            }
+        }
+    }
+    else if (pool->type == MempoolArena)
+    {
+        if (pool->msize > pool->usize) stats_add_free(stats, pool->msize - pool->usize);
+    }
+    else
+    {
+        mpool_walk(pool, stats_visit, stats);
+    }
+#endif
+    
+    if (pool->concurrent && pool->cache == NULL) mpool_unlock(pool);
+}
+
+typedef struct mpool_dump_t {
+    _tMempool* pool;
+    char*      buffer;
+    size_t     size;
+    size_t     length;
+} mpool_dump_t;
+
+static void dump_printf(mpool_dump_t* dump, const char* format, ...)
+{
+    if (dump->length + 1 >= dump->size) return;
+    
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(dump->buffer + dump->length, dump->size - dump->length, format, args);
+    va_end(args);
+    
+    if (n < 0) return;
+    // Stop at the end of the buffer, vsnprintf has already cut the text short
+    dump->length += ((size_t) n < dump->size - dump->length) ? (size_t) n : dump->size - dump->length - 1;
+}
+
+static void dump_visit(mpool_node_t* node, void* context)
+{
+    mpool_dump_t* dump = (mpool_dump_t*) context;
+    
+#if LEAF_MEMPOOL_TRACK_CALLERS
+    if (!node->is_free)
+    {
+        dump_printf(dump, "%lu used %lu %p\n", (unsigned long) ((char*) node - dump->pool->mpool),
+                    (unsigned long) node->size, node->caller);
+        return;
+    }
+#endif
+    dump_printf(dump, "%lu %s %lu\n", (unsigned long) ((char*) node - dump->pool->mpool),
+                node->is_free ? "free" : "used", (unsigned long) node->size);
+}
+
+int mpool_dump(_tMempool* pool, char* buffer, size_t size)
+{
+    if (buffer == NULL || size == 0) return 0;
+    buffer[0] = '\0';
+    
+    mpool_stats_t stats;
+    mpool_get_stats(pool, &stats);
+    
+    mpool_dump_t dump = { pool, buffer, size, 0 };
+    dump_printf(&dump, "size %lu used %lu max %lu\n", (unsigned long) stats.size,
+                (unsigned long) stats.used, (unsigned long) stats.max_used);
+    dump_printf(&dump, "free %lu in %u blocks largest %lu, %u used blocks\n", (unsigned long) stats.free,
+                stats.free_blocks, (unsigned long) stats.largest_free, stats.used_blocks);
+    dump_printf(&dump, "allocs %u frees %u failed %u steps %u max %u\n", stats.allocs, stats.frees,
+                stats.failed_allocs, stats.alloc_steps, stats.max_alloc_steps);
+    if (pool->clock != NULL)
+    {
+        dump_printf(&dump, "ticks alloc %lu max %lu free %lu max %lu\n",
+                    (unsigned long) stats.alloc_ticks, (unsigned long) stats.max_alloc_ticks,
+                    (unsigned long) stats.free_ticks, (unsigned long) stats.max_free_ticks);
+    }
+    dump_printf(&dump, "free sizes");
+    for (int i = 0; i < MPOOL_STATS_HISTOGRAM_SIZE; ++i)
+    {
+        if (stats.free_histogram[i] > 0)
+        {
+            dump_printf(&dump, " %lu:%u", (unsigned long) MPOOL_STATS_MIN_SIZE << i, stats.free_histogram[i]);
+        }
+    }
+    dump_printf(&dump, "\n");
+    
+    if (pool->concurrent && pool->cache == NULL) mpool_lock(pool);
+    mpool_walk(pool, dump_visit, &dump);
+    if (pool->concurrent && pool->cache == NULL) mpool_unlock(pool);
+    
+    return (int) dump.length;
+}
+
+//==============================================================================
+// Compaction
+//
+// A used block with an owner can be moved, as long as the owner is updated to
+// point at its new location. Compaction looks for free blocks followed by such
+// a block and swaps the two, so the used block slides down and the free space
+// moves up, where it merges with whatever free space follows. Repeating this
+// gathers free space towards the end of the pool, or up to the next block
+// that can't be moved.
+//
+// Only built with LEAF_MEMPOOL_COMPACTION, as the owner and alignment have to
+// be kept in every block header.
+//==============================================================================
+
+#if LEAF_MEMPOOL_COMPACTION && !LEAF_USE_DYNAMIC_ALLOCATION
+void mpool_set_owner(char* ptr, void** owner, _tMempool* pool)
+{
+    size_t header_size = pool->leaf->header_size;
+    
+    if (pool->type == MempoolArena || pool->cache != NULL || slab_owns(ptr, pool)) return;
+    if (ptr < pool->mpool + header_size || ptr >= pool->mpool + pool->msize) return;
+    
+    mpool_node_t* node = (mpool_node_t*) (ptr - header_size);
+    if (node->is_free) return;
+    
+    node->owner = owner;
+}
+
+/**
+ * swap a free node with the movable node right after it, returning the free node in its new place
+ */
+static inline mpool_node_t* slide_node(mpool_node_t* free_node, mpool_node_t* node, _tMempool* pool)
+{
+    size_t header_size = pool->leaf->header_size;
+    
+    // The node header is about to be overwritten, so keep what's needed of it
+    mpool_node_t* prev_phys = free_node->prev_phys;
+    mpool_node_t* next_node = next_phys_node(node, pool);
+    size_t free_size = free_node->size;
+    size_t size = node->size;
+    unsigned int alignment = node->alignment;
+    void** owner = node->owner;
+#if LEAF_MEMPOOL_TRACK_CALLERS
+    void* caller = node->caller;
+#endif
+    
+    remove_free_node(free_node, pool);
+    
+    char* location = (char*) free_node;
+    memmove(location + header_size, node->pool, size);
+    
+    mpool_node_t* moved = create_node(location, NULL, NULL, size, header_size);
+    moved->prev_phys = prev_phys;
+    moved->is_free = 0;
+    moved->alignment = alignment;
+    moved->owner = owner;
+#if LEAF_MEMPOOL_TRACK_CALLERS
+    moved->caller = caller;
+#endif
+    *owner = moved->pool;
+    
+    free_node = create_node(moved->pool + size, NULL, NULL, free_size, header_size);
+    free_node->prev_phys = moved;
+    if (next_node != NULL && next_node->is_free &&
+        tlsf_can_merge(free_node->size + header_size + next_node->size, pool))
+    {
+        remove_free_node(next_node, pool);
+        free_node->size += header_size + next_node->size;
+        next_node = next_phys_node(free_node, pool);
+    }
+    if (next_node != NULL) next_node->prev_phys = free_node;
+    insert_free_node(free_node, pool);
+    
+    return free_node;
+}
+
+size_t mpool_compact(_tMempool* pool, size_t max_bytes)
+{
+    size_t moved = 0;
+    if (pool->type == MempoolArena || pool->cache != NULL) return 0;
+    
+    if (pool->concurrent) mpool_lock(pool);
+    
+    mpool_node_t* node = first_phys_node(pool);
+    while (node != NULL && moved < max_bytes)
+    {
+        mpool_node_t* next_node = next_phys_node(node, pool);
+        if (next_node == NULL) break;
+        
+        if (node->is_free && !next_node->is_free && next_node->owner != NULL &&
+            (((uintptr_t) node->pool & (next_node->alignment - 1)) == 0))
+        {
+            moved += next_node->size;
+            node = slide_node(node, next_node, pool);
+        }
+        else
+        {
+            node = next_node;
+        }
+    }
+    
+    if (pool->concurrent) mpool_unlock(pool);
+    return moved;
+}
+#else
+void mpool_set_owner(char* ptr, void** owner, _tMempool* pool)
+{
+    (void) ptr;
+    (void) owner;
+    (void) pool;
+}
+
+size_t mpool_compact(_tMempool* pool, size_t max_bytes)
+{
+    (void) pool;
+    (void) max_bytes;
+    return 0;
+}
+#endif
+
+void tMempool_init(tMempool* const mp, char* memory, size_t size, LEAF* const leaf)
+{
+    tMempool_initToPool(mp, memory, size, &leaf->mempool);
+}
+
+void tMempool_initWithType(tMempool* const mp, char* memory, size_t size, MempoolType type, LEAF* const leaf)
+{
+    tMempool_initToPoolWithType(mp, memory, size, type, &leaf->mempool);
+}
+
+void tMempool_free(tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    
+    defer_drain(m->leaf);
+    
+#if !LEAF_USE_DYNAMIC_ALLOCATION
+    if (m->cache != NULL)
+    {
+        cache_flush(m);
+        mpool_free((char*)m->cache, m->mempool);
+    }
+#else
+    if (m->cache != NULL) mpool_free((char*)m->cache, m->mempool);
+#endif
+    
+#if LEAF_USE_MMAP
+    if (m->map_base != NULL) mapped_unmap(m);
+#endif
+
+    mpool_free((char*)m, m->mempool);
+}
+
+void    tMempool_reset          (tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    
+    mpool_reset(m);
+}
+
+void    tMempool_setAlignment   (tMempool* const mp, size_t alignment)
+{
+    _tMempool* m = *mp;
+    
+    m->alignment = mpool_alignment(alignment);
+}
+
+void    tMempool_setConcurrent  (tMempool* const mp, int concurrent)
+{
+    _tMempool* m = *mp;
+    
+    // Thread caches are always used concurrently
+    if (m->cache != NULL) return;
+    
+    m->concurrent = concurrent ? 1 : 0;
+    if (concurrent) m->leaf->concurrentMempools = 1;
+}
+
+void    tMempool_getStats       (tMempool* const mp, mpool_stats_t* stats)
+{
+    _tMempool* m = *mp;
+    
+    mpool_get_stats(m, stats);
+}
+
+int     tMempool_dump           (tMempool* const mp, char* buffer, size_t size)
+{
+    _tMempool* m = *mp;
+    
+    return mpool_dump(m, buffer, size);
+}
+
+void    tMempool_setClock       (tMempool* const mp, uint32_t (*clock)(void))
+{
+    _tMempool* m = *mp;
+    
+    m->clock = clock;
+}
+
+void    tMempool_registerHandle (tMempool* const mp, void* handle)
+{
+    _tMempool* m = *mp;
+    
+    mpool_set_owner(*(char**) handle, (void**) handle, m);
+}
+
+void    tMempool_unregisterHandle (tMempool* const mp, void* handle)
+{
+    _tMempool* m = *mp;
+    
+    mpool_set_owner(*(char**) handle, NULL, m);
+}
+
+size_t  tMempool_compact        (tMempool* const mp, size_t maxBytes)
+{
+    _tMempool* m = *mp;
+    
+    return mpool_compact(m, maxBytes);
+}
+
+void    tMempool_reserveSlabs   (tMempool* const mp, size_t size)
+{
+    _tMempool* m = *mp;
+    
+    mpool_reserve_slabs(size, m);
+}
+
+#if LEAF_USE_MMAP
+void    tMempool_initMapped     (tMempool* const mp, size_t size, MempoolType type, int flags, LEAF* const leaf)
+{
+    tMempool_initMappedToPool(mp, size, type, flags, &leaf->mempool);
+}
+
+void    tMempool_initMappedToPool (tMempool* const mp, size_t size, MempoolType type, int flags, tMempool* const mem)
+{
+    _tMempool* mm = *mem;
+    
+    char* memory = map_region(&size, flags);
+    if (memory == NULL)
+    {
+        *mp = NULL;
+        LEAF_internalErrorCallback(mm->leaf, LEAFMempoolOverrun);
+        return;
+    }
+    
+    _tMempool* m = *mp = (_tMempool*) mpool_alloc(sizeof(_tMempool), mm);
+    m->mempool = mm;
+    m->leaf = mm->leaf;
+    
+    mpool_create_with_type(memory, size, type, m);
+    m->map_flags = flags;
+    m->map_base = memory;
+    m->map_size = size;
+}
+#endif
+
+void    tMempool_initThreadCache (tMempool* const mp, tMempool* const shared)
+{
+    _tMempool* mm = *shared;
+    
+    // Everything allocated or freed through the shared pool from now on has to be serialized
+    if (!mm->concurrent) mm->concurrent = 1;
+    mm->leaf->concurrentMempools = 1;
+    
+    _tMempool* m = *mp = (_tMempool*) mpool_alloc(sizeof(_tMempool), mm);
+    m->mempool = mm;
+    m->leaf = mm->leaf;
+    m->mpool = mm->mpool;
+    m->usize = 0;
+    m->msize = mm->msize;
+    m->head = NULL;
+    m->type = mm->type;
+    m->tlsf = NULL;
+    m->alignment = mm->alignment;
+    m->concurrent = 1;
+    m->lock = 0;
+    m->slab = NULL;
+    memset(&m->stats, 0, sizeof(mpool_stats_t));
+    m->clock = NULL;
+#if LEAF_USE_MMAP
+    m->map_flags = 0;
+    m->map_base = NULL;
+    m->map_size = 0;
+    m->next = NULL;
+#endif
+    m->cache = (mpool_cache_t*) mpool_calloc(sizeof(mpool_cache_t), mm);
+}
+
+void    tMempool_initToPool     (tMempool* const mp, char* memory, size_t size, tMempool* const mem)
+{
+    tMempool_initToPoolWithType(mp, memory, size, MempoolFirstFit, mem);
+}
+
+void    tMempool_initToPoolWithType (tMempool* const mp, char* memory, size_t size, MempoolType type, tMempool* const mem)
+{
+    _tMempool* mm = *mem;
+    _tMempool* m = *mp = (_tMempool*) mpool_alloc(sizeof(_tMempool), mm);
+    m->mempool = mm;
+    m->leaf = mm->leaf;
+    
+    mpool_create_with_type (memory, size, type, m);
+}
+
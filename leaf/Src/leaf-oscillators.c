@@ -8,11 +8,13 @@
 
 #include "..\Inc\leaf-oscillators.h"
 #include "..\leaf.h"
+#include "..\Externals\d_fft_mayer.h"
 
 #else
 
 #include "../Inc/leaf-oscillators.h"
 #include "../leaf.h"
+#include "../Externals/d_fft_mayer.h"
 
 #endif
 
@@ -65,6 +67,70 @@ float   tCycle_tick(tCycle* const cy)
     return (samp0 + (samp1 - samp0) * ((float)tempFrac * 0.000000476837386f)); // 1/2097151 (2097151 is the 21 bits after the 11 bits that represent the main index)
 }
 
+// Block versions keep the state in locals and have no dependencies between
+// samples other than the phase, so the loops can be vectorized by the compiler
+void    tCycle_tickBlock(tCycle* const cy, float* const out, int size)
+{
+    _tCycle* c = *cy;
+    uint32_t phase = c->phase;
+    uint32_t inc = c->inc;
+    uint32_t mask = c->mask;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        phase += inc;
+        uint32_t idx = phase >> 21;
+        float frac = (float)(phase & 2097151) * 0.000000476837386f;
+        float samp0 = __leaf_table_sinewave[idx];
+        float samp1 = __leaf_table_sinewave[(idx + 1) & mask];
+        out[i] = samp0 + (samp1 - samp0) * frac;
+    }
+    
+    c->phase = phase;
+}
+
+void    tCycle_tickBlockFM(tCycle* const cy, float* const out, const float* const freq, int size)
+{
+    _tCycle* c = *cy;
+    uint32_t phase = c->phase;
+    uint32_t mask = c->mask;
+    float scale = c->invSampleRateTimesTwoTo32;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        // Going through a signed integer lets negative increments wrap the phase backwards
+        phase += (uint32_t)(int64_t)(freq[i] * scale);
+        uint32_t idx = phase >> 21;
+        float frac = (float)(phase & 2097151) * 0.000000476837386f;
+        float samp0 = __leaf_table_sinewave[idx];
+        float samp1 = __leaf_table_sinewave[(idx + 1) & mask];
+        out[i] = samp0 + (samp1 - samp0) * frac;
+    }
+    
+    c->phase = phase;
+}
+
+void    tCycle_tickBlockPM(tCycle* const cy, float* const out, const float* const phaseMod, int size)
+{
+    _tCycle* c = *cy;
+    uint32_t phase = c->phase;
+    uint32_t inc = c->inc;
+    uint32_t mask = c->mask;
+    
+    for (int i = 0; i < size; ++i)
+    {
+        phase += inc;
+        uint32_t p = phase + (uint32_t)(int64_t)(phaseMod[i] * TWO_TO_32);
+        uint32_t idx = p >> 21;
+        float frac = (float)(p & 2097151) * 0.000000476837386f;
+        float samp0 = __leaf_table_sinewave[idx];
+        float samp1 = __leaf_table_sinewave[(idx + 1) & mask];
+        out[i] = samp0 + (samp1 - samp0) * frac;
+    }
+    
+    c->phase = phase;
+}
+
 void     tCycle_setFreq(tCycle* const cy, float freq)
 {
     _tCycle* c = *cy;
@@ -91,6 +157,128 @@ void     tCycle_setSampleRate (tCycle* const cy, float sr)
     c->invSampleRateTimesTwoTo32 = (1.0f/sr) * TWO_TO_32;
     tCycle_setFreq(cy, c->freq);
 }
+
+//========================================================================
+/* Cycle bank */
+void    tCycleBank_init(tCycleBank* const cb, int numVoices, LEAF* const leaf)
+{
+    tCycleBank_initToPool(cb, numVoices, &leaf->mempool);
+}
+
+void    tCycleBank_initToPool   (tCycleBank* const cb, int numVoices, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tCycleBank* c = *cb = (_tCycleBank*) mpool_alloc(sizeof(_tCycleBank), m);
+    c->mempool = m;
+    LEAF* leaf = c->mempool->leaf;
+    
+    c->numVoices = numVoices;
+    c->phase = (uint32_t*) mpool_calloc_aligned(sizeof(uint32_t) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->inc = (uint32_t*) mpool_calloc_aligned(sizeof(uint32_t) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->freq = (float*) mpool_calloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->gain = (float*) mpool_alloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    for (int v = 0; v < numVoices; ++v) c->gain[v] = 1.0f;
+    c->invSampleRateTimesTwoTo32 = (leaf->invSampleRate * TWO_TO_32);
+    c->mask = SINE_TABLE_SIZE - 1;
+}
+
+void    tCycleBank_free (tCycleBank* const cb)
+{
+    _tCycleBank* c = *cb;
+    
+    mpool_free((char*)c->gain, c->mempool);
+    mpool_free((char*)c->freq, c->mempool);
+    mpool_free((char*)c->inc, c->mempool);
+    mpool_free((char*)c->phase, c->mempool);
+    mpool_free((char*)c, c->mempool);
+}
+
+// Each voice is rendered over the whole block in turn, so its phasor stays in
+// registers and the sample loop vectorizes the same way as tCycle_tickBlock
+void    tCycleBank_tickBlock(tCycleBank* const cb, float* const out, int size)
+{
+    _tCycleBank* c = *cb;
+    uint32_t mask = c->mask;
+    
+    for (int i = 0; i < size; ++i) out[i] = 0.0f;
+    
+    for (int v = 0; v < c->numVoices; ++v)
+    {
+        uint32_t phase = c->phase[v];
+        uint32_t inc = c->inc[v];
+        float gain = c->gain[v];
+        
+        for (int i = 0; i < size; ++i)
+        {
+            phase += inc;
+            uint32_t idx = phase >> 21;
+            float frac = (float)(phase & 2097151) * 0.000000476837386f;
+            float samp0 = __leaf_table_sinewave[idx];
+            float samp1 = __leaf_table_sinewave[(idx + 1) & mask];
+            out[i] += gain * (samp0 + (samp1 - samp0) * frac);
+        }
+        
+        c->phase[v] = phase;
+    }
+}
+
+void    tCycleBank_tickBlockVoices(tCycleBank* const cb, float** const outs, int size)
+{
+    _tCycleBank* c = *cb;
+    uint32_t mask = c->mask;
+    
+    for (int v = 0; v < c->numVoices; ++v)
+    {
+        float* out = outs[v];
+        uint32_t phase = c->phase[v];
+        uint32_t inc = c->inc[v];
+        float gain = c->gain[v];
+        
+        for (int i = 0; i < size; ++i)
+        {
+            phase += inc;
+            uint32_t idx = phase >> 21;
+            float frac = (float)(phase & 2097151) * 0.000000476837386f;
+            float samp0 = __leaf_table_sinewave[idx];
+            float samp1 = __leaf_table_sinewave[(idx + 1) & mask];
+            out[i] = gain * (samp0 + (samp1 - samp0) * frac);
+        }
+        
+        c->phase[v] = phase;
+    }
+}
+
+void    tCycleBank_setFreq(tCycleBank* const cb, int voice, float freq)
+{
+    _tCycleBank* c = *cb;
+    
+    c->freq[voice] = freq;
+    c->inc[voice] = freq * c->invSampleRateTimesTwoTo32;
+}
+
+void    tCycleBank_setPhase(tCycleBank* const cb, int voice, float phase)
+{
+    _tCycleBank* c = *cb;
+    
+    int i = phase;
+    phase -= i;
+    c->phase[voice] = phase * TWO_TO_32;
+}
+
+void    tCycleBank_setGain(tCycleBank* const cb, int voice, float gain)
+{
+    _tCycleBank* c = *cb;
+    
+    c->gain[voice] = gain;
+}
+
+void    tCycleBank_setSampleRate(tCycleBank* const cb, float sr)
+{
+    _tCycleBank* c = *cb;
+    
+    c->invSampleRateTimesTwoTo32 = (1.0f/sr) * TWO_TO_32;
+    for (int v = 0; v < c->numVoices; ++v) tCycleBank_setFreq(cb, v, c->freq[v]);
+}
 #endif // LEAF_INCLUDE_SINE_TABLE
 
 #if LEAF_INCLUDE_TRIANGLE_TABLE
@@ -375,10 +563,291 @@ void     tSawtooth_setSampleRate (tSawtooth* const cy, float sr)
     tSawtooth_setFreq(cy, c->freq);
 }
 
+//========================================================================
+/* Sawtooth bank */
+void    tSawBank_init(tSawBank* const sb, int numVoices, LEAF* const leaf)
+{
+    tSawBank_initToPool(sb, numVoices, &leaf->mempool);
+}
+
+void    tSawBank_initToPool     (tSawBank* const sb, int numVoices, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tSawBank* c = *sb = (_tSawBank*) mpool_alloc(sizeof(_tSawBank), m);
+    c->mempool = m;
+    LEAF* leaf = c->mempool->leaf;
+    
+    c->numVoices = numVoices;
+    c->phase = (uint32_t*) mpool_calloc_aligned(sizeof(uint32_t) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->inc = (uint32_t*) mpool_calloc_aligned(sizeof(uint32_t) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->freq = (float*) mpool_calloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->gain = (float*) mpool_alloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->oct = (int*) mpool_calloc_aligned(sizeof(int) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->w = (float*) mpool_calloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->invSampleRate = leaf->invSampleRate;
+    c->invSampleRateTimesTwoTo32 = (c->invSampleRate * TWO_TO_32);
+    c->mask = SAW_TABLE_SIZE - 1;
+    for (int v = 0; v < numVoices; ++v)
+    {
+        c->gain[v] = 1.0f;
+        tSawBank_setFreq(sb, v, 220);
+    }
+}
+
+void    tSawBank_free (tSawBank* const sb)
+{
+    _tSawBank* c = *sb;
+    
+    mpool_free((char*)c->w, c->mempool);
+    mpool_free((char*)c->oct, c->mempool);
+    mpool_free((char*)c->gain, c->mempool);
+    mpool_free((char*)c->freq, c->mempool);
+    mpool_free((char*)c->inc, c->mempool);
+    mpool_free((char*)c->phase, c->mempool);
+    mpool_free((char*)c, c->mempool);
+}
+
+static inline void sawbank_voice(_tSawBank* c, int v, float* const out, int size, int accumulate)
+{
+    uint32_t mask = c->mask;
+    uint32_t phase = c->phase[v];
+    uint32_t inc = c->inc[v];
+    float gain = c->gain[v];
+    float w = c->w[v];
+    const float* table0 = __leaf_table_sawtooth[c->oct[v]];
+    const float* table1 = __leaf_table_sawtooth[c->oct[v]+1];
+    
+    for (int i = 0; i < size; ++i)
+    {
+        phase += inc;
+        uint32_t idx = phase >> 21;
+        uint32_t idx2 = (idx + 1) & mask;
+        float frac = (float)(phase & 2097151) * 0.000000476837386f;
+        
+        float samp0 = table0[idx];
+        float samp1 = table0[idx2];
+        float oct0 = (samp0 + (samp1 - samp0) * frac);
+        
+        samp0 = table1[idx];
+        samp1 = table1[idx2];
+        float oct1 = (samp0 + (samp1 - samp0) * frac);
+        
+        float sample = gain * (oct0 + (oct1 - oct0) * w);
+        if (accumulate) out[i] += sample;
+        else out[i] = sample;
+    }
+    
+    c->phase[v] = phase;
+}
+
+void    tSawBank_tickBlock(tSawBank* const sb, float* const out, int size)
+{
+    _tSawBank* c = *sb;
+    
+    for (int i = 0; i < size; ++i) out[i] = 0.0f;
+    for (int v = 0; v < c->numVoices; ++v) sawbank_voice(c, v, out, size, 1);
+}
+
+void    tSawBank_tickBlockVoices(tSawBank* const sb, float** const outs, int size)
+{
+    _tSawBank* c = *sb;
+    
+    for (int v = 0; v < c->numVoices; ++v) sawbank_voice(c, v, outs[v], size, 0);
+}
+
+void    tSawBank_setFreq(tSawBank* const sb, int voice, float freq)
+{
+    _tSawBank* c = *sb;
+    
+    c->freq[voice] = freq;
+    c->inc[voice] = freq * c->invSampleRateTimesTwoTo32;
+    
+    // Same table selection as tSawtooth_setFreq
+    float w = fabsf(freq * (SAW_TABLE_SIZE * c->invSampleRate));
+    w = log2f_approx(w);
+    if (w < 0.0f) w = 0.0f;
+    int oct = (int)w;
+    w -= oct;
+    if (oct >= 10) oct = 9;
+    c->oct[voice] = oct;
+    c->w[voice] = w;
+}
+
+void    tSawBank_setPhase(tSawBank* const sb, int voice, float phase)
+{
+    _tSawBank* c = *sb;
+    
+    int i = phase;
+    phase -= i;
+    c->phase[voice] = phase * TWO_TO_32;
+}
+
+void    tSawBank_setGain(tSawBank* const sb, int voice, float gain)
+{
+    _tSawBank* c = *sb;
+    
+    c->gain[voice] = gain;
+}
+
+void    tSawBank_setSampleRate(tSawBank* const sb, float sr)
+{
+    _tSawBank* c = *sb;
+    
+    c->invSampleRate = 1.0f/sr;
+    c->invSampleRateTimesTwoTo32 = c->invSampleRate * TWO_TO_32;
+    for (int v = 0; v < c->numVoices; ++v) tSawBank_setFreq(sb, v, c->freq[v]);
+}
+
 #endif // LEAF_INCLUDE_SAWTOOTH_TABLE
 
 //==============================================================================
 
+// The polyBLEP oscillators keep their phase in 32-bit fixed point, so that the
+// phase of any sample in a block can be computed without going through the ones
+// before it. Block rendering works through PB_BLOCK_SIZE samples at a time: the
+// naive waveform is written in one pass, which also notes whether any sample is
+// close enough to an edge to need a correction, and the corrections are then
+// applied to only those samples.
+#define PB_BLOCK_SIZE 16
+
+// Converts the fractional part of a phase or an increment to fixed point
+static inline uint32_t pb_fixed(float phase)
+{
+    phase -= (int)phase;
+    return (uint32_t)(int32_t)(phase * 2147483648.0f) << 1;
+}
+
+// The top 24 bits of a fixed point phase convert exactly to a float in [0, 1)
+static inline float pb_phase(uint32_t phase)
+{
+    return (float)(phase >> 8) * (1.0f / 16777216.0f);
+}
+
+static inline void pbsaw_render(uint32_t* const phase, uint32_t phaseInc, float inc, float gain,
+                                float* const out, int size, int accumulate)
+{
+    float t[PB_BLOCK_SIZE];
+    float buffer[PB_BLOCK_SIZE];
+    uint32_t p = *phase;
+    float hi = 1.0f - inc;
+    
+    for (int s = 0; s < size; s += PB_BLOCK_SIZE)
+    {
+        int n = size - s < PB_BLOCK_SIZE ? size - s : PB_BLOCK_SIZE;
+        float* x = accumulate ? buffer : out + s;
+        int edges = 0;
+        
+        for (int i = 0; i < n; ++i)
+        {
+            t[i] = pb_phase(p + (uint32_t)i * phaseInc);
+            x[i] = (t[i] * 2.0f) - 1.0f;
+            edges |= (t[i] < inc) | (t[i] > hi);
+        }
+        p += (uint32_t)n * phaseInc;
+        
+        if (edges)
+        {
+            for (int i = 0; i < n; ++i)
+                if ((t[i] < inc) | (t[i] > hi)) x[i] -= LEAF_poly_blep(t[i], inc);
+        }
+        
+        if (accumulate) for (int i = 0; i < n; ++i) out[s + i] += gain * x[i];
+        else for (int i = 0; i < n; ++i) x[i] *= gain;
+    }
+    
+    *phase = p;
+}
+
+// Square wave with polyBLEP corrections at both edges, shared by tPBPulse and
+// tPBTriangle. Samples where phase is below width are high.
+static inline void pbpulse_naive(float* const x, float* const t, uint32_t p, uint32_t phaseInc,
+                                 float width, float inc, int n)
+{
+    uint32_t offset = pb_fixed(1.0f - width);
+    float hi = 1.0f - inc;
+    float t2[PB_BLOCK_SIZE];
+    int edges = 0;
+    
+    for (int i = 0; i < n; ++i)
+    {
+        uint32_t pi = p + (uint32_t)i * phaseInc;
+        t[i] = pb_phase(pi);
+        t2[i] = pb_phase(pi + offset);
+        x[i] = t[i] < width ? 1.0f : -1.0f;
+        edges |= (t[i] < inc) | (t[i] > hi) | (t2[i] < inc) | (t2[i] > hi);
+    }
+    
+    if (edges)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            if ((t[i] < inc) | (t[i] > hi) | (t2[i] < inc) | (t2[i] > hi))
+            {
+                x[i] += LEAF_poly_blep(t[i], inc);
+                x[i] -= LEAF_poly_blep(t2[i], inc);
+            }
+        }
+    }
+}
+
+static inline void pbpulse_render(uint32_t* const phase, uint32_t phaseInc, float inc, float width, float gain,
+                                  float* const out, int size, int accumulate)
+{
+    float t[PB_BLOCK_SIZE];
+    float buffer[PB_BLOCK_SIZE];
+    uint32_t p = *phase;
+    
+    for (int s = 0; s < size; s += PB_BLOCK_SIZE)
+    {
+        int n = size - s < PB_BLOCK_SIZE ? size - s : PB_BLOCK_SIZE;
+        float* x = accumulate ? buffer : out + s;
+        
+        pbpulse_naive(x, t, p, phaseInc, width, inc, n);
+        p += (uint32_t)n * phaseInc;
+        
+        if (accumulate) for (int i = 0; i < n; ++i) out[s + i] += gain * x[i];
+        else for (int i = 0; i < n; ++i) x[i] *= gain;
+    }
+    
+    *phase = p;
+}
+
+// The triangle integrates the square wave with a leaky integrator, which is the
+// only part that has to run one sample after another
+static inline void pbtriangle_render(uint32_t* const phase, float* const lastOut, uint32_t phaseInc, float inc,
+                                     float skew, float gain, float* const out, int size, int accumulate)
+{
+    float t[PB_BLOCK_SIZE];
+    float x[PB_BLOCK_SIZE];
+    uint32_t p = *phase;
+    float y = *lastOut;
+    float up = ((1.0f - skew) * 2.0f) * inc;
+    float down = (skew * 2.0f) * inc;
+    float leak = 1.0f - inc;
+    
+    for (int s = 0; s < size; s += PB_BLOCK_SIZE)
+    {
+        int n = size - s < PB_BLOCK_SIZE ? size - s : PB_BLOCK_SIZE;
+        
+        pbpulse_naive(x, t, p, phaseInc, skew, inc, n);
+        p += (uint32_t)n * phaseInc;
+        for (int i = 0; i < n; ++i) x[i] *= t[i] < skew ? up : down;
+        
+        float* o = out + s;
+        for (int i = 0; i < n; ++i)
+        {
+            y = x[i] + (leak * y);
+            if (accumulate) o[i] += gain * y;
+            else o[i] = gain * y;
+        }
+    }
+    
+    *phase = p;
+    *lastOut = y;
+}
+
+//==============================================================================
+
 /* tTri: Anti-aliased Triangle waveform. */
 void    tPBTriangle_init          (tPBTriangle* const osc, LEAF* const leaf)
 {
@@ -394,7 +863,8 @@ void    tPBTriangle_initToPool    (tPBTriangle* const osc, tMempool* const mp)
 
     c->invSampleRate = leaf->invSampleRate;
     c->inc      =  0.0f;
-    c->phase    =  0.0f;
+    c->phaseInc =  0;
+    c->phase    =  0;
     c->skew     =  0.5f;
     c->lastOut  =  0.0f;
 }
@@ -412,8 +882,9 @@ float   tPBTriangle_tick          (tPBTriangle* const osc)
     
     float out;
     float skew;
+    float t = pb_phase(c->phase);
     
-    if (c->phase < c->skew)
+    if (t < c->skew)
     {
         out = 1.0f;
         skew = (1.0f - c->skew) * 2.0f;
@@ -424,25 +895,31 @@ float   tPBTriangle_tick          (tPBTriangle* const osc)
         skew = c->skew * 2.0f;
     }
     
-    out += LEAF_poly_blep(c->phase, c->inc);
-    out -= LEAF_poly_blep(fmodf(c->phase + (1.0f - c->skew), 1.0f), c->inc);
+    out += LEAF_poly_blep(t, c->inc);
+    out -= LEAF_poly_blep(pb_phase(c->phase + pb_fixed(1.0f - c->skew)), c->inc);
     
-    out = (skew * c->inc * out) + ((1 - c->inc) * c->lastOut);
+    out = ((skew * c->inc) * out) + ((1.0f - c->inc) * c->lastOut);
     c->lastOut = out;
     
-    c->phase += c->inc - (int)c->inc;
-    if (c->phase >= 1.0f) c->phase -= 1.0f;
-    if (c->phase < 0.0f) c->phase += 1.0f;
+    c->phase += c->phaseInc;
     
     return out;
 }
 
+void    tPBTriangle_tickBlock     (tPBTriangle* const osc, float* const out, int size)
+{
+    _tPBTriangle* c = *osc;
+    
+    pbtriangle_render(&c->phase, &c->lastOut, c->phaseInc, c->inc, c->skew, 1.0f, out, size, 0);
+}
+
 void    tPBTriangle_setFreq       (tPBTriangle* const osc, float freq)
 {
     _tPBTriangle* c = *osc;
     
     c->freq  = freq;
     c->inc = freq * c->invSampleRate;
+    c->phaseInc = pb_fixed(c->inc);
 }
 
 void    tPBTriangle_setSkew       (tPBTriangle* const osc, float skew)
@@ -477,7 +954,8 @@ void    tPBPulse_initToPool  (tPBPulse* const osc, tMempool* const mp)
     
     c->invSampleRate = leaf->invSampleRate;
     c->inc      =  0.0f;
-    c->phase    =  0.0f;
+    c->phaseInc =  0;
+    c->phase    =  0;
     c->width     =  0.5f;
 }
 
@@ -493,24 +971,31 @@ float   tPBPulse_tick        (tPBPulse* const osc)
     _tPBPulse* c = *osc;
     
     float out;
-    if (c->phase < c->width) out = 1.0f;
+    float t = pb_phase(c->phase);
+    if (t < c->width) out = 1.0f;
     else out = -1.0f;
-    out += LEAF_poly_blep(c->phase, c->inc);
-    out -= LEAF_poly_blep(fmodf(c->phase + (1.0f - c->width), 1.0f), c->inc);
+    out += LEAF_poly_blep(t, c->inc);
+    out -= LEAF_poly_blep(pb_phase(c->phase + pb_fixed(1.0f - c->width)), c->inc);
     
-    c->phase += c->inc - (int)c->inc;
-    if (c->phase >= 1.0f) c->phase -= 1.0f;
-    if (c->phase < 0.0f) c->phase += 1.0f;
+    c->phase += c->phaseInc;
     
     return out;
 }
 
+void    tPBPulse_tickBlock   (tPBPulse* const osc, float* const out, int size)
+{
+    _tPBPulse* c = *osc;
+    
+    pbpulse_render(&c->phase, c->phaseInc, c->inc, c->width, 1.0f, out, size, 0);
+}
+
 void    tPBPulse_setFreq     (tPBPulse* const osc, float freq)
 {
     _tPBPulse* c = *osc;
     
     c->freq  = freq;
     c->inc = freq * c->invSampleRate;
+    c->phaseInc = pb_fixed(c->inc);
 }
 
 void    tPBPulse_setWidth    (tPBPulse* const osc, float width)
@@ -543,7 +1028,8 @@ void    tPBSaw_initToPool    (tPBSaw* const osc, tMempool* const mp)
     LEAF* leaf = c->mempool->leaf;
     
     c->inc      =  0.0f;
-    c->phase    =  0.0f;
+    c->phaseInc =  0;
+    c->phase    =  0;
     c->invSampleRate = leaf->invSampleRate;
 }
 
@@ -558,22 +1044,29 @@ float   tPBSaw_tick          (tPBSaw* const osc)
 {
     _tPBSaw* c = *osc;
     
-    float out = (c->phase * 2.0f) - 1.0f;
-    out -= LEAF_poly_blep(c->phase, c->inc);
+    float t = pb_phase(c->phase);
+    float out = (t * 2.0f) - 1.0f;
+    out -= LEAF_poly_blep(t, c->inc);
     
-    c->phase += c->inc - (int)c->inc;
-    if (c->phase >= 1.0f) c->phase -= 1.0f;
-    if (c->phase < 0.0f) c->phase += 1.0f;
+    c->phase += c->phaseInc;
     
     return out;
 }
 
+void    tPBSaw_tickBlock     (tPBSaw* const osc, float* const out, int size)
+{
+    _tPBSaw* c = *osc;
+    
+    pbsaw_render(&c->phase, c->phaseInc, c->inc, 1.0f, out, size, 0);
+}
+
 void    tPBSaw_setFreq       (tPBSaw* const osc, float freq)
 {
     _tPBSaw* c = *osc;
     
     c->freq  = freq;
     c->inc = freq * c->invSampleRate;
+    c->phaseInc = pb_fixed(c->inc);
 }
 
 void    tPBSaw_setSampleRate (tPBSaw* const osc, float sr)
@@ -584,52 +1077,323 @@ void    tPBSaw_setSampleRate (tPBSaw* const osc, float sr)
     tPBSaw_setFreq(osc, c->freq);
 }
 
-//========================================================================
-/* Phasor */
+//==============================================================================
 
-void    tPhasor_init(tPhasor* const ph, LEAF* const leaf)
+/* Banks of polyBLEP oscillators */
+void    tPBSawBank_init         (tPBSawBank* const bank, int numVoices, LEAF* const leaf)
 {
-    tPhasor_initToPool(ph, &leaf->mempool);
+    tPBSawBank_initToPool(bank, numVoices, &leaf->mempool);
 }
 
-void    tPhasor_initToPool  (tPhasor* const ph, tMempool* const mp)
+void    tPBSawBank_initToPool   (tPBSawBank* const bank, int numVoices, tMempool* const mp)
 {
     _tMempool* m = *mp;
-    _tPhasor* p = *ph = (_tPhasor*) mpool_alloc(sizeof(_tPhasor), m);
-    p->mempool = m;
-    LEAF* leaf = p->mempool->leaf;
+    _tPBSawBank* c = *bank = (_tPBSawBank*) mpool_alloc(sizeof(_tPBSawBank), m);
+    c->mempool = m;
+    LEAF* leaf = c->mempool->leaf;
     
-    p->phase = 0.0f;
-    p->inc = 0.0f;
-    p->phaseDidReset = 0;
-    p->invSampleRate = leaf->invSampleRate;
+    c->numVoices = numVoices;
+    c->phase = (uint32_t*) mpool_calloc_aligned(sizeof(uint32_t) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->phaseInc = (uint32_t*) mpool_calloc_aligned(sizeof(uint32_t) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->inc = (float*) mpool_calloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->freq = (float*) mpool_calloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->gain = (float*) mpool_alloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->invSampleRate = leaf->invSampleRate;
+    for (int v = 0; v < numVoices; ++v) c->gain[v] = 1.0f;
 }
 
-void    tPhasor_free (tPhasor* const ph)
+void    tPBSawBank_free         (tPBSawBank* const bank)
 {
-    _tPhasor* p = *ph;
+    _tPBSawBank* c = *bank;
     
-    mpool_free((char*)p, p->mempool);
+    mpool_free((char*)c->gain, c->mempool);
+    mpool_free((char*)c->freq, c->mempool);
+    mpool_free((char*)c->inc, c->mempool);
+    mpool_free((char*)c->phaseInc, c->mempool);
+    mpool_free((char*)c->phase, c->mempool);
+    mpool_free((char*)c, c->mempool);
 }
 
-void    tPhasor_setFreq(tPhasor* const ph, float freq)
+void    tPBSawBank_tickBlock    (tPBSawBank* const bank, float* const out, int size)
 {
-    _tPhasor* p = *ph;
+    _tPBSawBank* c = *bank;
+    
+    for (int i = 0; i < size; ++i) out[i] = 0.0f;
+    for (int v = 0; v < c->numVoices; ++v)
+        pbsaw_render(&c->phase[v], c->phaseInc[v], c->inc[v], c->gain[v], out, size, 1);
+}
 
-    p->freq  = freq;
+void    tPBSawBank_tickBlockVoices(tPBSawBank* const bank, float** const outs, int size)
+{
+    _tPBSawBank* c = *bank;
     
-    p->inc = freq * p->invSampleRate;
-    p->inc -= (int)p->inc;
+    for (int v = 0; v < c->numVoices; ++v)
+        pbsaw_render(&c->phase[v], c->phaseInc[v], c->inc[v], c->gain[v], outs[v], size, 0);
 }
 
-float   tPhasor_tick(tPhasor* const ph)
+void    tPBSawBank_setFreq      (tPBSawBank* const bank, int voice, float freq)
 {
-    _tPhasor* p = *ph;
+    _tPBSawBank* c = *bank;
     
-    p->phase += p->inc;
+    c->freq[voice] = freq;
+    c->inc[voice] = freq * c->invSampleRate;
+    c->phaseInc[voice] = pb_fixed(c->inc[voice]);
+}
 
-    p->phaseDidReset = 0;
-    if (p->phase >= 1.0f)
+void    tPBSawBank_setPhase     (tPBSawBank* const bank, int voice, float phase)
+{
+    _tPBSawBank* c = *bank;
+    c->phase[voice] = pb_fixed(phase);
+}
+
+void    tPBSawBank_setGain      (tPBSawBank* const bank, int voice, float gain)
+{
+    _tPBSawBank* c = *bank;
+    c->gain[voice] = gain;
+}
+
+void    tPBSawBank_setSampleRate(tPBSawBank* const bank, float sr)
+{
+    _tPBSawBank* c = *bank;
+    
+    c->invSampleRate = 1.0f/sr;
+    for (int v = 0; v < c->numVoices; ++v) tPBSawBank_setFreq(bank, v, c->freq[v]);
+}
+
+void    tPBPulseBank_init       (tPBPulseBank* const bank, int numVoices, LEAF* const leaf)
+{
+    tPBPulseBank_initToPool(bank, numVoices, &leaf->mempool);
+}
+
+void    tPBPulseBank_initToPool (tPBPulseBank* const bank, int numVoices, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tPBPulseBank* c = *bank = (_tPBPulseBank*) mpool_alloc(sizeof(_tPBPulseBank), m);
+    c->mempool = m;
+    LEAF* leaf = c->mempool->leaf;
+    
+    c->numVoices = numVoices;
+    c->phase = (uint32_t*) mpool_calloc_aligned(sizeof(uint32_t) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->phaseInc = (uint32_t*) mpool_calloc_aligned(sizeof(uint32_t) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->inc = (float*) mpool_calloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->freq = (float*) mpool_calloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->width = (float*) mpool_alloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->gain = (float*) mpool_alloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->invSampleRate = leaf->invSampleRate;
+    for (int v = 0; v < numVoices; ++v)
+    {
+        c->width[v] = 0.5f;
+        c->gain[v] = 1.0f;
+    }
+}
+
+void    tPBPulseBank_free       (tPBPulseBank* const bank)
+{
+    _tPBPulseBank* c = *bank;
+    
+    mpool_free((char*)c->gain, c->mempool);
+    mpool_free((char*)c->width, c->mempool);
+    mpool_free((char*)c->freq, c->mempool);
+    mpool_free((char*)c->inc, c->mempool);
+    mpool_free((char*)c->phaseInc, c->mempool);
+    mpool_free((char*)c->phase, c->mempool);
+    mpool_free((char*)c, c->mempool);
+}
+
+void    tPBPulseBank_tickBlock  (tPBPulseBank* const bank, float* const out, int size)
+{
+    _tPBPulseBank* c = *bank;
+    
+    for (int i = 0; i < size; ++i) out[i] = 0.0f;
+    for (int v = 0; v < c->numVoices; ++v)
+        pbpulse_render(&c->phase[v], c->phaseInc[v], c->inc[v], c->width[v], c->gain[v], out, size, 1);
+}
+
+void    tPBPulseBank_tickBlockVoices(tPBPulseBank* const bank, float** const outs, int size)
+{
+    _tPBPulseBank* c = *bank;
+    
+    for (int v = 0; v < c->numVoices; ++v)
+        pbpulse_render(&c->phase[v], c->phaseInc[v], c->inc[v], c->width[v], c->gain[v], outs[v], size, 0);
+}
+
+void    tPBPulseBank_setFreq    (tPBPulseBank* const bank, int voice, float freq)
+{
+    _tPBPulseBank* c = *bank;
+    
+    c->freq[voice] = freq;
+    c->inc[voice] = freq * c->invSampleRate;
+    c->phaseInc[voice] = pb_fixed(c->inc[voice]);
+}
+
+void    tPBPulseBank_setWidth   (tPBPulseBank* const bank, int voice, float width)
+{
+    _tPBPulseBank* c = *bank;
+    c->width[voice] = width;
+}
+
+void    tPBPulseBank_setPhase   (tPBPulseBank* const bank, int voice, float phase)
+{
+    _tPBPulseBank* c = *bank;
+    c->phase[voice] = pb_fixed(phase);
+}
+
+void    tPBPulseBank_setGain    (tPBPulseBank* const bank, int voice, float gain)
+{
+    _tPBPulseBank* c = *bank;
+    c->gain[voice] = gain;
+}
+
+void    tPBPulseBank_setSampleRate(tPBPulseBank* const bank, float sr)
+{
+    _tPBPulseBank* c = *bank;
+    
+    c->invSampleRate = 1.0f/sr;
+    for (int v = 0; v < c->numVoices; ++v) tPBPulseBank_setFreq(bank, v, c->freq[v]);
+}
+
+void    tPBTriangleBank_init    (tPBTriangleBank* const bank, int numVoices, LEAF* const leaf)
+{
+    tPBTriangleBank_initToPool(bank, numVoices, &leaf->mempool);
+}
+
+void    tPBTriangleBank_initToPool(tPBTriangleBank* const bank, int numVoices, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tPBTriangleBank* c = *bank = (_tPBTriangleBank*) mpool_alloc(sizeof(_tPBTriangleBank), m);
+    c->mempool = m;
+    LEAF* leaf = c->mempool->leaf;
+    
+    c->numVoices = numVoices;
+    c->phase = (uint32_t*) mpool_calloc_aligned(sizeof(uint32_t) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->phaseInc = (uint32_t*) mpool_calloc_aligned(sizeof(uint32_t) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->inc = (float*) mpool_calloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->freq = (float*) mpool_calloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->skew = (float*) mpool_alloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->gain = (float*) mpool_alloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->lastOut = (float*) mpool_calloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->invSampleRate = leaf->invSampleRate;
+    for (int v = 0; v < numVoices; ++v)
+    {
+        c->skew[v] = 0.5f;
+        c->gain[v] = 1.0f;
+    }
+}
+
+void    tPBTriangleBank_free    (tPBTriangleBank* const bank)
+{
+    _tPBTriangleBank* c = *bank;
+    
+    mpool_free((char*)c->lastOut, c->mempool);
+    mpool_free((char*)c->gain, c->mempool);
+    mpool_free((char*)c->skew, c->mempool);
+    mpool_free((char*)c->freq, c->mempool);
+    mpool_free((char*)c->inc, c->mempool);
+    mpool_free((char*)c->phaseInc, c->mempool);
+    mpool_free((char*)c->phase, c->mempool);
+    mpool_free((char*)c, c->mempool);
+}
+
+void    tPBTriangleBank_tickBlock(tPBTriangleBank* const bank, float* const out, int size)
+{
+    _tPBTriangleBank* c = *bank;
+    
+    for (int i = 0; i < size; ++i) out[i] = 0.0f;
+    for (int v = 0; v < c->numVoices; ++v)
+        pbtriangle_render(&c->phase[v], &c->lastOut[v], c->phaseInc[v], c->inc[v], c->skew[v], c->gain[v],
+                          out, size, 1);
+}
+
+void    tPBTriangleBank_tickBlockVoices(tPBTriangleBank* const bank, float** const outs, int size)
+{
+    _tPBTriangleBank* c = *bank;
+    
+    for (int v = 0; v < c->numVoices; ++v)
+        pbtriangle_render(&c->phase[v], &c->lastOut[v], c->phaseInc[v], c->inc[v], c->skew[v], c->gain[v],
+                          outs[v], size, 0);
+}
+
+void    tPBTriangleBank_setFreq (tPBTriangleBank* const bank, int voice, float freq)
+{
+    _tPBTriangleBank* c = *bank;
+    
+    c->freq[voice] = freq;
+    c->inc[voice] = freq * c->invSampleRate;
+    c->phaseInc[voice] = pb_fixed(c->inc[voice]);
+}
+
+void    tPBTriangleBank_setSkew (tPBTriangleBank* const bank, int voice, float skew)
+{
+    _tPBTriangleBank* c = *bank;
+    c->skew[voice] = (skew + 1.0f) * 0.5f;
+}
+
+void    tPBTriangleBank_setPhase(tPBTriangleBank* const bank, int voice, float phase)
+{
+    _tPBTriangleBank* c = *bank;
+    c->phase[voice] = pb_fixed(phase);
+}
+
+void    tPBTriangleBank_setGain (tPBTriangleBank* const bank, int voice, float gain)
+{
+    _tPBTriangleBank* c = *bank;
+    c->gain[voice] = gain;
+}
+
+void    tPBTriangleBank_setSampleRate(tPBTriangleBank* const bank, float sr)
+{
+    _tPBTriangleBank* c = *bank;
+    
+    c->invSampleRate = 1.0f/sr;
+    for (int v = 0; v < c->numVoices; ++v) tPBTriangleBank_setFreq(bank, v, c->freq[v]);
+}
+
+//========================================================================
+/* Phasor */
+
+void    tPhasor_init(tPhasor* const ph, LEAF* const leaf)
+{
+    tPhasor_initToPool(ph, &leaf->mempool);
+}
+
+void    tPhasor_initToPool  (tPhasor* const ph, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tPhasor* p = *ph = (_tPhasor*) mpool_alloc(sizeof(_tPhasor), m);
+    p->mempool = m;
+    LEAF* leaf = p->mempool->leaf;
+    
+    p->phase = 0.0f;
+    p->inc = 0.0f;
+    p->phaseDidReset = 0;
+    p->invSampleRate = leaf->invSampleRate;
+}
+
+void    tPhasor_free (tPhasor* const ph)
+{
+    _tPhasor* p = *ph;
+    
+    mpool_free((char*)p, p->mempool);
+}
+
+void    tPhasor_setFreq(tPhasor* const ph, float freq)
+{
+    _tPhasor* p = *ph;
+
+    p->freq  = freq;
+    
+    p->inc = freq * p->invSampleRate;
+    p->inc -= (int)p->inc;
+}
+
+float   tPhasor_tick(tPhasor* const ph)
+{
+    _tPhasor* p = *ph;
+    
+    p->phase += p->inc;
+
+    p->phaseDidReset = 0;
+    if (p->phase >= 1.0f)
     {
         p->phaseDidReset = 1;
         p->phase -= 1.0f;
@@ -667,6 +1431,10 @@ void    tNoise_initToPool   (tNoise* const ns, NoiseType type, tMempool* const m
     
     n->type = type;
     n->rand = leaf->random;
+    n->state = 0;
+    n->pinkb0 = 0.0f;
+    n->pinkb1 = 0.0f;
+    n->pinkb2 = 0.0f;
 }
 
 void    tNoise_free (tNoise* const ns)
@@ -676,11 +1444,32 @@ void    tNoise_free (tNoise* const ns)
     mpool_free((char*)n, n->mempool);
 }
 
+// The built-in generator hashes a Weyl sequence, so each sample depends only on
+// the state and how far along it is, and a block has no dependency between
+// samples. The hash is lowbias32 by Chris Wellons.
+#define NOISE_WEYL_STEP 0x9e3779b9u
+
+static inline float noise_white(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return (float) (int32_t) x * (1.0f / 2147483648.0f);
+}
+
 float   tNoise_tick(tNoise* const ns)
 {
     _tNoise* n = *ns;
     
-    float rand = (n->rand() * 2.0f) - 1.0f;
+    float rand;
+    if (n->rand != NULL) rand = (n->rand() * 2.0f) - 1.0f;
+    else
+    {
+        n->state += NOISE_WEYL_STEP;
+        rand = noise_white(n->state);
+    }
     
     if (n->type == PinkNoise)
     {
@@ -697,6 +1486,61 @@ float   tNoise_tick(tNoise* const ns)
     }
 }
 
+void    tNoise_tickBlock(tNoise* const ns, float* const out, int size)
+{
+    _tNoise* n = *ns;
+    
+    if (n->rand != NULL)
+    {
+        for (int i = 0; i < size; ++i) out[i] = (n->rand() * 2.0f) - 1.0f;
+    }
+    else
+    {
+        uint32_t state = n->state;
+        for (int i = 0; i < size; ++i)
+        {
+            out[i] = noise_white(state + (uint32_t) (i + 1) * NOISE_WEYL_STEP);
+        }
+        n->state = state + (uint32_t) size * NOISE_WEYL_STEP;
+    }
+    
+    if (n->type == PinkNoise)
+    {
+        // The filter is recursive, so it runs as a second pass over the white noise
+        float pinkb0 = n->pinkb0;
+        float pinkb1 = n->pinkb1;
+        float pinkb2 = n->pinkb2;
+        for (int i = 0; i < size; ++i)
+        {
+            float rand = out[i];
+            pinkb0 = 0.99765f * pinkb0 + rand * 0.0990460f;
+            pinkb1 = 0.96300f * pinkb1 + rand * 0.2965164f;
+            pinkb2 = 0.57000f * pinkb2 + rand * 1.0526913f;
+            float tmp = pinkb0 + pinkb1 + pinkb2 + rand * 0.1848f;
+            out[i] = (tmp * 0.05f);
+        }
+        n->pinkb0 = pinkb0;
+        n->pinkb1 = pinkb1;
+        n->pinkb2 = pinkb2;
+    }
+}
+
+void    tNoise_setSeed(tNoise* const ns, uint32_t seed)
+{
+    _tNoise* n = *ns;
+    
+    n->rand = NULL;
+    // Spread nearby seeds to far apart points of the sequence
+    n->state = seed * 0x85ebca6bu;
+}
+
+void    tNoise_setRandom(tNoise* const ns, float (*random)(void))
+{
+    _tNoise* n = *ns;
+    
+    n->rand = random;
+}
+
 //=================================================================================
 /* Neuron */
 
@@ -924,6 +1768,27 @@ void tNeuron_setSampleRate (tNeuron* const nr, float sr)
 
 //----------------------------------------------------------------------------------------------------------
 
+// Sub-sample offset of a rising zero crossing in a sync input, computed the same
+// way as in tMBPulse_sync and friends so that the block forms can take a buffer
+static inline float mb_sync_offset(float* const lastsyncin, const float value)
+{
+    float last = *lastsyncin;
+    float delta = value - last;
+    float crossing = -last / delta;
+    *lastsyncin = value;
+    if ((0.f < crossing) && (crossing <= 1.f) && (value >= 0.f))
+        return (1.f - crossing) * delta;
+    return 0.f;
+}
+
+// Round a residual buffer length up to whole cache lines, so that each voice in a
+// bank starts on a line of its own
+static inline int mbbank_stride(int length)
+{
+    int perLine = MPOOL_CACHE_LINE_SIZE / sizeof(float);
+    return (length + perLine - 1) / perLine * perLine;
+}
+
 void tMBPulse_init(tMBPulse* const osc, LEAF* const leaf)
 {
     tMBPulse_initToPool(osc, &leaf->mempool);
@@ -957,54 +1822,23 @@ void tMBPulse_free(tMBPulse* const osc)
     mpool_free((char*)c, c->mempool);
 }
 
-float tMBPulse_tick(tMBPulse* const osc)
+// Advances the phase by one sample and places the steps for any edges crossed
+// on the way, including those around a hard sync reset. Returns the naive
+// waveform, which only changes when an edge is placed.
+static inline float mbpulse_step(float* const f, const int j, const float w, const float b,
+                                const float sync, const int softsync, float* const syncdir,
+                                float* const phase, float x, int* const state)
 {
-    _tMBPulse* c = *osc;
-    
-    int    j, k;
-    float  freq, sync;
-    float  a, b, p, w, x, z, sw;
-    
-    sync = c->sync;
-    freq = c->freq;
-    p = c->_p;  /* phase [0, 1) */
-    w = c->_w;  /* phase increment */
-    b = c->_b;  /* duty cycle (0, 1) */
-    x = c->_x;  /* temporary output variable */
-    z = c->_z;  /* low pass filter state */
-    j = c->_j;  /* index into buffer _f */
-    k = c->_k;  /* output state, 0 = high (0.5f), 1 = low (-0.5f) */
-    //
-    if (c->_init) {
-        p = 0.0f;
-        
-        w = freq * c->invSampleRate;
-        b = 0.5f * (1.0f + c->waveform );
-        
-        /* for variable-width rectangular wave, we could do DC compensation with:
-         *     x = 1.0f - b;
-         * but that doesn't work well with highly modulated hard sync.  Instead,
-         * we keep things in the range [-0.5f, 0.5f]. */
-        x = 0.5f;
-        /* if we valued alias-free startup over low startup time, we could do:
-         *   p -= w;
-         *   place_step_dd(_f, j, 0.0f, w, 0.5f); */
-        k = 0;
-        c->_init = false;
-    }
-    //
-    //    a = 0.2 + 0.8 * vco->_port [FILT];
-    a = 0.5f; // when a = 1, LPfilter is disabled
+    float p = *phase;
+    int k = *state;
+    float sw;
     
-    w = freq * c->invSampleRate;
-    b = 0.5f * (1.0f + c->waveform);
-
-    if (sync > 0.0f && c->softsync > 0) c->syncdir = -c->syncdir;
+    if (sync > 0.0f && softsync > 0) *syncdir = -*syncdir;
     
-    sw = w * c->syncdir;
+    sw = w * *syncdir;
     p += sw - (int)sw;
     
-    if (sync > 0.0f && c->softsync == 0) {  /* sync to master */
+    if (sync > 0.0f && softsync == 0) {  /* sync to master */
         float eof_offset = sync * sw;
         float p_at_reset = p - eof_offset;
     
@@ -1016,13 +1850,13 @@ float tMBPulse_tick(tMBPulse* const osc)
             if (sw > 0)
             {
                 if (p_at_reset >= b) {
-                    place_step_dd(c->_f, j, p_at_reset - b + eof_offset, sw, -1.0f);
+                    place_step_dd(f, j, p_at_reset - b + eof_offset, sw, -1.0f);
                     k = 1;
                     x = -0.5f;
                 }
                 if (p_at_reset >= 1.0f) {
                     p_at_reset -= 1.0f;
-                    place_step_dd(c->_f, j, p_at_reset + eof_offset, sw, 1.0f);
+                    place_step_dd(f, j, p_at_reset + eof_offset, sw, 1.0f);
                     k = 0;
                     x = 0.5f;
                 }
@@ -1031,12 +1865,12 @@ float tMBPulse_tick(tMBPulse* const osc)
             {
                 if (p_at_reset < 0.0f) {
                     p_at_reset += 1.0f;
-                    place_step_dd(c->_f, j, 1.0f - p_at_reset - eof_offset, -sw, -1.0f);
+                    place_step_dd(f, j, 1.0f - p_at_reset - eof_offset, -sw, -1.0f);
                     k = 1;
                     x = -0.5f;
                 }
                 if (k && p_at_reset < b) {
-                    place_step_dd(c->_f, j, b - p_at_reset - eof_offset, -sw, 1.0f);
+                    place_step_dd(f, j, b - p_at_reset - eof_offset, -sw, 1.0f);
                     k = 0;
                     x = 0.5f;
                 }
@@ -1046,12 +1880,12 @@ float tMBPulse_tick(tMBPulse* const osc)
             {
                 if (p_at_reset >= 1.0f) {
                     p_at_reset -= 1.0f;
-                    place_step_dd(c->_f, j, p_at_reset + eof_offset, sw, 1.0f);
+                    place_step_dd(f, j, p_at_reset + eof_offset, sw, 1.0f);
                     k = 0;
                     x = 0.5f;
                 }
                 if (!k && p_at_reset >= b) {
-                    place_step_dd(c->_f, j, p_at_reset - b + eof_offset, sw, -1.0f);
+                    place_step_dd(f, j, p_at_reset - b + eof_offset, sw, -1.0f);
                     k = 1;
                     x = -0.5f;
                 }
@@ -1059,13 +1893,13 @@ float tMBPulse_tick(tMBPulse* const osc)
             else if (sw < 0)
             {
                 if (p_at_reset < b) {
-                    place_step_dd(c->_f, j, b - p_at_reset - eof_offset, -sw, 1.0f);
+                    place_step_dd(f, j, b - p_at_reset - eof_offset, -sw, 1.0f);
                     k = 0;
                     x = 0.5f;
                 }
                 if (p_at_reset < 0.0f) {
                     p_at_reset += 1.0f;
-                    place_step_dd(c->_f, j, 1.0f - p_at_reset - eof_offset, -sw, -1.0f);
+                    place_step_dd(f, j, 1.0f - p_at_reset - eof_offset, -sw, -1.0f);
                     k = 1;
                     x = -0.5f;
                 }
@@ -1076,12 +1910,12 @@ float tMBPulse_tick(tMBPulse* const osc)
         if (sw > 0)
         {
             if (k) {
-                place_step_dd(c->_f, j, p, sw, 1.0f);
+                place_step_dd(f, j, p, sw, 1.0f);
                 k = 0;
                 x = 0.5f;
             }
             if (p >= b) {
-                place_step_dd(c->_f, j, p - b, sw, -1.0f);
+                place_step_dd(f, j, p - b, sw, -1.0f);
                 k = 1;
                 x = -0.5f;
             }
@@ -1089,12 +1923,12 @@ float tMBPulse_tick(tMBPulse* const osc)
         else if (sw < 0)
         {
             if (!k) {
-                place_step_dd(c->_f, j, 1.0f - p, -sw, -1.0f);
+                place_step_dd(f, j, 1.0f - p, -sw, -1.0f);
                 k = 1;
                 x = -0.5f;
             }
             if (p < b) {
-                place_step_dd(c->_f, j, b - p, -sw, 1.0f);
+                place_step_dd(f, j, b - p, -sw, 1.0f);
                 k = 0;
                 x = 0.5f;
             }
@@ -1104,13 +1938,13 @@ float tMBPulse_tick(tMBPulse* const osc)
         if (sw > 0)
         {
             if (p >= b) {
-                place_step_dd(c->_f, j, p - b, sw, -1.0f);
+                place_step_dd(f, j, p - b, sw, -1.0f);
                 k = 1;
                 x = -0.5f;
             }
             if (p >= 1.0f) {
                 p -= 1.0f;
-                place_step_dd(c->_f, j, p, sw, 1.0f);
+                place_step_dd(f, j, p, sw, 1.0f);
                 k = 0;
                 x = 0.5f;
             }
@@ -1119,12 +1953,12 @@ float tMBPulse_tick(tMBPulse* const osc)
         {
             if (p < 0.0f) {
                 p += 1.0f;
-                place_step_dd(c->_f, j, 1.0f - p, -sw, -1.0f);
+                place_step_dd(f, j, 1.0f - p, -sw, -1.0f);
                 k = 1;
                 x = -0.5f;
             }
             if (k && p < b) {
-                place_step_dd(c->_f, j, b - p, -sw, 1.0f);
+                place_step_dd(f, j, b - p, -sw, 1.0f);
                 k = 0;
                 x = 0.5f;
             }
@@ -1136,12 +1970,12 @@ float tMBPulse_tick(tMBPulse* const osc)
         {
             if (p >= 1.0f) {
                 p -= 1.0f;
-                place_step_dd(c->_f, j, p, sw, 1.0f);
+                place_step_dd(f, j, p, sw, 1.0f);
                 k = 0;
                 x = 0.5f;
             }
             if (!k && p >= b) {
-                place_step_dd(c->_f, j, p - b, sw, -1.0f);
+                place_step_dd(f, j, p - b, sw, -1.0f);
                 k = 1;
                 x = -0.5f;
             }
@@ -1149,48 +1983,175 @@ float tMBPulse_tick(tMBPulse* const osc)
         else if (sw < 0)
         {
             if (p < b) {
-                place_step_dd(c->_f, j, b - p, -sw, 1.0f);
+                place_step_dd(f, j, b - p, -sw, 1.0f);
                 k = 0;
                 x = 0.5f;
             }
             if (p < 0.0f) {
                 p += 1.0f;
-                place_step_dd(c->_f, j, 1.0f - p, -sw, -1.0f);
+                place_step_dd(f, j, 1.0f - p, -sw, -1.0f);
                 k = 1;
                 x = -0.5f;
             }
         }
     }
-    c->_f[j + DD_SAMPLE_DELAY] += x;
-    
-    z += a * (c->_f[j] - z);
-    c->out = c->amp * z;
-    
-    if (++j == FILLEN)
-    {
-        j = 0;
-        memcpy (c->_f, c->_f + FILLEN, STEP_DD_PULSE_LENGTH * sizeof (float));
-        memset (c->_f + STEP_DD_PULSE_LENGTH, 0,  FILLEN * sizeof (float));
-    }
-    
-    c->_p = p;
-    c->_w = w;
-    c->_b = b;
-    c->_x = x;
-    c->_z = z;
-    c->_j = j;
-    c->_k = k;
     
-    return -c->out;
+    *phase = p;
+    *state = k;
+    return x;
 }
 
-void tMBPulse_setFreq(tMBPulse* const osc, float f)
-{
-    _tMBPulse* c = *osc;
-    c->freq = f;
-}
-
-void tMBPulse_setWidth(tMBPulse* const osc, float w)
+float tMBPulse_tick(tMBPulse* const osc)
+{
+    _tMBPulse* c = *osc;
+    
+    int    j, k;
+    float  freq, sync;
+    float  a, b, p, w, x, z;
+    
+    sync = c->sync;
+    freq = c->freq;
+    p = c->_p;  /* phase [0, 1) */
+    w = c->_w;  /* phase increment */
+    b = c->_b;  /* duty cycle (0, 1) */
+    x = c->_x;  /* temporary output variable */
+    z = c->_z;  /* low pass filter state */
+    j = c->_j;  /* index into buffer _f */
+    k = c->_k;  /* output state, 0 = high (0.5f), 1 = low (-0.5f) */
+    //
+    if (c->_init) {
+        p = 0.0f;
+        
+        w = freq * c->invSampleRate;
+        b = 0.5f * (1.0f + c->waveform );
+        
+        /* for variable-width rectangular wave, we could do DC compensation with:
+         *     x = 1.0f - b;
+         * but that doesn't work well with highly modulated hard sync.  Instead,
+         * we keep things in the range [-0.5f, 0.5f]. */
+        x = 0.5f;
+        /* if we valued alias-free startup over low startup time, we could do:
+         *   p -= w;
+         *   place_step_dd(_f, j, 0.0f, w, 0.5f); */
+        k = 0;
+        c->_init = false;
+    }
+    //
+    //    a = 0.2 + 0.8 * vco->_port [FILT];
+    a = 0.5f; // when a = 1, LPfilter is disabled
+    
+    w = freq * c->invSampleRate;
+    b = 0.5f * (1.0f + c->waveform);
+
+    x = mbpulse_step(c->_f, j, w, b, sync, c->softsync, &c->syncdir, &p, x, &k);
+    c->_f[j + DD_SAMPLE_DELAY] += x;
+    
+    z += a * (c->_f[j] - z);
+    c->out = c->amp * z;
+    
+    if (++j == FILLEN)
+    {
+        j = 0;
+        memcpy (c->_f, c->_f + FILLEN, STEP_DD_PULSE_LENGTH * sizeof (float));
+        memset (c->_f + STEP_DD_PULSE_LENGTH, 0,  FILLEN * sizeof (float));
+    }
+    
+    c->_p = p;
+    c->_w = w;
+    c->_b = b;
+    c->_x = x;
+    c->_z = z;
+    c->_j = j;
+    c->_k = k;
+    
+    return -c->out;
+}
+
+// The block is rendered in two passes per buffer segment: the first places the
+// naive waveform and its steps, the second runs the lowpass over the result.
+// Steps only ever reach forward from the sample that placed them, so the second
+// pass reads exactly what tMBPulse_tick would have read.
+void tMBPulse_tickBlock(tMBPulse* const osc, float* const out, const float* const freq, const float* const sync, int size)
+{
+    _tMBPulse* c = *osc;
+    
+    int    i, n, j, k, end;
+    float  a, amp, b, p, w, x, z, syncin, lastsyncin, syncdir, invSampleRate;
+    int    softsync;
+    float* f = c->_f;
+    
+    p = c->_p;
+    x = c->_x;
+    z = c->_z;
+    j = c->_j;
+    k = c->_k;
+    if (c->_init) {
+        p = 0.0f;
+        x = 0.5f;
+        k = 0;
+        c->_init = false;
+    }
+    
+    a = 0.5f;
+    amp = c->amp;
+    invSampleRate = c->invSampleRate;
+    w = c->freq * invSampleRate;
+    b = 0.5f * (1.0f + c->waveform);
+    syncin = c->sync;
+    lastsyncin = c->lastsyncin;
+    syncdir = c->syncdir;
+    softsync = c->softsync;
+    
+    for (i = 0; i < size; i = end)
+    {
+        // Stop at the end of the buffer so that it can be shifted as in tMBPulse_tick
+        end = i + FILLEN - j;
+        if (end > size) end = size;
+        
+        for (n = i; n < end; ++n)
+        {
+            int jn = j + n - i;
+            if (sync != NULL) syncin = mb_sync_offset(&lastsyncin, sync[n]);
+            if (freq != NULL) w = freq[n] * invSampleRate;
+            x = mbpulse_step(f, jn, w, b, syncin, softsync, &syncdir, &p, x, &k);
+            f[jn + DD_SAMPLE_DELAY] += x;
+        }
+        
+        for (n = i; n < end; ++n)
+        {
+            z += a * (f[j + n - i] - z);
+            out[n] = -(amp * z);
+        }
+        
+        j += end - i;
+        if (j == FILLEN)
+        {
+            j = 0;
+            memcpy (f, f + FILLEN, STEP_DD_PULSE_LENGTH * sizeof (float));
+            memset (f + STEP_DD_PULSE_LENGTH, 0,  FILLEN * sizeof (float));
+        }
+    }
+    
+    c->out = amp * z;
+    c->sync = syncin;
+    c->lastsyncin = lastsyncin;
+    c->syncdir = syncdir;
+    c->_p = p;
+    c->_w = w;
+    c->_b = b;
+    c->_x = x;
+    c->_z = z;
+    c->_j = j;
+    c->_k = k;
+}
+
+void tMBPulse_setFreq(tMBPulse* const osc, float f)
+{
+    _tMBPulse* c = *osc;
+    c->freq = f;
+}
+
+void tMBPulse_setWidth(tMBPulse* const osc, float w)
 {
     _tMBPulse* c = *osc;
     c->waveform = w;
@@ -1265,51 +2226,23 @@ void tMBTriangle_free(tMBTriangle* const osc)
     mpool_free((char*)c, c->mempool);
 }
 
-float tMBTriangle_tick(tMBTriangle* const osc)
+// Advances the phase by one sample and places the slope changes (and the step
+// for a hard sync reset), returning the naive waveform.
+static inline float mbtriangle_step(float* const f, const int j, const float w, const float b,
+                                   const float sync, const int softsync, float* const syncdir,
+                                   float* const phase, int* const state)
 {
-    _tMBTriangle* c = *osc;
-    
-    int    j, k, dir;
-    float  freq, sync;
-    float  a, b, b1, p, w, sw, x, z;
-    
-    sync = c->sync;
-    dir = c->syncdir;
-    freq = c->freq;
-    p = c->_p;  /* phase [0, 1) */
-    w = c->_w;  /* phase increment */
-    b = c->_b;  /* duty cycle (0, 1) */
-    z = c->_z;  /* low pass filter state */
-    j = c->_j;  /* index into buffer _f */
-    k = c->_k;  /* output state, 0 = positive slope, 1 = negative slope */
-    
-    if (c->_init) {
-        //        w = (exp2ap (freq[1] + vco->_port[OCTN] + vco->_port[TUNE] + expm[1] * vco->_port[EXPG] + 8.03136)
-        //                + 1e3 * linm[1] * vco->_port[LING]) / SAMPLERATE;
-        w = freq * c->invSampleRate;
-        b = 0.5f * (1.0f + c->waveform);
-//        p = 0.5f * b;
-        p = 0.f;
-        /* if we valued alias-free startup over low startup time, we could do:
-         *   p -= w;
-         *   place_slope_dd(_f, j, 0.0f, w, 1.0f / b); */
-        k = 0;
-        c->_init = false;
-    }
-    
-    //    a = 0.2 + 0.8 * vco->_port [FILT];
-    a = 0.5f; // when a = 1, LPfilter is disabled
+    float p = *phase;
+    int k = *state;
+    float b1 = 1.0f - b;
+    float sw, x;
     
-    w = freq * c->invSampleRate;
-    b = 0.5f * (1.0f + c->waveform);
-    b1 = 1.0f - b;
+    if (sync > 0.0f && softsync > 0) *syncdir = -*syncdir;
     
-    if (sync > 0.0f && c->softsync > 0) c->syncdir = -c->syncdir;
-    
-    sw = w * c->syncdir;
+    sw = w * *syncdir;
     p += sw - (int)sw;
     
-    if (sync > 0.0f && c->softsync == 0) {  /* sync to master */
+    if (sync > 0.0f && softsync == 0) {  /* sync to master */
         float eof_offset = sync * sw;
         float p_at_reset = p - eof_offset;
         
@@ -1324,13 +2257,13 @@ float tMBTriangle_tick(tMBTriangle* const osc)
             {
                 if (p_at_reset >= b) {
                     x = 0.5f - (p_at_reset - b) / b1;
-                    place_slope_dd(c->_f, j, p_at_reset - b + eof_offset, sw, -1.0f / b1 - 1.0f / b);
+                    place_slope_dd(f, j, p_at_reset - b + eof_offset, sw, -1.0f / b1 - 1.0f / b);
                     k = 1;
                 }
                 if (p_at_reset >= 1.0f) {
                     p_at_reset -= 1.0f;
                     x = -0.5f + p_at_reset / b;
-                    place_slope_dd(c->_f, j, p_at_reset + eof_offset, sw, 1.0f / b + 1.0f / b1);
+                    place_slope_dd(f, j, p_at_reset + eof_offset, sw, 1.0f / b + 1.0f / b1);
                     k = 0;
                 }
             }
@@ -1339,12 +2272,12 @@ float tMBTriangle_tick(tMBTriangle* const osc)
                 if (p_at_reset < 0.0f) {
                     p_at_reset += 1.0f;
                     x = 0.5f - (p_at_reset - b) / b1;
-                    place_slope_dd(c->_f, j, 1.0f - p_at_reset - eof_offset, -sw, 1.0f / b + 1.0f / b1);
+                    place_slope_dd(f, j, 1.0f - p_at_reset - eof_offset, -sw, 1.0f / b + 1.0f / b1);
                     k = 1;
                 }
                 if (k && p_at_reset < b) {
                     x = -0.5f + p_at_reset / b;
-                    place_slope_dd(c->_f, j, b - p_at_reset - eof_offset, -sw, -1.0f / b1 - 1.0f / b);
+                    place_slope_dd(f, j, b - p_at_reset - eof_offset, -sw, -1.0f / b1 - 1.0f / b);
                     k = 0;
                 }
             }
@@ -1355,12 +2288,12 @@ float tMBTriangle_tick(tMBTriangle* const osc)
                 if (p_at_reset >= 1.0f) {
                     p_at_reset -= 1.0f;
                     x = -0.5f + p_at_reset / b;
-                    place_slope_dd(c->_f, j, p_at_reset + eof_offset, sw, 1.0f / b + 1.0f / b1);
+                    place_slope_dd(f, j, p_at_reset + eof_offset, sw, 1.0f / b + 1.0f / b1);
                     k = 0;
                 }
                 if (!k && p_at_reset >= b) {
                     x = 0.5f - (p_at_reset - b) / b1;
-                    place_slope_dd(c->_f, j, p_at_reset - b + eof_offset, sw, -1.0f / b1 - 1.0f / b);
+                    place_slope_dd(f, j, p_at_reset - b + eof_offset, sw, -1.0f / b1 - 1.0f / b);
                     k = 1;
                 }
             }
@@ -1368,13 +2301,13 @@ float tMBTriangle_tick(tMBTriangle* const osc)
             {
                 if (p_at_reset < b) {
                     x = -0.5f + p_at_reset / b;
-                    place_slope_dd(c->_f, j, b - p_at_reset - eof_offset, -sw, -1.0f / b1 - 1.0f / b);
+                    place_slope_dd(f, j, b - p_at_reset - eof_offset, -sw, -1.0f / b1 - 1.0f / b);
                     k = 0;
                 }
                 if (p_at_reset < 0.0f) {
                     p_at_reset += 1.0f;
                     x = 0.5f - (p_at_reset - b) / b1;
-                    place_slope_dd(c->_f, j, 1.0f - p_at_reset - eof_offset, -sw, 1.0f / b + 1.0f / b1);
+                    place_slope_dd(f, j, 1.0f - p_at_reset - eof_offset, -sw, 1.0f / b + 1.0f / b1);
                     k = 1;
                 }
             }
@@ -1384,26 +2317,26 @@ float tMBTriangle_tick(tMBTriangle* const osc)
         if (sw > 0)
         {
             if (k)
-                place_slope_dd(c->_f, j, p, sw, 1.0f / b + 1.0f / b1);
-            place_step_dd(c->_f, j, p, sw, -0.5f - x);
+                place_slope_dd(f, j, p, sw, 1.0f / b + 1.0f / b1);
+            place_step_dd(f, j, p, sw, -0.5f - x);
             x = -0.5f + p / b;
             k = 0;
             if (p >= b) {
                 x = 0.5f - (p - b) / b1;
-                place_slope_dd(c->_f, j, p - b, sw, -1.0f / b1 - 1.0f / b);
+                place_slope_dd(f, j, p - b, sw, -1.0f / b1 - 1.0f / b);
                 k = 1;
             }
         }
         else if (sw < 0)
         {
             if (!k)
-                place_slope_dd(c->_f, j, 1.0f - p, -sw, 1.0f / b + 1.0f / b1);
-            place_step_dd(c->_f, j, 1.0f - p, -sw, -0.5f - x);
+                place_slope_dd(f, j, 1.0f - p, -sw, 1.0f / b + 1.0f / b1);
+            place_step_dd(f, j, 1.0f - p, -sw, -0.5f - x);
             x = 0.5f - (p - b) / b1;
             k = 1;
             if (p < b) {
                 x = -0.5f + p / b;
-                place_slope_dd(c->_f, j, b - p, -sw, -1.0f / b1 - 1.0f / b);
+                place_slope_dd(f, j, b - p, -sw, -1.0f / b1 - 1.0f / b);
                 k = 0;
             }
         }
@@ -1414,13 +2347,13 @@ float tMBTriangle_tick(tMBTriangle* const osc)
         {
             if (p >= b) {
                 x = 0.5f - (p - b) / b1;
-                place_slope_dd(c->_f, j, p - b, sw, -1.0f / b1 - 1.0f / b);
+                place_slope_dd(f, j, p - b, sw, -1.0f / b1 - 1.0f / b);
                 k = 1;
             }
             if (p >= 1.0f) {
                 p -= 1.0f;
                 x = -0.5f + p / b;
-                place_slope_dd(c->_f, j, p, sw, 1.0f / b + 1.0f / b1);
+                place_slope_dd(f, j, p, sw, 1.0f / b + 1.0f / b1);
                 k = 0;
             }
         }
@@ -1429,12 +2362,12 @@ float tMBTriangle_tick(tMBTriangle* const osc)
             if (p < 0.0f) {
                 p += 1.0f;
                 x = 0.5f - (p - b) / b1;
-                place_slope_dd(c->_f, j, 1.0f - p, -sw, 1.0f / b + 1.0f / b1);
+                place_slope_dd(f, j, 1.0f - p, -sw, 1.0f / b + 1.0f / b1);
                 k = 1;
             }
             if (k && p < b) {
                 x = -0.5f + p / b;
-                place_slope_dd(c->_f, j, b - p, -sw, -1.0f / b1 - 1.0f / b);
+                place_slope_dd(f, j, b - p, -sw, -1.0f / b1 - 1.0f / b);
                 k = 0;
             }
         }
@@ -1447,12 +2380,12 @@ float tMBTriangle_tick(tMBTriangle* const osc)
             if (p >= 1.0f) {
                 p -= 1.0f;
                 x = -0.5f + p / b;
-                place_slope_dd(c->_f, j, p, sw, 1.0f / b + 1.0f / b1);
+                place_slope_dd(f, j, p, sw, 1.0f / b + 1.0f / b1);
                 k = 0;
             }
             if (!k && p >= b) {
                 x = 0.5f - (p - b) / b1;
-                place_slope_dd(c->_f, j, p - b, sw, -1.0f / b1 - 1.0f / b);
+                place_slope_dd(f, j, p - b, sw, -1.0f / b1 - 1.0f / b);
                 k = 1;
             }
         }
@@ -1460,17 +2393,62 @@ float tMBTriangle_tick(tMBTriangle* const osc)
         {
             if (p < b) {
                 x = -0.5f + p / b;
-                place_slope_dd(c->_f, j, b - p, -sw, -1.0f / b1 - 1.0f / b);
+                place_slope_dd(f, j, b - p, -sw, -1.0f / b1 - 1.0f / b);
                 k = 0;
             }
             if (p < 0.0f) {
                 p += 1.0f;
                 x = 0.5f - (p - b) / b1;
-                place_slope_dd(c->_f, j, 1.0f - p, -sw, 1.0f / b + 1.0f / b1);
+                place_slope_dd(f, j, 1.0f - p, -sw, 1.0f / b + 1.0f / b1);
                 k = 1;
             }
         }
     }
+    
+    *phase = p;
+    *state = k;
+    return x;
+}
+
+float tMBTriangle_tick(tMBTriangle* const osc)
+{
+    _tMBTriangle* c = *osc;
+    
+    int    j, k, dir;
+    float  freq, sync;
+    float  a, b, p, w, x, z;
+    
+    sync = c->sync;
+    dir = c->syncdir;
+    freq = c->freq;
+    p = c->_p;  /* phase [0, 1) */
+    w = c->_w;  /* phase increment */
+    b = c->_b;  /* duty cycle (0, 1) */
+    z = c->_z;  /* low pass filter state */
+    j = c->_j;  /* index into buffer _f */
+    k = c->_k;  /* output state, 0 = positive slope, 1 = negative slope */
+    
+    if (c->_init) {
+        //        w = (exp2ap (freq[1] + vco->_port[OCTN] + vco->_port[TUNE] + expm[1] * vco->_port[EXPG] + 8.03136)
+        //                + 1e3 * linm[1] * vco->_port[LING]) / SAMPLERATE;
+        w = freq * c->invSampleRate;
+        b = 0.5f * (1.0f + c->waveform);
+//        p = 0.5f * b;
+        p = 0.f;
+        /* if we valued alias-free startup over low startup time, we could do:
+         *   p -= w;
+         *   place_slope_dd(_f, j, 0.0f, w, 1.0f / b); */
+        k = 0;
+        c->_init = false;
+    }
+    
+    //    a = 0.2 + 0.8 * vco->_port [FILT];
+    a = 0.5f; // when a = 1, LPfilter is disabled
+    
+    w = freq * c->invSampleRate;
+    b = 0.5f * (1.0f + c->waveform);
+    
+    x = mbtriangle_step(c->_f, j, w, b, sync, c->softsync, &c->syncdir, &p, &k);
     c->_f[j + DD_SAMPLE_DELAY] += x;
     
     z += a * (c->_f[j] - z);
@@ -1493,6 +2471,78 @@ float tMBTriangle_tick(tMBTriangle* const osc)
     return -c->out;
 }
 
+// Same two passes as tMBPulse_tickBlock
+void tMBTriangle_tickBlock(tMBTriangle* const osc, float* const out, const float* const freq, const float* const sync, int size)
+{
+    _tMBTriangle* c = *osc;
+    
+    int    i, n, j, k, end;
+    float  a, amp, b, p, w, x, z, syncin, lastsyncin, syncdir, invSampleRate;
+    int    softsync;
+    float* f = c->_f;
+    
+    p = c->_p;
+    z = c->_z;
+    j = c->_j;
+    k = c->_k;
+    if (c->_init) {
+        p = 0.0f;
+        k = 0;
+        c->_init = false;
+    }
+    
+    a = 0.5f;
+    amp = c->amp;
+    invSampleRate = c->invSampleRate;
+    w = c->freq * invSampleRate;
+    b = 0.5f * (1.0f + c->waveform);
+    syncin = c->sync;
+    lastsyncin = c->lastsyncin;
+    syncdir = c->syncdir;
+    softsync = c->softsync;
+    
+    for (i = 0; i < size; i = end)
+    {
+        // Stop at the end of the buffer so that it can be shifted as in tMBTriangle_tick
+        end = i + FILLEN - j;
+        if (end > size) end = size;
+        
+        for (n = i; n < end; ++n)
+        {
+            int jn = j + n - i;
+            if (sync != NULL) syncin = mb_sync_offset(&lastsyncin, sync[n]);
+            if (freq != NULL) w = freq[n] * invSampleRate;
+            x = mbtriangle_step(f, jn, w, b, syncin, softsync, &syncdir, &p, &k);
+            f[jn + DD_SAMPLE_DELAY] += x;
+        }
+        
+        for (n = i; n < end; ++n)
+        {
+            z += a * (f[j + n - i] - z);
+            out[n] = -(amp * z);
+        }
+        
+        j += end - i;
+        if (j == FILLEN)
+        {
+            j = 0;
+            memcpy (f, f + FILLEN, STEP_DD_PULSE_LENGTH * sizeof (float));
+            memset (f + STEP_DD_PULSE_LENGTH, 0,  FILLEN * sizeof (float));
+        }
+    }
+    
+    c->out = amp * z;
+    c->sync = syncin;
+    c->lastsyncin = lastsyncin;
+    c->syncdir = syncdir;
+    c->_p = p;
+    c->_w = w;
+    c->_b = b;
+    c->_z = z;
+    c->_j = j;
+    c->_k = k;
+}
+
 void tMBTriangle_setFreq(tMBTriangle* const osc, float f)
 {
     _tMBTriangle* c = *osc;
@@ -1573,55 +2623,32 @@ void tMBSaw_free(tMBSaw* const osc)
     mpool_free((char*)c, c->mempool);
 }
 
-float tMBSaw_tick(tMBSaw* const osc)
+// Advances the phase by one sample and places the steps for a wrap or a hard
+// sync reset, returning the naive waveform. Shared by tMBSaw_tick and the block
+// and bank forms so that all of them follow the same sync paths.
+static inline float mbsaw_step(float* const f, const int j, const float w, const float sync,
+                              const int softsync, float* const syncdir, float* const phase)
 {
-    _tMBSaw* c = *osc;
-    
-    int    j;
-    float  freq, sync;
-    float  a, p, w, sw, z;
-    
-    sync = c->sync;
-    freq = c->freq;
-    
-    p = c->_p;  /* phase [0, 1) */
-    w = c->_w;  /* phase increment */
-    z = c->_z;  /* low pass filter state */
-    j = c->_j;  /* index into buffer _f */
+    float p = *phase;
+    float sw;
     
-    if (c->_init) {
-//        p = 0.5f;
-        p = 0.f;
-        w = freq * c->invSampleRate;
-        
-        /* if we valued alias-free startup over low startup time, we could do:
-         *   p -= w;
-         *   place_slope_dd(_f, j, 0.0f, w, -1.0f); */
-        c->_init = false;
-    }
-    
-    //a = 0.2 + 0.8 * vco->_port [FILT];
-    a = 0.5f; // when a = 1, LPfilter is disabled
-    
-    w = freq * c->invSampleRate;
-
-    if (sync > 0.0f && c->softsync > 0) c->syncdir = -c->syncdir;
+    if (sync > 0.0f && softsync > 0) *syncdir = -*syncdir;
     // Should insert minblep for softsync?
     //            if (p_at_reset >= 1.0f) {
     //                p_at_reset -= (int)p_at_reset;
-    //                place_slope_dd(c->_f, j, p_at_reset + eof_offset, sw, 2.0f);
+    //                place_slope_dd(f, j, p_at_reset + eof_offset, sw, 2.0f);
     //            }
     //            if (p_at_reset < 0.0f) {
     //                p_at_reset += 1.0f - (int)p_at_reset;
-    //                place_slope_dd(c->_f, j, 1.0f - p_at_reset - eof_offset, -sw, -2.0f);
+    //                place_slope_dd(f, j, 1.0f - p_at_reset - eof_offset, -sw, -2.0f);
     //            }
-    //            if (sw > 0) place_slope_dd(c->_f, j, p, sw, 2.0f);
-    //            else if (sw < 0) place_slope_dd(c->_f, j, 1.0f - p, -sw, -2.0f);
+    //            if (sw > 0) place_slope_dd(f, j, p, sw, 2.0f);
+    //            else if (sw < 0) place_slope_dd(f, j, 1.0f - p, -sw, -2.0f);
     
-    sw = w * c->syncdir;
+    sw = w * *syncdir;
     p += sw - (int)sw;
     
-    if (sync > 0.0f && c->softsync == 0) {  /* sync to master */
+    if (sync > 0.0f && softsync == 0) {  /* sync to master */
         float eof_offset = sync * sw;
         float p_at_reset = p - eof_offset;
 
@@ -1631,45 +2658,150 @@ float tMBSaw_tick(tMBSaw* const osc)
         /* place any DD that may have occurred in subsample before reset */
         if (p_at_reset >= 1.0f) {
             p_at_reset -= 1.0f;
-            place_step_dd(c->_f, j, p_at_reset + eof_offset, sw, 1.0f);
+            place_step_dd(f, j, p_at_reset + eof_offset, sw, 1.0f);
         }
         if (p_at_reset < 0.0f) {
             p_at_reset += 1.0f;
-            place_step_dd(c->_f, j, 1.0f - p_at_reset - eof_offset, -sw, -1.0f);
+            place_step_dd(f, j, 1.0f - p_at_reset - eof_offset, -sw, -1.0f);
         }
         
         /* now place reset DD */
         if (sw > 0)
-            place_step_dd(c->_f, j, p, sw, p_at_reset);
+            place_step_dd(f, j, p, sw, p_at_reset);
         else if (sw < 0)
-            place_step_dd(c->_f, j, 1.0f - p, -sw, -p_at_reset);
+            place_step_dd(f, j, 1.0f - p, -sw, -p_at_reset);
 
     } else if (p >= 1.0f) {  /* normal phase reset */
         p -= 1.0f;
-        place_step_dd(c->_f, j, p, sw, 1.0f);
+        place_step_dd(f, j, p, sw, 1.0f);
         
     } else if (p < 0.0f) {
         p += 1.0f;
-        place_step_dd(c->_f, j, 1.0f - p, -sw, -1.0f);
+        place_step_dd(f, j, 1.0f - p, -sw, -1.0f);
     }
-    c->_f[j + DD_SAMPLE_DELAY] += 0.5f - p;
     
-    z += a * (c->_f[j] - z); // LP filtering
-    c->out = c->amp * z;
-    
-    if (++j == FILLEN)
-    {
-        j = 0;
-        memcpy (c->_f, c->_f + FILLEN, STEP_DD_PULSE_LENGTH * sizeof (float));
-        memset (c->_f + STEP_DD_PULSE_LENGTH, 0,  FILLEN * sizeof (float));
-    }
-    
-    c->_p = p;
-    c->_w = w;
-    c->_z = z;
-    c->_j = j;
-    
-    return -c->out;
+    *phase = p;
+    return 0.5f - p;
+}
+
+float tMBSaw_tick(tMBSaw* const osc)
+{
+    _tMBSaw* c = *osc;
+    
+    int    j;
+    float  freq, sync;
+    float  a, p, w, x, z;
+    
+    sync = c->sync;
+    freq = c->freq;
+    
+    p = c->_p;  /* phase [0, 1) */
+    w = c->_w;  /* phase increment */
+    z = c->_z;  /* low pass filter state */
+    j = c->_j;  /* index into buffer _f */
+    
+    if (c->_init) {
+//        p = 0.5f;
+        p = 0.f;
+        w = freq * c->invSampleRate;
+        
+        /* if we valued alias-free startup over low startup time, we could do:
+         *   p -= w;
+         *   place_slope_dd(_f, j, 0.0f, w, -1.0f); */
+        c->_init = false;
+    }
+    
+    //a = 0.2 + 0.8 * vco->_port [FILT];
+    a = 0.5f; // when a = 1, LPfilter is disabled
+    
+    w = freq * c->invSampleRate;
+
+    x = mbsaw_step(c->_f, j, w, sync, c->softsync, &c->syncdir, &p);
+    c->_f[j + DD_SAMPLE_DELAY] += x;
+    
+    z += a * (c->_f[j] - z); // LP filtering
+    c->out = c->amp * z;
+    
+    if (++j == FILLEN)
+    {
+        j = 0;
+        memcpy (c->_f, c->_f + FILLEN, STEP_DD_PULSE_LENGTH * sizeof (float));
+        memset (c->_f + STEP_DD_PULSE_LENGTH, 0,  FILLEN * sizeof (float));
+    }
+    
+    c->_p = p;
+    c->_w = w;
+    c->_z = z;
+    c->_j = j;
+    
+    return -c->out;
+}
+
+// Same two passes as tMBPulse_tickBlock
+void tMBSaw_tickBlock(tMBSaw* const osc, float* const out, const float* const freq, const float* const sync, int size)
+{
+    _tMBSaw* c = *osc;
+    
+    int    i, n, j, end;
+    float  a, amp, p, w, x, z, syncin, lastsyncin, syncdir, invSampleRate;
+    int    softsync;
+    float* f = c->_f;
+    
+    p = c->_p;
+    z = c->_z;
+    j = c->_j;
+    if (c->_init) {
+        p = 0.0f;
+        c->_init = false;
+    }
+    
+    a = 0.5f;
+    amp = c->amp;
+    invSampleRate = c->invSampleRate;
+    w = c->freq * invSampleRate;
+    syncin = c->sync;
+    lastsyncin = c->lastsyncin;
+    syncdir = c->syncdir;
+    softsync = c->softsync;
+    
+    for (i = 0; i < size; i = end)
+    {
+        // Stop at the end of the buffer so that it can be shifted as in tMBSaw_tick
+        end = i + FILLEN - j;
+        if (end > size) end = size;
+        
+        for (n = i; n < end; ++n)
+        {
+            int jn = j + n - i;
+            if (sync != NULL) syncin = mb_sync_offset(&lastsyncin, sync[n]);
+            if (freq != NULL) w = freq[n] * invSampleRate;
+            x = mbsaw_step(f, jn, w, syncin, softsync, &syncdir, &p);
+            f[jn + DD_SAMPLE_DELAY] += x;
+        }
+        
+        for (n = i; n < end; ++n)
+        {
+            z += a * (f[j + n - i] - z);
+            out[n] = -(amp * z);
+        }
+        
+        j += end - i;
+        if (j == FILLEN)
+        {
+            j = 0;
+            memcpy (f, f + FILLEN, STEP_DD_PULSE_LENGTH * sizeof (float));
+            memset (f + STEP_DD_PULSE_LENGTH, 0,  FILLEN * sizeof (float));
+        }
+    }
+    
+    c->out = amp * z;
+    c->sync = syncin;
+    c->lastsyncin = lastsyncin;
+    c->syncdir = syncdir;
+    c->_p = p;
+    c->_w = w;
+    c->_z = z;
+    c->_j = j;
 }
 
 void tMBSaw_setFreq(tMBSaw* const osc, float f)
@@ -1712,6 +2844,344 @@ void tMBSaw_setSampleRate(tMBSaw* const osc, float sr)
     c->invSampleRate = 1.0f/sr;
 }
 
+//==========================================================================================================
+//==========================================================================================================
+
+void tMBSawBank_init(tMBSawBank* const bank, int numVoices, LEAF* const leaf)
+{
+    tMBSawBank_initToPool(bank, numVoices, &leaf->mempool);
+}
+
+void tMBSawBank_initToPool(tMBSawBank* const bank, int numVoices, tMempool* const pool)
+{
+    _tMempool* m = *pool;
+    _tMBSawBank* c = *bank = (_tMBSawBank*) mpool_alloc(sizeof(_tMBSawBank), m);
+    c->mempool = m;
+    LEAF* leaf = c->mempool->leaf;
+    
+    c->numVoices = numVoices;
+    c->freq = (float*) mpool_alloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->gain = (float*) mpool_alloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->phase = (float*) mpool_calloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->z = (float*) mpool_calloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->stride = mbbank_stride(FILLEN + STEP_DD_PULSE_LENGTH);
+    c->buffer = (float*) mpool_calloc_aligned(sizeof(float) * c->stride * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    for (int v = 0; v < numVoices; ++v)
+    {
+        c->freq[v] = 440.f;
+        c->gain[v] = 1.0f;
+    }
+    c->j = 0;
+    c->lastsyncin = 0.0f;
+    c->syncdir = 1.0f;
+    c->softsync = 0;
+    c->invSampleRate = leaf->invSampleRate;
+}
+
+void tMBSawBank_free(tMBSawBank* const bank)
+{
+    _tMBSawBank* c = *bank;
+    
+    mpool_free((char*)c->buffer, c->mempool);
+    mpool_free((char*)c->z, c->mempool);
+    mpool_free((char*)c->phase, c->mempool);
+    mpool_free((char*)c->gain, c->mempool);
+    mpool_free((char*)c->freq, c->mempool);
+    mpool_free((char*)c, c->mempool);
+}
+
+// Renders samples start to end of one voice, in the same two passes as
+// tMBSaw_tickBlock. All voices see the same sync input and start from the same
+// sync direction, so each one flips it the same way.
+static inline void mbsawbank_voice(_tMBSawBank* c, int v, float* const out, const float* const sync,
+                                   int start, int end, int accumulate, float* const syncdir)
+{
+    float* f = c->buffer + v * c->stride;
+    int j = c->j;
+    int softsync = c->softsync;
+    float a = 0.5f;
+    float w = c->freq[v] * c->invSampleRate;
+    float gain = c->gain[v];
+    float p = c->phase[v];
+    float z = c->z[v];
+    float syncin = 0.0f;
+    float lastsyncin = (sync != NULL && start > 0) ? sync[start - 1] : c->lastsyncin;
+    
+    for (int n = start; n < end; ++n)
+    {
+        int jn = j + n - start;
+        if (sync != NULL) syncin = mb_sync_offset(&lastsyncin, sync[n]);
+        float x = mbsaw_step(f, jn, w, syncin, softsync, syncdir, &p);
+        f[jn + DD_SAMPLE_DELAY] += x;
+    }
+    
+    for (int n = start; n < end; ++n)
+    {
+        z += a * (f[j + n - start] - z);
+        if (accumulate) out[n] -= gain * z;
+        else out[n] = -(gain * z);
+    }
+    
+    c->phase[v] = p;
+    c->z[v] = z;
+}
+
+// The voices share one write position into their buffers, so every voice
+// reaches the end of its buffer on the same sample and they are shifted together
+static inline void mbsawbank_render(_tMBSawBank* c, float* const* outs, const float* const sync, int size, int accumulate)
+{
+    int end;
+    
+    for (int i = 0; i < size; i = end)
+    {
+        end = i + FILLEN - c->j;
+        if (end > size) end = size;
+        
+        float syncdir = c->syncdir;
+        for (int v = 0; v < c->numVoices; ++v)
+        {
+            syncdir = c->syncdir;
+            mbsawbank_voice(c, v, accumulate ? outs[0] : outs[v], sync, i, end, accumulate, &syncdir);
+        }
+        c->syncdir = syncdir;
+        
+        c->j += end - i;
+        if (c->j == FILLEN)
+        {
+            c->j = 0;
+            for (int v = 0; v < c->numVoices; ++v)
+            {
+                float* f = c->buffer + v * c->stride;
+                memcpy (f, f + FILLEN, STEP_DD_PULSE_LENGTH * sizeof (float));
+                memset (f + STEP_DD_PULSE_LENGTH, 0,  FILLEN * sizeof (float));
+            }
+        }
+    }
+    
+    if (sync != NULL && size > 0) c->lastsyncin = sync[size - 1];
+}
+
+void tMBSawBank_tickBlock(tMBSawBank* const bank, float* const out, const float* const sync, int size)
+{
+    _tMBSawBank* c = *bank;
+    
+    for (int i = 0; i < size; ++i) out[i] = 0.0f;
+    mbsawbank_render(c, &out, sync, size, 1);
+}
+
+void tMBSawBank_tickBlockVoices(tMBSawBank* const bank, float** const outs, const float* const sync, int size)
+{
+    _tMBSawBank* c = *bank;
+    
+    mbsawbank_render(c, outs, sync, size, 0);
+}
+
+void tMBSawBank_setFreq(tMBSawBank* const bank, int voice, float freq)
+{
+    _tMBSawBank* c = *bank;
+    c->freq[voice] = freq;
+}
+
+void tMBSawBank_setPhase(tMBSawBank* const bank, int voice, float phase)
+{
+    _tMBSawBank* c = *bank;
+    c->phase[voice] = phase;
+}
+
+void tMBSawBank_setGain(tMBSawBank* const bank, int voice, float gain)
+{
+    _tMBSawBank* c = *bank;
+    c->gain[voice] = gain;
+}
+
+void tMBSawBank_setSyncMode(tMBSawBank* const bank, int hardOrSoft)
+{
+    _tMBSawBank* c = *bank;
+    c->softsync = hardOrSoft > 0 ? 1 : 0;
+}
+
+void tMBSawBank_setSampleRate(tMBSawBank* const bank, float sr)
+{
+    _tMBSawBank* c = *bank;
+    c->invSampleRate = 1.0f/sr;
+}
+
+//==========================================================================================================
+//==========================================================================================================
+
+void tMBPulseBank_init(tMBPulseBank* const bank, int numVoices, LEAF* const leaf)
+{
+    tMBPulseBank_initToPool(bank, numVoices, &leaf->mempool);
+}
+
+void tMBPulseBank_initToPool(tMBPulseBank* const bank, int numVoices, tMempool* const pool)
+{
+    _tMempool* m = *pool;
+    _tMBPulseBank* c = *bank = (_tMBPulseBank*) mpool_alloc(sizeof(_tMBPulseBank), m);
+    c->mempool = m;
+    LEAF* leaf = c->mempool->leaf;
+    
+    c->numVoices = numVoices;
+    c->freq = (float*) mpool_alloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->gain = (float*) mpool_alloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->width = (float*) mpool_calloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->phase = (float*) mpool_calloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->x = (float*) mpool_alloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->z = (float*) mpool_calloc_aligned(sizeof(float) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->k = (int*) mpool_calloc_aligned(sizeof(int) * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    c->stride = mbbank_stride(FILLEN + STEP_DD_PULSE_LENGTH);
+    c->buffer = (float*) mpool_calloc_aligned(sizeof(float) * c->stride * numVoices, MPOOL_CACHE_LINE_SIZE, m);
+    for (int v = 0; v < numVoices; ++v)
+    {
+        c->freq[v] = 440.f;
+        c->gain[v] = 1.0f;
+        c->x[v] = 0.5f;
+    }
+    c->j = 0;
+    c->lastsyncin = 0.0f;
+    c->syncdir = 1.0f;
+    c->softsync = 0;
+    c->invSampleRate = leaf->invSampleRate;
+}
+
+void tMBPulseBank_free(tMBPulseBank* const bank)
+{
+    _tMBPulseBank* c = *bank;
+    
+    mpool_free((char*)c->buffer, c->mempool);
+    mpool_free((char*)c->k, c->mempool);
+    mpool_free((char*)c->z, c->mempool);
+    mpool_free((char*)c->x, c->mempool);
+    mpool_free((char*)c->phase, c->mempool);
+    mpool_free((char*)c->width, c->mempool);
+    mpool_free((char*)c->gain, c->mempool);
+    mpool_free((char*)c->freq, c->mempool);
+    mpool_free((char*)c, c->mempool);
+}
+
+// Same as mbsawbank_voice, with the pulse state and width of each voice
+static inline void mbpulsebank_voice(_tMBPulseBank* c, int v, float* const out, const float* const sync,
+                                     int start, int end, int accumulate, float* const syncdir)
+{
+    float* f = c->buffer + v * c->stride;
+    int j = c->j;
+    int softsync = c->softsync;
+    float a = 0.5f;
+    float w = c->freq[v] * c->invSampleRate;
+    float b = 0.5f * (1.0f + c->width[v]);
+    float gain = c->gain[v];
+    float p = c->phase[v];
+    float x = c->x[v];
+    float z = c->z[v];
+    int k = c->k[v];
+    float syncin = 0.0f;
+    float lastsyncin = (sync != NULL && start > 0) ? sync[start - 1] : c->lastsyncin;
+    
+    for (int n = start; n < end; ++n)
+    {
+        int jn = j + n - start;
+        if (sync != NULL) syncin = mb_sync_offset(&lastsyncin, sync[n]);
+        x = mbpulse_step(f, jn, w, b, syncin, softsync, syncdir, &p, x, &k);
+        f[jn + DD_SAMPLE_DELAY] += x;
+    }
+    
+    for (int n = start; n < end; ++n)
+    {
+        z += a * (f[j + n - start] - z);
+        if (accumulate) out[n] -= gain * z;
+        else out[n] = -(gain * z);
+    }
+    
+    c->phase[v] = p;
+    c->x[v] = x;
+    c->z[v] = z;
+    c->k[v] = k;
+}
+
+static inline void mbpulsebank_render(_tMBPulseBank* c, float* const* outs, const float* const sync, int size, int accumulate)
+{
+    int end;
+    
+    for (int i = 0; i < size; i = end)
+    {
+        end = i + FILLEN - c->j;
+        if (end > size) end = size;
+        
+        float syncdir = c->syncdir;
+        for (int v = 0; v < c->numVoices; ++v)
+        {
+            syncdir = c->syncdir;
+            mbpulsebank_voice(c, v, accumulate ? outs[0] : outs[v], sync, i, end, accumulate, &syncdir);
+        }
+        c->syncdir = syncdir;
+        
+        c->j += end - i;
+        if (c->j == FILLEN)
+        {
+            c->j = 0;
+            for (int v = 0; v < c->numVoices; ++v)
+            {
+                float* f = c->buffer + v * c->stride;
+                memcpy (f, f + FILLEN, STEP_DD_PULSE_LENGTH * sizeof (float));
+                memset (f + STEP_DD_PULSE_LENGTH, 0,  FILLEN * sizeof (float));
+            }
+        }
+    }
+    
+    if (sync != NULL && size > 0) c->lastsyncin = sync[size - 1];
+}
+
+void tMBPulseBank_tickBlock(tMBPulseBank* const bank, float* const out, const float* const sync, int size)
+{
+    _tMBPulseBank* c = *bank;
+    
+    for (int i = 0; i < size; ++i) out[i] = 0.0f;
+    mbpulsebank_render(c, &out, sync, size, 1);
+}
+
+void tMBPulseBank_tickBlockVoices(tMBPulseBank* const bank, float** const outs, const float* const sync, int size)
+{
+    _tMBPulseBank* c = *bank;
+    
+    mbpulsebank_render(c, outs, sync, size, 0);
+}
+
+void tMBPulseBank_setFreq(tMBPulseBank* const bank, int voice, float freq)
+{
+    _tMBPulseBank* c = *bank;
+    c->freq[voice] = freq;
+}
+
+void tMBPulseBank_setWidth(tMBPulseBank* const bank, int voice, float width)
+{
+    _tMBPulseBank* c = *bank;
+    c->width[voice] = width;
+}
+
+void tMBPulseBank_setPhase(tMBPulseBank* const bank, int voice, float phase)
+{
+    _tMBPulseBank* c = *bank;
+    c->phase[voice] = phase;
+}
+
+void tMBPulseBank_setGain(tMBPulseBank* const bank, int voice, float gain)
+{
+    _tMBPulseBank* c = *bank;
+    c->gain[voice] = gain;
+}
+
+void tMBPulseBank_setSyncMode(tMBPulseBank* const bank, int hardOrSoft)
+{
+    _tMBPulseBank* c = *bank;
+    c->softsync = hardOrSoft > 0 ? 1 : 0;
+}
+
+void tMBPulseBank_setSampleRate(tMBPulseBank* const bank, float sr)
+{
+    _tMBPulseBank* c = *bank;
+    c->invSampleRate = 1.0f/sr;
+}
+
 
 // WaveTable
 void    tTable_init(tTable* const cy, float* waveTable, int size, LEAF* const leaf)
@@ -1784,6 +3254,274 @@ void     tTable_setSampleRate(tTable* const cy, float sr)
     tTable_setFreq(cy, c->freq);
 }
 
+#if LEAF_USE_FFT_WAVETABLES
+// Makes the band-limited copies of a wavetable by resynthesizing them from the
+// spectrum of the base table. Table t keeps the harmonics below size >> (t + 1),
+// the cutoffs the Butterworth passes aim for, but comes out exactly periodic and
+// in phase with the base table. Tables may differ in size (as in tWaveTableS) as
+// long as every size is a power of two; sizes can be NULL if all are the same.
+static void wavetable_bandlimit(const float* const base, int size, float** const tables,
+                                const int* const sizes, int numTables, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    float* spectrum = (float*) mpool_alloc_aligned(sizeof(float) * size, MPOOL_CACHE_LINE_SIZE, m);
+    
+    for (int i = 0; i < size; ++i) spectrum[i] = base[i];
+    mayer_realfft(size, spectrum);
+    
+    // mayer_realifft of a spectrum taken at size gives size times the signal,
+    // whatever size it is resynthesized at
+    float scale = 1.0f / (float) size;
+    
+    for (int t = 1; t < numTables; ++t)
+    {
+        float* table = tables[t];
+        int tableSize = sizes != NULL ? sizes[t] : size;
+        
+        // Always keep at least the fundamental, and nothing at or above Nyquist
+        int limit = t < 30 ? size >> (t + 1) : 0;
+        if (limit < 2) limit = 2;
+        if (limit > size / 2) limit = size / 2;
+        if (limit > tableSize / 2) limit = tableSize / 2;
+        
+        for (int i = 0; i < tableSize; ++i) table[i] = 0.0f;
+        table[0] = spectrum[0];
+        for (int h = 1; h < limit; ++h)
+        {
+            table[h] = spectrum[h];
+            table[tableSize - h] = spectrum[size - h];
+        }
+        mayer_realifft(tableSize, table);
+        for (int i = 0; i < tableSize; ++i) table[i] *= scale;
+    }
+    
+    mpool_free((char*)spectrum, m);
+}
+#endif
+
+// FNV-1a over the samples of a wavetable and the settings its band-limited
+// copies depend on, used to find tables that can be shared
+static uint32_t wavetable_hash(const float* const table, int size, float maxFreq)
+{
+    uint32_t hash = 2166136261u;
+    const unsigned char* bytes = (const unsigned char*) table;
+    for (size_t i = 0; i < sizeof(float) * size; ++i) hash = (hash ^ bytes[i]) * 16777619u;
+    bytes = (const unsigned char*) &maxFreq;
+    for (size_t i = 0; i < sizeof(float); ++i) hash = (hash ^ bytes[i]) * 16777619u;
+    return (hash ^ (uint32_t) size) * 16777619u;
+}
+
+// The value of 1.0 in a WaveTableInt16 level
+#define WAVETABLE_INT16_ONE 16384.0f
+
+static int16_t wavetable_toInt16(float f)
+{
+    float x = f * WAVETABLE_INT16_ONE;
+    x = LEAF_clip(-32768.0f, x < 0.0f ? x - 0.5f : x + 0.5f, 32767.0f);
+    return (int16_t) x;
+}
+
+// Float to IEEE half, rounding to nearest even. Anything too large for a half,
+// NaN included, comes out as infinity.
+static uint16_t wavetable_toHalf(float f)
+{
+    union { float f; uint32_t i; } x, denormMagic;
+    x.f = f;
+    denormMagic.i = ((127 - 15) + (23 - 10) + 1) << 23;
+    uint32_t sign = x.i & 0x80000000u;
+    uint32_t h;
+    x.i ^= sign;
+    
+    if (x.i >= (127 + 16) << 23) h = 0x7c00;
+    else if (x.i < (113 << 23))
+    {
+        // Subnormal or zero, let the float adder do the rounding
+        x.f += denormMagic.f;
+        h = x.i - denormMagic.i;
+    }
+    else
+    {
+        uint32_t mantOdd = (x.i >> 13) & 1;
+        x.i += ((uint32_t) (15 - 127) << 23) + 0xfff;
+        x.i += mantOdd;
+        h = x.i >> 13;
+    }
+    return (uint16_t) (h | (sign >> 16));
+}
+
+// IEEE half to float. Wavetables hold no infinities or NaNs, so those are left
+// out and the conversion needs no branches.
+static inline float wavetable_fromHalf(uint16_t h)
+{
+    union { float f; uint32_t i; } x, magic;
+    magic.i = (254 - 15) << 23;
+    x.i = (uint32_t) (h & 0x7fff) << 13;
+    x.f *= magic.f;
+    x.i |= (uint32_t) (h & 0x8000) << 16;
+    return x.f;
+}
+
+// Converts float levels to a compact format, freeing the float ones. As in
+// wavetable_bandlimit, sizes can be NULL if every level is size samples.
+static int16_t** wavetable_compact(float** const tables, const int* const sizes, int size,
+                                   int numTables, WaveTableFormat format, _tMempool* const m)
+{
+    int16_t** compact = (int16_t**) mpool_alloc(sizeof(int16_t*) * numTables, m);
+    for (int t = 0; t < numTables; ++t)
+    {
+        int tableSize = sizes != NULL ? sizes[t] : size;
+        compact[t] = (int16_t*) mpool_alloc_aligned(sizeof(int16_t) * tableSize, MPOOL_CACHE_LINE_SIZE, m);
+        for (int i = 0; i < tableSize; ++i)
+        {
+            compact[t][i] = format == WaveTableHalf ? (int16_t) wavetable_toHalf(tables[t][i])
+                                                    : wavetable_toInt16(tables[t][i]);
+        }
+        mpool_free((char*)tables[t], m);
+    }
+    mpool_free((char*)tables, m);
+    return compact;
+}
+
+// The reverse of wavetable_compact
+static float** wavetable_expand(int16_t** const compact, const int* const sizes, int size,
+                                int numTables, WaveTableFormat format, _tMempool* const m)
+{
+    float** tables = (float**) mpool_alloc(sizeof(float*) * numTables, m);
+    for (int t = 0; t < numTables; ++t)
+    {
+        int tableSize = sizes != NULL ? sizes[t] : size;
+        tables[t] = (float*) mpool_alloc_aligned(sizeof(float) * tableSize, MPOOL_CACHE_LINE_SIZE, m);
+        for (int i = 0; i < tableSize; ++i)
+        {
+            tables[t][i] = format == WaveTableHalf ? wavetable_fromHalf((uint16_t) compact[t][i])
+                                                   : (float) compact[t][i] * (1.0f / WAVETABLE_INT16_ONE);
+        }
+        mpool_free((char*)compact[t], m);
+    }
+    mpool_free((char*)compact, m);
+    return tables;
+}
+
+// Points tables or compact at numTables levels laid out one after another in
+// data, in the format they are given in. The levels are copied if copy is set
+// and otherwise used in place, in which case they must never be written to.
+static void wavetable_load(const void* data, const int* const sizes, int size, int numTables,
+                           WaveTableFormat format, int copy, float*** tables, int16_t*** compact,
+                           _tMempool* const m)
+{
+    size_t sampleSize = format == WaveTableFloat ? sizeof(float) : sizeof(int16_t);
+    const char* level = (const char*) data;
+    
+    if (format == WaveTableFloat) *tables = (float**) mpool_alloc(sizeof(float*) * numTables, m);
+    else *compact = (int16_t**) mpool_alloc(sizeof(int16_t*) * numTables, m);
+    
+    for (int t = 0; t < numTables; ++t)
+    {
+        int tableSize = sizes != NULL ? sizes[t] : size;
+        char* dest = (char*) level;
+        if (copy)
+        {
+            dest = mpool_alloc_aligned(sampleSize * tableSize, MPOOL_CACHE_LINE_SIZE, m);
+            memcpy(dest, level, sampleSize * tableSize);
+        }
+        level += sampleSize * tableSize;
+        
+        if (format == WaveTableFloat) (*tables)[t] = (float*) dest;
+        else (*compact)[t] = (int16_t*) dest;
+    }
+}
+
+// Replaces levels that are read in place with copies that can be modified
+static void wavetable_own(float** const tables, int16_t** const compact, const int* const sizes, int size,
+                          int numTables, WaveTableFormat format, _tMempool* const m)
+{
+    size_t sampleSize = format == WaveTableFloat ? sizeof(float) : sizeof(int16_t);
+    
+    for (int t = 0; t < numTables; ++t)
+    {
+        int tableSize = sizes != NULL ? sizes[t] : size;
+        char* copy = mpool_alloc_aligned(sampleSize * tableSize, MPOOL_CACHE_LINE_SIZE, m);
+        if (format == WaveTableFloat)
+        {
+            memcpy(copy, tables[t], sampleSize * tableSize);
+            tables[t] = (float*) copy;
+        }
+        else
+        {
+            memcpy(copy, compact[t], sampleSize * tableSize);
+            compact[t] = (int16_t*) copy;
+        }
+    }
+}
+
+// Stands in for data that fails wavetable_checkHeader, two silent levels of
+// 128 samples, the smallest a tWaveTableS level can be
+static const float wavetable_silence[256] = { 0.0f };
+
+static int wavetable_checkHeader(const WaveTableDataHeader* const header, size_t length, int halving)
+{
+    if (length < sizeof(WaveTableDataHeader)) return 0;
+    
+    if (!(header->magic == LEAF_WAVETABLE_DATA_MAGIC &&
+          header->version == LEAF_WAVETABLE_DATA_VERSION &&
+          header->format < WaveTableFormatNil &&
+          header->halving == halving &&
+          // Halving levels never get smaller than 128 samples
+          header->size >= (halving ? 128u : 1u) && (header->size & (header->size - 1)) == 0 &&
+          header->numTables >= 2 && header->numTables < 32 &&
+          header->dataOffset >= sizeof(WaveTableDataHeader) && header->dataOffset <= length))
+    {
+        return 0;
+    }
+    
+    // Every level has to lie within the data, counted in samples so nothing can overflow
+    size_t sampleSize = header->format == WaveTableFloat ? sizeof(float) : sizeof(int16_t);
+    size_t available = (length - header->dataOffset) / sampleSize;
+    size_t levelSize = header->size;
+    for (uint32_t t = 0; t < header->numTables; ++t)
+    {
+        if (levelSize > available) return 0;
+        available -= levelSize;
+        if (halving && levelSize > 128) levelSize /= 2;
+    }
+    return 1;
+}
+
+static void wavetable_writeHeader(WaveTableDataHeader* const header, WaveTableFormat format, int halving,
+                                  int size, int numTables, float sampleRate, float baseFreq, float maxFreq)
+{
+    memset(header, 0, sizeof(WaveTableDataHeader));
+    header->magic = LEAF_WAVETABLE_DATA_MAGIC;
+    header->version = LEAF_WAVETABLE_DATA_VERSION;
+    header->format = (uint8_t) format;
+    header->halving = (uint8_t) halving;
+    header->size = (uint32_t) size;
+    header->numTables = (uint32_t) numTables;
+    header->sampleRate = sampleRate;
+    header->baseFreq = baseFreq;
+    header->maxFreq = maxFreq;
+    header->dataOffset = sizeof(WaveTableDataHeader);
+}
+
+static void wavetable_setFormat(_tWaveTable* const c, WaveTableFormat format)
+{
+    if (format == c->format) return;
+    
+    if (c->format != WaveTableFloat)
+    {
+        c->tables = wavetable_expand(c->compactTables, NULL, c->size, c->numTables, c->format, c->mempool);
+        c->baseTable = c->tables[0];
+        c->compactTables = NULL;
+    }
+    if (format != WaveTableFloat)
+    {
+        c->compactTables = wavetable_compact(c->tables, NULL, c->size, c->numTables, format, c->mempool);
+        c->tables = NULL;
+        c->baseTable = NULL;
+    }
+    c->format = format;
+}
+
 void tWaveTable_init(tWaveTable* const cy, float* table, int size, float maxFreq, LEAF* const leaf)
 {
     tWaveTable_initToPool(cy, table, size, maxFreq, &leaf->mempool);
@@ -1796,6 +3534,15 @@ void tWaveTable_initToPool(tWaveTable* const cy, float* table, int size, float m
     c->mempool = m;
     LEAF* leaf = c->mempool->leaf;
     
+    c->refCount = 1;
+    c->shared = 0;
+    c->hash = 0;
+    c->nextShared = NULL;
+    
+    c->format = WaveTableFloat;
+    c->compactTables = NULL;
+    c->externalLevels = 0;
+    
     c->sampleRate = leaf->sampleRate;
     
     c->maxFreq = maxFreq;
@@ -1818,11 +3565,11 @@ void tWaveTable_initToPool(tWaveTable* const cy, float* table, int size, float m
     c->sizeMask = size-1;
     // Allocate memory for the tables
     c->tables = (float**) mpool_alloc(sizeof(float*) * c->numTables, c->mempool);
-    c->baseTable = (float*) mpool_alloc(sizeof(float) * c->size, c->mempool);
+    c->baseTable = (float*) mpool_alloc_aligned(sizeof(float) * c->size, MPOOL_CACHE_LINE_SIZE, c->mempool);
     c->tables[0] = c->baseTable;
     for (int t = 1; t < c->numTables; ++t)
     {
-        c->tables[t] = (float*) mpool_alloc(sizeof(float) * c->size, c->mempool);
+        c->tables[t] = (float*) mpool_alloc_aligned(sizeof(float) * c->size, MPOOL_CACHE_LINE_SIZE, c->mempool);
     }
     
     // Copy table
@@ -1832,6 +3579,9 @@ void tWaveTable_initToPool(tWaveTable* const cy, float* table, int size, float m
     }
     
     // Make bandlimited copies
+#if LEAF_USE_FFT_WAVETABLES
+    wavetable_bandlimit(c->baseTable, c->size, c->tables, NULL, c->numTables, mp);
+#else
     f = c->sampleRate * 0.25; //start at half nyquist
     // Not worth going over order 8 I think, and even 8 is only marginally better than 4.
     tButterworth_initToPool(&c->bl, 8, -1.0f, f, mp);
@@ -1851,12 +3601,182 @@ void tWaveTable_initToPool(tWaveTable* const cy, float* table, int size, float m
         f *= 0.5f; //halve the cutoff for next pass
     }
     tButterworth_free(&c->bl);
+#endif
+}
+
+void tWaveTable_initShared(tWaveTable* const cy, float* table, int size, float maxFreq, LEAF* const leaf)
+{
+    uint32_t hash = wavetable_hash(table, size, maxFreq);
+    
+    for (_tWaveTable* c = leaf->waveTables; c != NULL; c = c->nextShared)
+    {
+        // The hash only narrows the search, so confirm with the data itself
+        if (c->hash == hash && c->size == size && c->maxFreq == maxFreq &&
+            c->sampleRate == leaf->sampleRate &&
+            memcmp(c->baseTable, table, sizeof(float) * size) == 0)
+        {
+            c->refCount++;
+            *cy = c;
+            return;
+        }
+    }
+    
+    tWaveTable_initToPool(cy, table, size, maxFreq, &leaf->mempool);
+    _tWaveTable* c = *cy;
+    c->shared = 1;
+    c->hash = hash;
+    c->nextShared = leaf->waveTables;
+    leaf->waveTables = c;
+}
+
+void tWaveTable_initCompact(tWaveTable* const cy, float* table, int size, float maxFreq, WaveTableFormat format, LEAF* const leaf)
+{
+    tWaveTable_initCompactToPool(cy, table, size, maxFreq, format, &leaf->mempool);
+}
+
+void tWaveTable_initCompactToPool(tWaveTable* const cy, float* table, int size, float maxFreq, WaveTableFormat format, tMempool* const mp)
+{
+    tWaveTable_initToPool(cy, table, size, maxFreq, mp);
+    wavetable_setFormat(*cy, format);
+}
+
+static void wavetable_initLevels(tWaveTable* const cy, const void* data, int size, int numTables,
+                                 WaveTableFormat format, int copy, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tWaveTable* c = *cy = (_tWaveTable*) mpool_alloc(sizeof(_tWaveTable), m);
+    c->mempool = m;
+    LEAF* leaf = c->mempool->leaf;
+    
+    c->refCount = 1;
+    c->shared = 0;
+    c->hash = 0;
+    c->nextShared = NULL;
+    
+    c->sampleRate = leaf->sampleRate;
+    
+    // Determine base frequency
+    c->baseFreq = c->sampleRate / (float) size;
+    c->invBaseFreq = 1.0f / c->baseFreq;
+    
+    // The lowest maximum frequency that gives this many tables
+    c->numTables = numTables;
+    c->maxFreq = ldexpf(c->baseFreq, numTables - 2);
+    
+    c->size = size;
+    c->sizeMask = size-1;
+    
+    c->format = format;
+    c->tables = NULL;
+    c->compactTables = NULL;
+    c->externalLevels = !copy;
+    wavetable_load(data, NULL, size, numTables, format, copy, &c->tables, &c->compactTables, m);
+    c->baseTable = c->tables != NULL ? c->tables[0] : NULL;
+}
+
+void tWaveTable_initFromData(tWaveTable* const cy, const void* data, int size, int numTables, WaveTableFormat format, LEAF* const leaf)
+{
+    tWaveTable_initFromDataToPool(cy, data, size, numTables, format, &leaf->mempool);
+}
+
+void tWaveTable_initFromDataToPool(tWaveTable* const cy, const void* data, int size, int numTables, WaveTableFormat format, tMempool* const mp)
+{
+    wavetable_initLevels(cy, data, size, numTables, format, 1, mp);
+}
+
+void tWaveTable_initFromLevels(tWaveTable* const cy, const void* levels, int size, int numTables, WaveTableFormat format, LEAF* const leaf)
+{
+    tWaveTable_initFromLevelsToPool(cy, levels, size, numTables, format, &leaf->mempool);
+}
+
+void tWaveTable_initFromLevelsToPool(tWaveTable* const cy, const void* levels, int size, int numTables, WaveTableFormat format, tMempool* const mp)
+{
+    wavetable_initLevels(cy, levels, size, numTables, format, 0, mp);
+}
+
+void tWaveTable_initFromMemory(tWaveTable* const cy, const void* data, size_t length, LEAF* const leaf)
+{
+    tWaveTable_initFromMemoryToPool(cy, data, length, &leaf->mempool);
+}
+
+void tWaveTable_initFromMemoryToPool(tWaveTable* const cy, const void* data, size_t length, tMempool* const mp)
+{
+    const WaveTableDataHeader* header = (const WaveTableDataHeader*) data;
+    
+    if (!wavetable_checkHeader(header, length, 0))
+    {
+        LEAF_internalErrorCallback((*mp)->leaf, LEAFInvalidData);
+        wavetable_initLevels(cy, wavetable_silence, 128, 2, WaveTableFloat, 0, mp);
+        return;
+    }
+    
+    wavetable_initLevels(cy, (const char*) data + header->dataOffset, header->size, header->numTables,
+                         (WaveTableFormat) header->format, 0, mp);
+    _tWaveTable* c = *cy;
+    c->maxFreq = header->maxFreq;
+    
+    // Made for another sample rate, where a different number of levels may be needed
+    if (header->sampleRate != c->sampleRate)
+    {
+        float sr = c->sampleRate;
+        c->sampleRate = header->sampleRate;
+        tWaveTable_setSampleRate(cy, sr);
+    }
+}
+
+size_t tWaveTable_writeToMemory(tWaveTable* const cy, void* data)
+{
+    _tWaveTable* c = *cy;
+    size_t sampleSize = c->format == WaveTableFloat ? sizeof(float) : sizeof(int16_t);
+    size_t levelSize = sampleSize * c->size;
+    
+    if (data == NULL) return sizeof(WaveTableDataHeader) + levelSize * c->numTables;
+    
+    WaveTableDataHeader* header = (WaveTableDataHeader*) data;
+    wavetable_writeHeader(header, c->format, 0, c->size, c->numTables, c->sampleRate, c->baseFreq, c->maxFreq);
+    
+    char* level = (char*) data + header->dataOffset;
+    for (int t = 0; t < c->numTables; ++t)
+    {
+        if (c->format == WaveTableFloat) memcpy(level, c->tables[t], levelSize);
+        else memcpy(level, c->compactTables[t], levelSize);
+        level += levelSize;
+    }
+    return (size_t) (level - (char*) data);
 }
 
 void tWaveTable_free(tWaveTable* const cy)
 {
     _tWaveTable* c = *cy;
     
+    if (--c->refCount > 0) return;
+    
+    if (c->shared)
+    {
+        _tWaveTable** link = &c->mempool->leaf->waveTables;
+        while (*link != c) link = &(*link)->nextShared;
+        *link = c->nextShared;
+    }
+    
+    if (c->externalLevels)
+    {
+        if (c->format != WaveTableFloat) mpool_free((char*)c->compactTables, c->mempool);
+        else mpool_free((char*)c->tables, c->mempool);
+        mpool_free((char*)c, c->mempool);
+        return;
+    }
+    
+    if (c->format != WaveTableFloat)
+    {
+        for (int t = 0; t < c->numTables; ++t)
+        {
+            mpool_free((char*)c->compactTables[t], c->mempool);
+        }
+        mpool_free((char*)c->compactTables, c->mempool);
+        mpool_free((char*)c, c->mempool);
+        return;
+    }
+    
     mpool_free((char*)c->baseTable, c->mempool);
     for (int t = 1; t < c->numTables; ++t)
     {
@@ -1866,9 +3786,42 @@ void tWaveTable_free(tWaveTable* const cy)
     mpool_free((char*)c, c->mempool);
 }
 
+// Gives a holder of a shared tWaveTable a table of its own, made from the base
+// level, so that it can be changed without changing it for the other holders
+static void wavetable_detach(tWaveTable* const cy)
+{
+    _tWaveTable* shared = *cy;
+    const void* base = shared->format == WaveTableFloat ? (const void*) shared->tables[0]
+                                                        : (const void*) shared->compactTables[0];
+    wavetable_initLevels(cy, base, shared->size, 1, shared->format, 1, &shared->mempool);
+    _tWaveTable* c = *cy;
+    c->sampleRate = shared->sampleRate;
+    c->maxFreq = shared->maxFreq;
+    shared->refCount--;
+}
+
 void tWaveTable_setSampleRate(tWaveTable* const cy, float sr)
 {
     _tWaveTable* c = *cy;
+    
+    // The other holders of a shared table keep it at the rate they got it at
+    if (c->refCount > 1)
+    {
+        if (sr == c->sampleRate) return;
+        wavetable_detach(cy);
+        c = *cy;
+    }
+    
+    if (c->externalLevels)
+    {
+        wavetable_own(c->tables, c->compactTables, NULL, c->size, c->numTables, c->format, c->mempool);
+        c->baseTable = c->tables != NULL ? c->tables[0] : NULL;
+        c->externalLevels = 0;
+    }
+    
+    // Compact tables are rebuilt at full precision and then converted back
+    WaveTableFormat format = c->format;
+    wavetable_setFormat(c, WaveTableFloat);
         
     // Changing the sample rate of a wavetable requires up to partially reinitialize
     for (int t = 1; t < c->numTables; ++t)
@@ -1898,10 +3851,13 @@ void tWaveTable_setSampleRate(tWaveTable* const cy, float sr)
     c->tables[0] = c->baseTable;
     for (int t = 1; t < c->numTables; ++t)
     {
-        c->tables[t] = (float*) mpool_alloc(sizeof(float) * c->size, c->mempool);
+        c->tables[t] = (float*) mpool_alloc_aligned(sizeof(float) * c->size, MPOOL_CACHE_LINE_SIZE, c->mempool);
     }
     
     // Make bandlimited copies
+#if LEAF_USE_FFT_WAVETABLES
+    wavetable_bandlimit(c->baseTable, c->size, c->tables, NULL, c->numTables, &c->mempool);
+#else
     f = c->sampleRate * 0.25; //start at half nyquist
     // Not worth going over order 8 I think, and even 8 is only marginally better than 4.
     tButterworth_initToPool(&c->bl, 8, -1.0f, f, &c->mempool);
@@ -1922,6 +3878,9 @@ void tWaveTable_setSampleRate(tWaveTable* const cy, float sr)
         f *= 0.5f; //halve the cutoff for next pass
     }
     tButterworth_free(&c->bl);
+#endif
+    
+    wavetable_setFormat(c, format);
 }
 
 //================================================================================================
@@ -1961,83 +3920,222 @@ void tWaveOsc_initToPool(tWaveOsc* const cy, tWaveTable* tables, int numTables,
 
     c->invSampleRateTimesTwoTo32 = leaf->invSampleRate * TWO_TO_32;
     c->maxFreq = c->tables[0]->maxFreq;
+    c->ownsTables = 0;
+}
+
+void tWaveOsc_initShared(tWaveOsc* const cy, float** tables, int numTables, int size, float maxFreq, LEAF* const leaf)
+{
+    tWaveTable* shared = (tWaveTable*) mpool_alloc(sizeof(tWaveTable) * numTables, leaf->mempool);
+    for (int t = 0; t < numTables; ++t)
+    {
+        tWaveTable_initShared(&shared[t], tables[t], size, maxFreq, leaf);
+    }
+    
+    tWaveOsc_initToPool(cy, shared, numTables, &leaf->mempool);
+    (*cy)->ownsTables = 1;
+}
+
+// Drop the references taken by tWaveOsc_initShared
+static void waveosc_releaseTables(_tWaveOsc* c)
+{
+    if (!c->ownsTables) return;
+    
+    for (int t = 0; t < c->numTables; ++t)
+    {
+        tWaveTable_free(&c->tables[t]);
+    }
+    mpool_free((char*)c->tables, c->mempool);
+    c->ownsTables = 0;
 }
 
 void tWaveOsc_free(tWaveOsc* const cy)
 {
     _tWaveOsc* c = *cy;
+    waveosc_releaseTables(c);
     mpool_free((char*)c, c->mempool);
 }
 
-float tWaveOsc_tick(tWaveOsc* const cy)
+// One table of the set, interpolated within each of two adjacent octave levels
+// and then between them, in the same order of operations as tWaveOsc_tick
+static inline float waveosc_lookup(const float* const table0, const float* const table1,
+                                   int sizeMask, float floatPhase, float w)
 {
-    _tWaveOsc* c = *cy;
+    float temp = sizeMask * floatPhase;
+    int idx = (int)temp;
+    float frac = temp - (float)idx;
+    int idx2 = (idx + 1) & sizeMask;
     
-    // Phasor increment (unsigned 32bit int wraps automatically with overflow so no need for if branch checks, as you need with float)
-    c->phase += c->inc;
-    float floatPhase = (double)c->phase * 2.32830643654e-10;
-    float s1 = 0.f, s2 = 0.f;
-
-    float temp;
-    int idx;
-    float frac;
-    float samp0;
-    float samp1;
-
-    int oct = c->oct;
-
-    int sizeMask = c->tables[c->o1]->sizeMask;
-    float** tables = c->tables[c->o1]->tables;
+    float oct0 = (table0[idx] + (table0[idx2] - table0[idx]) * frac);
+    float oct1 = (table1[idx] + (table1[idx2] - table1[idx]) * frac);
+    
+    return oct0 + (oct1 - oct0) * w;
+}
 
-    // Wavetable synthesis
-    temp = sizeMask * floatPhase;
-    idx = (int)temp;
-    frac = temp - (float)idx;
-    samp0 = tables[oct][idx];
-    idx = (idx + 1) & sizeMask;
-    samp1 = tables[oct][idx];
+static inline float waveosc_lookupInt16(const int16_t* const table0, const int16_t* const table1,
+                                        int sizeMask, float floatPhase, float w)
+{
+    float temp = sizeMask * floatPhase;
+    int idx = (int)temp;
+    float frac = temp - (float)idx;
+    int idx2 = (idx + 1) & sizeMask;
+    
+    float oct0 = ((float)table0[idx] + (float)(table0[idx2] - table0[idx]) * frac);
+    float oct1 = ((float)table1[idx] + (float)(table1[idx2] - table1[idx]) * frac);
+    
+    return (oct0 + (oct1 - oct0) * w) * (1.0f / WAVETABLE_INT16_ONE);
+}
 
+static inline float waveosc_lookupHalf(const int16_t* const table0, const int16_t* const table1,
+                                       int sizeMask, float floatPhase, float w)
+{
+    float temp = sizeMask * floatPhase;
+    int idx = (int)temp;
+    float frac = temp - (float)idx;
+    int idx2 = (idx + 1) & sizeMask;
+    
+    float samp0 = wavetable_fromHalf((uint16_t) table0[idx]);
+    float samp1 = wavetable_fromHalf((uint16_t) table0[idx2]);
     float oct0 = (samp0 + (samp1 - samp0) * frac);
-
-    temp = sizeMask * floatPhase;
-    idx = (int)temp;
-    frac = temp - (float)idx;
-    samp0 = tables[oct+1][idx];
-    idx = (idx + 1) & sizeMask;
-    samp1 = tables[oct+1][idx];
-
+    samp0 = wavetable_fromHalf((uint16_t) table1[idx]);
+    samp1 = wavetable_fromHalf((uint16_t) table1[idx2]);
     float oct1 = (samp0 + (samp1 - samp0) * frac);
+    
+    return oct0 + (oct1 - oct0) * w;
+}
 
-    s1 = oct0 + (oct1 - oct0) * c->w;
-
-    sizeMask = c->tables[c->o2]->sizeMask;
-    tables = c->tables[c->o2]->tables;
-
-    // Wavetable synthesis
-    temp = sizeMask * floatPhase;
-    idx = (int)temp;
-    frac = temp - (float)idx;
-    samp0 = tables[oct][idx];
-    idx = (idx + 1) & sizeMask;
-    samp1 = tables[oct][idx];
-
-    oct0 = (samp0 + (samp1 - samp0) * frac);
-
-    temp = sizeMask * floatPhase;
-    idx = (int)temp;
-    frac = temp - (float)idx;
-    samp0 = tables[oct+1][idx];
-    idx = (idx + 1) & sizeMask;
-    samp1 = tables[oct+1][idx];
-
-    oct1 = (samp0 + (samp1 - samp0) * frac);
+// Reads one table of the set in whatever format it keeps its levels in
+static inline float waveosc_level(const _tWaveTable* const t, int oct, float floatPhase, float w)
+{
+    if (t->format == WaveTableInt16)
+        return waveosc_lookupInt16(t->compactTables[oct], t->compactTables[oct+1], t->sizeMask, floatPhase, w);
+    if (t->format == WaveTableHalf)
+        return waveosc_lookupHalf(t->compactTables[oct], t->compactTables[oct+1], t->sizeMask, floatPhase, w);
+    return waveosc_lookup(t->tables[oct], t->tables[oct+1], t->sizeMask, floatPhase, w);
+}
 
-    s2 = oct0 + (oct1 - oct0) * c->w;
+float tWaveOsc_tick(tWaveOsc* const cy)
+{
+    _tWaveOsc* c = *cy;
+    
+    // Phasor increment (unsigned 32bit int wraps automatically with overflow so no need for if branch checks, as you need with float)
+    c->phase += c->inc;
+    float floatPhase = (double)c->phase * 2.32830643654e-10;
+    
+    // Wavetable synthesis
+    float s1 = waveosc_level(c->tables[c->o1], c->oct, floatPhase, c->w);
+    float s2 = waveosc_level(c->tables[c->o2], c->oct, floatPhase, c->w);
 
     // Ideally should determine correlation to get a good equal power fade between tables
     return s1 + (s2 - s1) * c->mix;
 }
 
+// Renders with the tables picked by the current frequency and index. Those are
+// fixed for the whole run, so the table pointers are loaded once and the sample
+// loop is left with only the phase update and the lookups.
+static inline void waveosc_render(_tWaveOsc* c, float* const out, int size)
+{
+    uint32_t phase = c->phase;
+    uint32_t inc = c->inc;
+    float w = c->w;
+    float mix = c->mix;
+    int oct = c->oct;
+    
+    const _tWaveTable* t1 = c->tables[c->o1];
+    const _tWaveTable* t2 = c->tables[c->o2];
+    
+    if (t1->format != WaveTableFloat && t1->format == t2->format)
+    {
+        // Compact levels in one format, so the conversion is picked once as well
+        const int16_t* table10 = t1->compactTables[oct];
+        const int16_t* table11 = t1->compactTables[oct+1];
+        const int16_t* table20 = t2->compactTables[oct];
+        const int16_t* table21 = t2->compactTables[oct+1];
+        
+        if (t1->format == WaveTableInt16)
+        {
+            for (int i = 0; i < size; ++i)
+            {
+                phase += inc;
+                float floatPhase = (double)phase * 2.32830643654e-10;
+                float s1 = waveosc_lookupInt16(table10, table11, t1->sizeMask, floatPhase, w);
+                float s2 = waveosc_lookupInt16(table20, table21, t2->sizeMask, floatPhase, w);
+                out[i] = s1 + (s2 - s1) * mix;
+            }
+        }
+        else
+        {
+            for (int i = 0; i < size; ++i)
+            {
+                phase += inc;
+                float floatPhase = (double)phase * 2.32830643654e-10;
+                float s1 = waveosc_lookupHalf(table10, table11, t1->sizeMask, floatPhase, w);
+                float s2 = waveosc_lookupHalf(table20, table21, t2->sizeMask, floatPhase, w);
+                out[i] = s1 + (s2 - s1) * mix;
+            }
+        }
+        c->phase = phase;
+        return;
+    }
+    
+    if (t1->format != WaveTableFloat || t2->format != WaveTableFloat)
+    {
+        // Tables in different formats, where the format checks are at least the
+        // same for the whole run
+        for (int i = 0; i < size; ++i)
+        {
+            phase += inc;
+            float floatPhase = (double)phase * 2.32830643654e-10;
+            float s1 = waveosc_level(t1, oct, floatPhase, w);
+            float s2 = waveosc_level(t2, oct, floatPhase, w);
+            out[i] = s1 + (s2 - s1) * mix;
+        }
+        c->phase = phase;
+        return;
+    }
+    
+    int sizeMask1 = t1->sizeMask;
+    const float* table10 = t1->tables[oct];
+    const float* table11 = t1->tables[oct+1];
+    int sizeMask2 = t2->sizeMask;
+    const float* table20 = t2->tables[oct];
+    const float* table21 = t2->tables[oct+1];
+    
+    for (int i = 0; i < size; ++i)
+    {
+        phase += inc;
+        float floatPhase = (double)phase * 2.32830643654e-10;
+        float s1 = waveosc_lookup(table10, table11, sizeMask1, floatPhase, w);
+        float s2 = waveosc_lookup(table20, table21, sizeMask2, floatPhase, w);
+        out[i] = s1 + (s2 - s1) * mix;
+    }
+    
+    c->phase = phase;
+}
+
+void tWaveOsc_tickBlock(tWaveOsc* const cy, float* const out, const float* const freq, const float* const index, int size)
+{
+    _tWaveOsc* c = *cy;
+    
+    if (freq == NULL && index == NULL)
+    {
+        waveosc_render(c, out, size);
+        return;
+    }
+    
+    // Runs of samples with the same frequency and index share one table selection
+    for (int i = 0, end; i < size; i = end)
+    {
+        if (freq != NULL) tWaveOsc_setFreq(cy, freq[i]);
+        if (index != NULL) tWaveOsc_setIndex(cy, index[i]);
+        
+        end = i + 1;
+        while (end < size && (freq == NULL || freq[end] == freq[i]) &&
+               (index == NULL || index[end] == index[i])) end++;
+        
+        waveosc_render(c, out + i, end - i);
+    }
+}
+
 void tWaveOsc_setFreq(tWaveOsc* const cy, float freq)
 {
     _tWaveOsc* c = *cy;
@@ -2080,6 +4178,7 @@ void tWaveOsc_setTables(tWaveOsc* const cy, tWaveTable* tables, int numTables)
 {
     _tWaveOsc* c = *cy;
     LEAF* leaf = c->mempool->leaf;
+    waveosc_releaseTables(c);
     c->tables =  tables;
     c->numTables = numTables;
     c->size = c->tables[0]->size;
@@ -2124,6 +4223,25 @@ void tWaveOsc_setSampleRate(tWaveOsc* const cy, float sr)
 //=======================================================================================
 //=======================================================================================
 
+static void wavetables_setFormat(_tWaveTableS* const c, WaveTableFormat format)
+{
+    if (format == c->format) return;
+    
+    if (c->format != WaveTableFloat)
+    {
+        c->tables = wavetable_expand(c->compactTables, c->sizes, c->sizes[0], c->numTables, c->format, c->mempool);
+        c->baseTable = c->tables[0];
+        c->compactTables = NULL;
+    }
+    if (format != WaveTableFloat)
+    {
+        c->compactTables = wavetable_compact(c->tables, c->sizes, c->sizes[0], c->numTables, format, c->mempool);
+        c->tables = NULL;
+        c->baseTable = NULL;
+    }
+    c->format = format;
+}
+
 void tWaveTableS_init(tWaveTableS* const cy, float* table, int size, float maxFreq, LEAF* const leaf)
 {
     tWaveTableS_initToPool(cy, table, size, maxFreq, &leaf->mempool);
@@ -2136,6 +4254,15 @@ void tWaveTableS_initToPool(tWaveTableS* const cy, float* table, int size, float
     c->mempool = m;
     LEAF* leaf = c->mempool->leaf;
     
+    c->refCount = 1;
+    c->shared = 0;
+    c->hash = 0;
+    c->nextShared = NULL;
+    
+    c->format = WaveTableFloat;
+    c->compactTables = NULL;
+    c->externalLevels = 0;
+    
     c->sampleRate = leaf->sampleRate;
     
     c->maxFreq = maxFreq;
@@ -2159,13 +4286,13 @@ void tWaveTableS_initToPool(tWaveTableS* const cy, float* table, int size, float
     c->sizeMasks = (int*) mpool_alloc(sizeof(int) * c->numTables, c->mempool);
     c->sizes[0] = size;
     c->sizeMasks[0] = (c->sizes[0] - 1);
-    c->baseTable = (float*) mpool_alloc(sizeof(float) * c->sizes[0], c->mempool);
+    c->baseTable = (float*) mpool_alloc_aligned(sizeof(float) * c->sizes[0], MPOOL_CACHE_LINE_SIZE, c->mempool);
     c->tables[0] = c->baseTable;
     for (int t = 1; t < c->numTables; ++t)
     {
         c->sizes[t] = c->sizes[t-1] / 2 > 128 ? c->sizes[t-1] / 2 : 128;
         c->sizeMasks[t] = (c->sizes[t] - 1);
-        c->tables[t] = (float*) mpool_alloc(sizeof(float) * c->sizes[t], c->mempool);
+        c->tables[t] = (float*) mpool_alloc_aligned(sizeof(float) * c->sizes[t], MPOOL_CACHE_LINE_SIZE, c->mempool);
     }
     
     // Copy table
@@ -2175,6 +4302,9 @@ void tWaveTableS_initToPool(tWaveTableS* const cy, float* table, int size, float
     }
     
     // Make bandlimited copies
+#if LEAF_USE_FFT_WAVETABLES
+    wavetable_bandlimit(c->baseTable, c->sizes[0], c->tables, c->sizes, c->numTables, mp);
+#else
     f = c->sampleRate * 0.25; //start at half nyquist
     // Not worth going over order 8 I think, and even 8 is only marginally better than 4.
     tButterworth_initToPool(&c->bl, 8, -1.0f, f, mp);
@@ -2210,27 +4340,233 @@ void tWaveTableS_initToPool(tWaveTableS* const cy, float* table, int size, float
     }
     tOversampler_free(&c->ds);
     tButterworth_free(&c->bl);
+#endif
 }
 
-void    tWaveTableS_free(tWaveTableS* const cy)
+void tWaveTableS_initShared(tWaveTableS* const cy, float* table, int size, float maxFreq, LEAF* const leaf)
 {
+    uint32_t hash = wavetable_hash(table, size, maxFreq);
+    
+    for (_tWaveTableS* c = leaf->waveTablesS; c != NULL; c = c->nextShared)
+    {
+        if (c->hash == hash && c->sizes[0] == size && c->maxFreq == maxFreq &&
+            c->sampleRate == leaf->sampleRate &&
+            memcmp(c->baseTable, table, sizeof(float) * size) == 0)
+        {
+            c->refCount++;
+            *cy = c;
+            return;
+        }
+    }
+    
+    tWaveTableS_initToPool(cy, table, size, maxFreq, &leaf->mempool);
     _tWaveTableS* c = *cy;
+    c->shared = 1;
+    c->hash = hash;
+    c->nextShared = leaf->waveTablesS;
+    leaf->waveTablesS = c;
+}
+
+void tWaveTableS_initCompact(tWaveTableS* const cy, float* table, int size, float maxFreq, WaveTableFormat format, LEAF* const leaf)
+{
+    tWaveTableS_initCompactToPool(cy, table, size, maxFreq, format, &leaf->mempool);
+}
+
+void tWaveTableS_initCompactToPool(tWaveTableS* const cy, float* table, int size, float maxFreq, WaveTableFormat format, tMempool* const mp)
+{
+    tWaveTableS_initToPool(cy, table, size, maxFreq, mp);
+    wavetables_setFormat(*cy, format);
+}
+
+static void wavetables_initLevels(tWaveTableS* const cy, const void* data, int size, int numTables,
+                                  WaveTableFormat format, int copy, tMempool* const mp)
+{
+    _tMempool* m = *mp;
+    _tWaveTableS* c = *cy = (_tWaveTableS*) mpool_alloc(sizeof(_tWaveTableS), m);
+    c->mempool = m;
+    LEAF* leaf = c->mempool->leaf;
     
-    mpool_free((char*)c->baseTable, c->mempool);
+    c->refCount = 1;
+    c->shared = 0;
+    c->hash = 0;
+    c->nextShared = NULL;
+    
+    c->sampleRate = leaf->sampleRate;
+    
+    // Determine base frequency
+    c->baseFreq = c->sampleRate / (float) size;
+    c->invBaseFreq = 1.0f / c->baseFreq;
+    
+    // The lowest maximum frequency that gives this many tables
+    c->numTables = numTables;
+    c->maxFreq = ldexpf(c->baseFreq, numTables - 2);
+    
+    c->sizes = (int*) mpool_alloc(sizeof(int) * c->numTables, c->mempool);
+    c->sizeMasks = (int*) mpool_alloc(sizeof(int) * c->numTables, c->mempool);
+    c->sizes[0] = size;
+    c->sizeMasks[0] = (c->sizes[0] - 1);
     for (int t = 1; t < c->numTables; ++t)
     {
-        mpool_free((char*)c->tables[t], c->mempool);
+        c->sizes[t] = c->sizes[t-1] / 2 > 128 ? c->sizes[t-1] / 2 : 128;
+        c->sizeMasks[t] = (c->sizes[t] - 1);
+    }
+    
+    c->format = format;
+    c->tables = NULL;
+    c->compactTables = NULL;
+    c->externalLevels = !copy;
+    wavetable_load(data, c->sizes, size, numTables, format, copy, &c->tables, &c->compactTables, m);
+    c->baseTable = c->tables != NULL ? c->tables[0] : NULL;
+}
+
+void tWaveTableS_initFromData(tWaveTableS* const cy, const void* data, int size, int numTables, WaveTableFormat format, LEAF* const leaf)
+{
+    tWaveTableS_initFromDataToPool(cy, data, size, numTables, format, &leaf->mempool);
+}
+
+void tWaveTableS_initFromDataToPool(tWaveTableS* const cy, const void* data, int size, int numTables, WaveTableFormat format, tMempool* const mp)
+{
+    wavetables_initLevels(cy, data, size, numTables, format, 1, mp);
+}
+
+void tWaveTableS_initFromLevels(tWaveTableS* const cy, const void* levels, int size, int numTables, WaveTableFormat format, LEAF* const leaf)
+{
+    tWaveTableS_initFromLevelsToPool(cy, levels, size, numTables, format, &leaf->mempool);
+}
+
+void tWaveTableS_initFromLevelsToPool(tWaveTableS* const cy, const void* levels, int size, int numTables, WaveTableFormat format, tMempool* const mp)
+{
+    wavetables_initLevels(cy, levels, size, numTables, format, 0, mp);
+}
+
+void tWaveTableS_initFromMemory(tWaveTableS* const cy, const void* data, size_t length, LEAF* const leaf)
+{
+    tWaveTableS_initFromMemoryToPool(cy, data, length, &leaf->mempool);
+}
+
+void tWaveTableS_initFromMemoryToPool(tWaveTableS* const cy, const void* data, size_t length, tMempool* const mp)
+{
+    const WaveTableDataHeader* header = (const WaveTableDataHeader*) data;
+    
+    if (!wavetable_checkHeader(header, length, 1))
+    {
+        LEAF_internalErrorCallback((*mp)->leaf, LEAFInvalidData);
+        wavetables_initLevels(cy, wavetable_silence, 128, 2, WaveTableFloat, 0, mp);
+        return;
+    }
+    
+    wavetables_initLevels(cy, (const char*) data + header->dataOffset, header->size, header->numTables,
+                          (WaveTableFormat) header->format, 0, mp);
+    _tWaveTableS* c = *cy;
+    c->maxFreq = header->maxFreq;
+    
+    if (header->sampleRate != c->sampleRate)
+    {
+        float sr = c->sampleRate;
+        c->sampleRate = header->sampleRate;
+        tWaveTableS_setSampleRate(cy, sr);
+    }
+}
+
+size_t tWaveTableS_writeToMemory(tWaveTableS* const cy, void* data)
+{
+    _tWaveTableS* c = *cy;
+    size_t sampleSize = c->format == WaveTableFloat ? sizeof(float) : sizeof(int16_t);
+    
+    size_t size = sizeof(WaveTableDataHeader);
+    for (int t = 0; t < c->numTables; ++t) size += sampleSize * c->sizes[t];
+    if (data == NULL) return size;
+    
+    WaveTableDataHeader* header = (WaveTableDataHeader*) data;
+    wavetable_writeHeader(header, c->format, 1, c->sizes[0], c->numTables, c->sampleRate, c->baseFreq, c->maxFreq);
+    
+    char* level = (char*) data + header->dataOffset;
+    for (int t = 0; t < c->numTables; ++t)
+    {
+        size_t levelSize = sampleSize * c->sizes[t];
+        if (c->format == WaveTableFloat) memcpy(level, c->tables[t], levelSize);
+        else memcpy(level, c->compactTables[t], levelSize);
+        level += levelSize;
+    }
+    return size;
+}
+
+void    tWaveTableS_free(tWaveTableS* const cy)
+{
+    _tWaveTableS* c = *cy;
+    
+    if (--c->refCount > 0) return;
+    
+    if (c->shared)
+    {
+        _tWaveTableS** link = &c->mempool->leaf->waveTablesS;
+        while (*link != c) link = &(*link)->nextShared;
+        *link = c->nextShared;
+    }
+    
+    if (c->externalLevels)
+    {
+        if (c->format != WaveTableFloat) mpool_free((char*)c->compactTables, c->mempool);
+        else mpool_free((char*)c->tables, c->mempool);
+    }
+    else if (c->format != WaveTableFloat)
+    {
+        for (int t = 0; t < c->numTables; ++t)
+        {
+            mpool_free((char*)c->compactTables[t], c->mempool);
+        }
+        mpool_free((char*)c->compactTables, c->mempool);
+    }
+    else
+    {
+        mpool_free((char*)c->baseTable, c->mempool);
+        for (int t = 1; t < c->numTables; ++t)
+        {
+            mpool_free((char*)c->tables[t], c->mempool);
+        }
+        mpool_free((char*)c->tables, c->mempool);
     }
-    mpool_free((char*)c->tables, c->mempool);
     mpool_free((char*)c->sizes, c->mempool);
     mpool_free((char*)c->sizeMasks, c->mempool);
     mpool_free((char*)c, c->mempool);
 }
 
+// As wavetable_detach
+static void wavetables_detach(tWaveTableS* const cy)
+{
+    _tWaveTableS* shared = *cy;
+    const void* base = shared->format == WaveTableFloat ? (const void*) shared->tables[0]
+                                                        : (const void*) shared->compactTables[0];
+    wavetables_initLevels(cy, base, shared->sizes[0], 1, shared->format, 1, &shared->mempool);
+    _tWaveTableS* c = *cy;
+    c->sampleRate = shared->sampleRate;
+    c->maxFreq = shared->maxFreq;
+    shared->refCount--;
+}
+
 void    tWaveTableS_setSampleRate(tWaveTableS* const cy, float sr)
 {
     _tWaveTableS* c = *cy;
     
+    // The other holders of a shared table keep it at the rate they got it at
+    if (c->refCount > 1)
+    {
+        if (sr == c->sampleRate) return;
+        wavetables_detach(cy);
+        c = *cy;
+    }
+    
+    if (c->externalLevels)
+    {
+        wavetable_own(c->tables, c->compactTables, c->sizes, c->sizes[0], c->numTables, c->format, c->mempool);
+        c->baseTable = c->tables != NULL ? c->tables[0] : NULL;
+        c->externalLevels = 0;
+    }
+    
+    // Compact tables are rebuilt at full precision and then converted back
+    WaveTableFormat format = c->format;
+    wavetables_setFormat(c, WaveTableFloat);
+    
     int size = c->sizes[0];
     
     for (int t = 1; t < c->numTables; ++t)
@@ -2267,10 +4603,13 @@ void    tWaveTableS_setSampleRate(tWaveTableS* const cy, float sr)
     {
         c->sizes[t] = c->sizes[t-1] / 2 > 128 ? c->sizes[t-1] / 2 : 128;
         c->sizeMasks[t] = (c->sizes[t] - 1);
-        c->tables[t] = (float*) mpool_alloc(sizeof(float) * c->sizes[t], c->mempool);
+        c->tables[t] = (float*) mpool_alloc_aligned(sizeof(float) * c->sizes[t], MPOOL_CACHE_LINE_SIZE, c->mempool);
     }
     
     // Make bandlimited copies
+#if LEAF_USE_FFT_WAVETABLES
+    wavetable_bandlimit(c->baseTable, c->sizes[0], c->tables, c->sizes, c->numTables, &c->mempool);
+#else
     f = c->sampleRate * 0.25; //start at half nyquist
     // Not worth going over order 8 I think, and even 8 is only marginally better than 4.
     tButterworth_initToPool(&c->bl, 8, -1.0f, f, &c->mempool);
@@ -2306,6 +4645,9 @@ void    tWaveTableS_setSampleRate(tWaveTableS* const cy, float sr)
     }
     tOversampler_free(&c->ds);
     tButterworth_free(&c->bl);
+#endif
+    
+    wavetables_setFormat(c, format);
 }
 
 //================================================================================================
@@ -2345,15 +4687,91 @@ void tWaveOscS_initToPool(tWaveOscS* const cy, tWaveTableS* tables, int numTable
 
     c->invSampleRateTimesTwoTo32 = leaf->invSampleRate * TWO_TO_32;
     c->maxFreq = c->tables[0]->maxFreq;
+    c->ownsTables = 0;
+}
+
+void tWaveOscS_initShared(tWaveOscS* const cy, float** tables, int numTables, int size, float maxFreq, LEAF* const leaf)
+{
+    tWaveTableS* shared = (tWaveTableS*) mpool_alloc(sizeof(tWaveTableS) * numTables, leaf->mempool);
+    for (int t = 0; t < numTables; ++t)
+    {
+        tWaveTableS_initShared(&shared[t], tables[t], size, maxFreq, leaf);
+    }
+    
+    tWaveOscS_initToPool(cy, shared, numTables, &leaf->mempool);
+    (*cy)->ownsTables = 1;
 }
 
 void tWaveOscS_free(tWaveOscS* const cy)
 {
     _tWaveOscS* c = *cy;
     
+    if (c->ownsTables)
+    {
+        for (int t = 0; t < c->numTables; ++t)
+        {
+            tWaveTableS_free(&c->tables[t]);
+        }
+        mpool_free((char*)c->tables, c->mempool);
+    }
     mpool_free((char*)c, c->mempool);
 }
 
+// As waveosc_lookup, for tWaveTableS levels that may each have their own size
+static inline float waveoscs_lookup(const float* const table, int size, int sizeMask, float floatPhase)
+{
+    float temp = size * floatPhase;
+    int idx = (int)temp;
+    float frac = temp - (float)idx;
+    int idx2 = (idx + 1) & sizeMask;
+    
+    return (table[idx] + (table[idx2] - table[idx]) * frac);
+}
+
+static inline float waveoscs_lookupInt16(const int16_t* const table, int size, int sizeMask, float floatPhase)
+{
+    float temp = size * floatPhase;
+    int idx = (int)temp;
+    float frac = temp - (float)idx;
+    int idx2 = (idx + 1) & sizeMask;
+    
+    return ((float)table[idx] + (float)(table[idx2] - table[idx]) * frac) * (1.0f / WAVETABLE_INT16_ONE);
+}
+
+static inline float waveoscs_lookupHalf(const int16_t* const table, int size, int sizeMask, float floatPhase)
+{
+    float temp = size * floatPhase;
+    int idx = (int)temp;
+    float frac = temp - (float)idx;
+    int idx2 = (idx + 1) & sizeMask;
+    
+    float samp0 = wavetable_fromHalf((uint16_t) table[idx]);
+    float samp1 = wavetable_fromHalf((uint16_t) table[idx2]);
+    return (samp0 + (samp1 - samp0) * frac);
+}
+
+// As waveosc_level, reading two adjacent levels of one table and fading between them
+static inline float waveoscs_level(const _tWaveTableS* const t, int oct, float floatPhase, float w)
+{
+    float oct0, oct1;
+    if (t->format == WaveTableInt16)
+    {
+        oct0 = waveoscs_lookupInt16(t->compactTables[oct], t->sizes[oct], t->sizeMasks[oct], floatPhase);
+        oct1 = waveoscs_lookupInt16(t->compactTables[oct+1], t->sizes[oct+1], t->sizeMasks[oct+1], floatPhase);
+    }
+    else if (t->format == WaveTableHalf)
+    {
+        oct0 = waveoscs_lookupHalf(t->compactTables[oct], t->sizes[oct], t->sizeMasks[oct], floatPhase);
+        oct1 = waveoscs_lookupHalf(t->compactTables[oct+1], t->sizes[oct+1], t->sizeMasks[oct+1], floatPhase);
+    }
+    else
+    {
+        oct0 = waveoscs_lookup(t->tables[oct], t->sizes[oct], t->sizeMasks[oct], floatPhase);
+        oct1 = waveoscs_lookup(t->tables[oct+1], t->sizes[oct+1], t->sizeMasks[oct+1], floatPhase);
+    }
+    return oct0 + (oct1 - oct0) * w;
+}
+
 volatile int errorCounter = 0;
 float tWaveOscS_tick(tWaveOscS* const cy)
 {
@@ -2362,70 +4780,91 @@ float tWaveOscS_tick(tWaveOscS* const cy)
     // Phasor increment (unsigned 32bit int wraps automatically with overflow so no need for if branch checks, as you need with float)
     c->phase += c->inc;
     float floatPhase = (double)c->phase * 2.32830643654e-10;
-    float s1 = 0.f, s2 = 0.f;
-
-    float temp;
-    int idx;
-    float frac;
-    float samp0;
-    float samp1;
-
-    int oct = c->oct;
     
-    float** tables = c->tables[c->o1]->tables;
-    int* sizes = c->tables[c->o1]->sizes;
-    int* sizeMasks = c->tables[c->o1]->sizeMasks;
-
-    // Wavetable synthesis
-    temp = sizes[oct] * floatPhase;
-    idx = (int)temp;
-    frac = temp - (float)idx;
-    samp0 = tables[oct][idx];
-    idx = (idx + 1) & sizeMasks[oct];
-    samp1 = tables[oct][idx];
-
-    float oct0 = (samp0 + (samp1 - samp0) * frac);
-
-    temp = sizes[oct+1] * floatPhase;
-    idx = (int)temp;
-    frac = temp - (float)idx;
-    samp0 = tables[oct+1][idx];
-    idx = (idx + 1) & sizeMasks[oct+1];
-    samp1 = tables[oct+1][idx];
-
-    float oct1 = (samp0 + (samp1 - samp0) * frac);
-
-    s1 = oct0 + (oct1 - oct0) * c->w;
-
-    tables = c->tables[c->o2]->tables;
-    sizes = c->tables[c->o2]->sizes;
-    sizeMasks = c->tables[c->o2]->sizeMasks;
-
     // Wavetable synthesis
-    temp = sizes[oct] * floatPhase;
-    idx = (int)temp;
-    frac = temp - (float)idx;
-    samp0 = tables[oct][idx];
-    idx = (idx + 1) & sizeMasks[oct];
-    samp1 = tables[oct][idx];
-
-    oct0 = (samp0 + (samp1 - samp0) * frac);
-
-    temp = sizes[oct+1] * floatPhase;
-    idx = (int)temp;
-    frac = temp - (float)idx;
-    samp0 = tables[oct+1][idx];
-    idx = (idx + 1) & sizeMasks[oct+1];
-    samp1 = tables[oct+1][idx];
-
-    oct1 = (samp0 + (samp1 - samp0) * frac);
-
-    s2 = oct0 + (oct1 - oct0) * c->w;
+    float s1 = waveoscs_level(c->tables[c->o1], c->oct, floatPhase, c->w);
+    float s2 = waveoscs_level(c->tables[c->o2], c->oct, floatPhase, c->w);
 
     // Ideally should determine correlation to get a good equal power fade between tables
     return s1 + (s2 - s1) * c->mix;
 }
 
+static inline void waveoscs_render(_tWaveOscS* c, float* const out, int size)
+{
+    uint32_t phase = c->phase;
+    uint32_t inc = c->inc;
+    float w = c->w;
+    float mix = c->mix;
+    int oct = c->oct;
+    
+    _tWaveTableS* t1 = c->tables[c->o1];
+    _tWaveTableS* t2 = c->tables[c->o2];
+    
+    if (t1->format != WaveTableFloat || t2->format != WaveTableFloat)
+    {
+        for (int i = 0; i < size; ++i)
+        {
+            phase += inc;
+            float floatPhase = (double)phase * 2.32830643654e-10;
+            float s1 = waveoscs_level(t1, oct, floatPhase, w);
+            float s2 = waveoscs_level(t2, oct, floatPhase, w);
+            out[i] = s1 + (s2 - s1) * mix;
+        }
+        c->phase = phase;
+        return;
+    }
+    
+    const float* table10 = t1->tables[oct];
+    const float* table11 = t1->tables[oct+1];
+    const float* table20 = t2->tables[oct];
+    const float* table21 = t2->tables[oct+1];
+    int size10 = t1->sizes[oct], sizeMask10 = t1->sizeMasks[oct];
+    int size11 = t1->sizes[oct+1], sizeMask11 = t1->sizeMasks[oct+1];
+    int size20 = t2->sizes[oct], sizeMask20 = t2->sizeMasks[oct];
+    int size21 = t2->sizes[oct+1], sizeMask21 = t2->sizeMasks[oct+1];
+    
+    for (int i = 0; i < size; ++i)
+    {
+        phase += inc;
+        float floatPhase = (double)phase * 2.32830643654e-10;
+        
+        float oct0 = waveoscs_lookup(table10, size10, sizeMask10, floatPhase);
+        float oct1 = waveoscs_lookup(table11, size11, sizeMask11, floatPhase);
+        float s1 = oct0 + (oct1 - oct0) * w;
+        
+        oct0 = waveoscs_lookup(table20, size20, sizeMask20, floatPhase);
+        oct1 = waveoscs_lookup(table21, size21, sizeMask21, floatPhase);
+        float s2 = oct0 + (oct1 - oct0) * w;
+        
+        out[i] = s1 + (s2 - s1) * mix;
+    }
+    
+    c->phase = phase;
+}
+
+void tWaveOscS_tickBlock(tWaveOscS* const cy, float* const out, const float* const freq, const float* const index, int size)
+{
+    _tWaveOscS* c = *cy;
+    
+    if (freq == NULL && index == NULL)
+    {
+        waveoscs_render(c, out, size);
+        return;
+    }
+    
+    for (int i = 0, end; i < size; i = end)
+    {
+        if (freq != NULL) tWaveOscS_setFreq(cy, freq[i]);
+        if (index != NULL) tWaveOscS_setIndex(cy, index[i]);
+        
+        end = i + 1;
+        while (end < size && (freq == NULL || freq[end] == freq[i]) &&
+               (index == NULL || index[end] == index[i])) end++;
+        
+        waveoscs_render(c, out + i, end - i);
+    }
+}
+
 void tWaveOscS_setFreq(tWaveOscS* const cy, float freq)
 {
     _tWaveOscS* c = *cy;
@@ -36,7 +36,7 @@ void  tBuffer_initToPool (tBuffer* const sb, uint32_t length, tMempool* const mp
     s->mempool = m;
     LEAF* leaf = s->mempool->leaf;
     
-    s->buff = (float*) mpool_alloc( sizeof(float) * length, m);
+    s->buff = (float*) mpool_alloc_aligned(sizeof(float) * length, MPOOL_CACHE_LINE_SIZE, m);
     s->sampleRate = leaf->sampleRate;
     s->channels = 1;
     s->bufferLength = length;
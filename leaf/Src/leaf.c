@@ -21,6 +21,10 @@
 void LEAF_init(LEAF* const leaf, float sr, char* memory, size_t memorysize, float(*random)(void))
 {
     leaf->_internal_mempool.leaf = leaf;
+    leaf->deferredFrees = NULL;
+    leaf->concurrentMempools = 0;
+    leaf->waveTables = NULL;
+    leaf->waveTablesS = NULL;
     leaf_pool_init(leaf, memory, memorysize);
     
     leaf->sampleRate = sr;
@@ -71,3 +75,13 @@ void LEAF_setErrorCallback(LEAF* const leaf, void (*callback)(LEAF* const, LEAFE
 {
     leaf->errorCallback = callback;
 }
+
+void LEAF_enableDeferredFree(LEAF* const leaf, int capacity)
+{
+    leaf_enable_deferred_free(leaf, capacity);
+}
+
+int LEAF_collect(LEAF* const leaf)
+{
+    return leaf_collect(leaf);
+}
@@ -54,10 +54,22 @@
 //! Include tables for minblep insertion, required for all tMB objects.
 #define LEAF_INCLUDE_MINBLEP_TABLES 1
 
+//! Build the band-limited copies in tWaveTable and tWaveTableS from an FFT of the table instead of with repeated Butterworth filter passes. Much faster, and the copies come out exactly periodic and in phase with the original. Table sizes must be powers of two.
+#define LEAF_USE_FFT_WAVETABLES 1
+
 #define LEAF_NO_DENORMAL_CHECK 0
 
 #define LEAF_USE_CMSIS 0
 
+//! Record the address of the code that made each mempool allocation in its block header, for use with tMempool_dump(). Adds a pointer to every block header.
+#define LEAF_MEMPOOL_TRACK_CALLERS 0
+
+//! Let tMempool_compact() move objects whose handles were registered with tMempool_registerHandle(). Adds the handle and the alignment of the allocation to every block header, so leave disabled unless the mempool is compacted.
+#define LEAF_MEMPOOL_COMPACTION 0
+
+//! Provide tMempool_initMapped() for creating mempools over memory mapped from the operating system, which can be locked in memory, backed by huge pages, and grow when they run out. Needs mmap(), so leave disabled on embedded targets.
+#define LEAF_USE_MMAP 0
+
 #ifdef __cplusplus
 //! Use stdlib malloc() and free() internally instead of LEAF's normal mempool behavior for when you want to avoid being limited to and managing mempool a fixed mempool size. Usage of all object remains essentially the same.
 
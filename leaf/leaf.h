@@ -175,6 +175,20 @@ extern "C" {
      */
     void LEAF_setErrorCallback(LEAF* const leaf, void (*callback)(LEAF* const, LEAFErrorType));
     
+    //! Defer frees of LEAF objects until LEAF_collect() is called.
+    /*!
+     Once enabled, freeing a LEAF object only records its memory in a queue, which takes constant time and never touches the mempool, so objects can be freed on the audio thread. The memory is given back by LEAF_collect(). Frees that don't fit in the queue are carried out immediately. Any number of threads may free LEAF objects while frees are deferred. Frees to MempoolArena mempools and thread caches are never deferred. Freeing or resetting a mempool carries out every free still waiting first, so none of them are left pointing into it.
+     @param capacity The number of frees the queue can hold. Rounded up to a power of two.
+     */
+    void LEAF_enableDeferredFree(LEAF* const leaf, int capacity);
+    
+    //! Carry out frees deferred since the last call.
+    /*!
+     Frees are sorted by address first so neighbouring blocks are coalesced together. Can be called on the audio thread when there is time to spare, or on another thread if every mempool involved has been made concurrent with tMempool_setConcurrent(). Returns right away if another thread is already collecting.
+     @return The number of frees carried out.
+     */
+    int LEAF_collect(LEAF* const leaf);
+    
     /*! @} */
     
 #ifdef __cplusplus